@@ -0,0 +1,643 @@
+/**
+ * @file BulkImporter.cpp
+ * @brief Implements the BulkImporter class.
+ */
+
+#include "BulkImporter.h"
+#include "RoundSummaries.h"
+#include "SchemaMigrator.h"
+#include "TournamentSnapshot.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QProgressDialog>
+#include <QMessageBox>
+#include <QIODevice>
+#include <QByteArrayView>
+#include <QList>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+#include <climits>
+
+namespace {
+
+/**
+ * @class CsvReader
+ * @brief Reads RFC 4180 records from a device one at a time.
+ *
+ * Quoted fields may contain commas, doubled quotes and line breaks. Fields are
+ * returned as UTF-8 bytes so numeric columns never go through QString.
+ */
+class CsvReader
+{
+public:
+    explicit CsvReader(QIODevice *device) : m_device(device) {}
+
+    /**
+     * @brief Reads the next non-empty record.
+     * @param fields Receives the fields of the record.
+     * @return False at the end of the device.
+     */
+    bool readRecord(QList<QByteArray> &fields)
+    {
+        fields.clear();
+        do {
+            if (!readLine()) {
+                return false;
+            }
+            m_recordLine = m_lineNumber;
+        } while (m_line.isEmpty());
+
+        QByteArray field;
+        bool inQuotes = false;
+        qsizetype i = 0;
+        while (true) {
+            if (i == m_line.size()) {
+                if (!inQuotes) {
+                    break;
+                }
+                // A line break inside a quoted field: the record continues on the next line.
+                field += '\n';
+                if (!readLine()) {
+                    break;
+                }
+                i = 0;
+                continue;
+            }
+
+            const char c = m_line.at(i++);
+            if (inQuotes) {
+                if (c != '"') {
+                    field += c;
+                } else if (i < m_line.size() && m_line.at(i) == '"') {
+                    field += '"';
+                    ++i;
+                } else {
+                    inQuotes = false;
+                }
+            } else if (c == ',') {
+                fields.append(field);
+                field.clear();
+            } else if (c == '"') {
+                inQuotes = true;
+            } else {
+                field += c;
+            }
+        }
+        fields.append(field);
+        return true;
+    }
+
+    /**
+     * @brief Gets the line number on which the last record started.
+     */
+    qint64 recordLine() const { return m_recordLine; }
+
+private:
+    bool readLine()
+    {
+        if (m_device->atEnd()) {
+            return false;
+        }
+        m_line = m_device->readLine();
+        ++m_lineNumber;
+        if (m_lineNumber == 1 && m_line.startsWith("\xEF\xBB\xBF")) {
+            m_line.remove(0, 3);
+        }
+        while (m_line.endsWith('\n') || m_line.endsWith('\r')) {
+            m_line.chop(1);
+        }
+        return true;
+    }
+
+    QIODevice *m_device;
+    QByteArray m_line;
+    qint64 m_lineNumber = 0;
+    qint64 m_recordLine = 0;
+};
+
+/**
+ * @brief Finds a column by any of its names.
+ * @return The index of the column, or -1 if there is none.
+ */
+int findColumn(const QStringList &header, std::initializer_list<const char *> names)
+{
+    for (const char *name : names) {
+        const int index = header.indexOf(QLatin1String(name), 0, Qt::CaseInsensitive);
+        if (index != -1) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+// The names accepted for each column. The first name is the database column;
+// the others are the headers the export functions write.
+constexpr std::initializer_list<const char *> playerNameColumn = { "name", "player name", "player" };
+constexpr std::initializer_list<const char *> courseNameColumn = { "course name", "course", "name" };
+
+/**
+ * @brief Parses a whole number, ignoring surrounding spaces.
+ */
+bool parseInt(const QByteArray &field, int minimum, int maximum, int *value)
+{
+    bool ok = false;
+    *value = QByteArrayView(field).trimmed().toInt(&ok);
+    return ok && *value >= minimum && *value <= maximum;
+}
+
+/**
+ * @brief Parses an Active flag: 1/0, true/false or yes/no. An empty field is active.
+ */
+bool parseFlag(const QByteArray &field, bool *value)
+{
+    const QByteArray flag = field.trimmed().toLower();
+    if (flag.isEmpty() || flag == "1" || flag == "true" || flag == "yes") {
+        *value = true;
+        return true;
+    }
+    if (flag == "0" || flag == "false" || flag == "no") {
+        *value = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @class RowWriter
+ * @brief Validates the rows of one format and writes them with a single prepared statement.
+ */
+class RowWriter
+{
+public:
+    RowWriter(BulkImporter::Format format, const QStringList &header, const QSqlDatabase &db)
+        : m_format(format), m_query(db)
+    {
+        switch (format) {
+        case BulkImporter::Format::Players:
+            m_columns = { findColumn(header, playerNameColumn), findColumn(header, { "handicap" }), findColumn(header, { "active" }) };
+            break;
+        case BulkImporter::Format::Courses:
+            m_columns = { findColumn(header, { "id", "course_id" }), findColumn(header, courseNameColumn) };
+            break;
+        case BulkImporter::Format::Holes:
+            m_columns = { findColumn(header, { "course_id" }), findColumn(header, { "hole_num" }),
+                          findColumn(header, { "par" }), findColumn(header, { "handicap" }) };
+            break;
+        case BulkImporter::Format::Scores:
+            m_columns = { findColumn(header, { "player_id" }), findColumn(header, { "course_id" }),
+                          findColumn(header, { "day_num" }), findColumn(header, { "hole_num" }), findColumn(header, { "score" }) };
+            break;
+        case BulkImporter::Format::Unknown:
+            break;
+        }
+        for (int column : m_columns) {
+            m_fieldCount = qMax(m_fieldCount, column + 1);
+        }
+    }
+
+    /**
+     * @brief Prepares the statement and loads the ids that rows may refer to.
+     * @param db The connection the statement was created for.
+     * @param error Receives the reason on failure.
+     */
+    bool prepare(const QSqlDatabase &db, QString *error)
+    {
+        QSqlQuery lookup(db);
+        lookup.setForwardOnly(true);
+        const auto loadIds = [&](const char *sql, QSet<int> &ids) {
+            if (!lookup.exec(QLatin1String(sql))) {
+                return false;
+            }
+            while (lookup.next()) {
+                ids.insert(lookup.value(0).toInt());
+            }
+            lookup.finish();
+            return true;
+        };
+
+        bool loaded = true;
+        const char *sql = nullptr;
+        switch (m_format) {
+        case BulkImporter::Format::Players:
+            // An upsert keeps the player's id, which INSERT OR REPLACE would change.
+            sql = "INSERT INTO players (name, handicap, active) VALUES (?, ?, ?) "
+                  "ON CONFLICT (name) DO UPDATE SET handicap = excluded.handicap, active = excluded.active";
+            break;
+        case BulkImporter::Format::Courses:
+            // Keeping the ids lets the holes file of the same export refer to them.
+            sql = "INSERT INTO courses (id, name) VALUES (?, ?) "
+                  "ON CONFLICT (id) DO UPDATE SET name = excluded.name "
+                  "ON CONFLICT (name) DO NOTHING";
+            break;
+        case BulkImporter::Format::Holes:
+            // Skipping unchanged holes avoids recalculating every round on the course.
+            sql = "INSERT INTO holes (course_id, hole_num, par, handicap) VALUES (?, ?, ?, ?) "
+                  "ON CONFLICT (course_id, hole_num) DO UPDATE SET par = excluded.par, handicap = excluded.handicap "
+                  "WHERE par <> excluded.par OR handicap <> excluded.handicap";
+            loaded = loadIds("SELECT id FROM courses", m_courseIds);
+            break;
+        case BulkImporter::Format::Scores:
+            sql = "INSERT OR REPLACE INTO scores (event_id, player_id, course_id, hole_num, day_num, score) "
+                  "VALUES ((SELECT id FROM current_event), ?, ?, ?, ?, ?)";
+            loaded = loadIds("SELECT id FROM players", m_playerIds) && loadIds("SELECT id FROM courses", m_courseIds);
+            if (loaded && lookup.exec("SELECT id FROM current_event")) {
+                const bool hasEvent = lookup.next();
+                lookup.finish();
+                if (!hasEvent) {
+                    *error = QObject::tr("There is no current event.");
+                    return false;
+                }
+            } else {
+                loaded = false;
+            }
+            break;
+        case BulkImporter::Format::Unknown:
+            return false;
+        }
+
+        if (!loaded) {
+            *error = lookup.lastError().text();
+            return false;
+        }
+        if (!m_query.prepare(QLatin1String(sql))) {
+            *error = m_query.lastError().text();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Validates a row and writes it.
+     * @param fields The fields of the row.
+     * @param error Receives the reason the row was rejected.
+     * @return True if the row was written.
+     */
+    bool write(const QList<QByteArray> &fields, QString *error)
+    {
+        if (fields.size() < m_fieldCount) {
+            *error = QObject::tr("expected %1 fields, found %2").arg(m_fieldCount).arg(fields.size());
+            return false;
+        }
+        const auto field = [&](int column) -> const QByteArray & { return fields.at(m_columns.at(column)); };
+
+        switch (m_format) {
+        case BulkImporter::Format::Players: {
+            const QString name = QString::fromUtf8(field(0)).trimmed();
+            int handicap = 0;
+            bool active = true;
+            if (name.isEmpty()) {
+                *error = QObject::tr("the name is empty");
+                return false;
+            }
+            if (!parseInt(field(1), 0, 72, &handicap)) {
+                *error = QObject::tr("the handicap must be a whole number from 0 to 72");
+                return false;
+            }
+            if (m_columns.at(2) != -1 && !parseFlag(field(2), &active)) {
+                *error = QObject::tr("Active must be 1 or 0");
+                return false;
+            }
+            m_query.bindValue(0, name);
+            m_query.bindValue(1, handicap);
+            m_query.bindValue(2, active ? 1 : 0);
+            break;
+        }
+        case BulkImporter::Format::Courses: {
+            const QString name = QString::fromUtf8(field(1)).trimmed();
+            int id = 0;
+            const bool hasId = m_columns.at(0) != -1 && !field(0).trimmed().isEmpty();
+            if (name.isEmpty()) {
+                *error = QObject::tr("the course name is empty");
+                return false;
+            }
+            if (hasId && !parseInt(field(0), 1, INT_MAX, &id)) {
+                *error = QObject::tr("the id must be a positive whole number");
+                return false;
+            }
+            m_query.bindValue(0, hasId ? QVariant(id) : QVariant(QMetaType(QMetaType::Int)));
+            m_query.bindValue(1, name);
+            if (!exec(error)) {
+                return false;
+            }
+            // Without an id an existing name is already imported; with one it belongs to another course.
+            if (hasId && m_query.numRowsAffected() == 0) {
+                *error = QObject::tr("another course is already named %1").arg(name);
+                return false;
+            }
+            return true;
+        }
+        case BulkImporter::Format::Holes: {
+            int courseId = 0, holeNum = 0, par = 0, handicap = 0;
+            if (!parseInt(field(0), 1, INT_MAX, &courseId) || !m_courseIds.contains(courseId)) {
+                *error = QObject::tr("course %1 does not exist").arg(QString::fromUtf8(field(0)));
+                return false;
+            }
+            if (!parseInt(field(1), 1, 18, &holeNum) || !parseInt(field(2), 1, 9, &par) || !parseInt(field(3), 1, 18, &handicap)) {
+                *error = QObject::tr("the hole number and handicap must be 1 to 18 and the par 1 to 9");
+                return false;
+            }
+            m_query.bindValue(0, courseId);
+            m_query.bindValue(1, holeNum);
+            m_query.bindValue(2, par);
+            m_query.bindValue(3, handicap);
+            break;
+        }
+        case BulkImporter::Format::Scores: {
+            int playerId = 0, courseId = 0, dayNum = 0, holeNum = 0, score = 0;
+            if (!parseInt(field(0), 1, INT_MAX, &playerId) || !m_playerIds.contains(playerId)) {
+                *error = QObject::tr("player %1 does not exist").arg(QString::fromUtf8(field(0)));
+                return false;
+            }
+            if (!parseInt(field(1), 1, INT_MAX, &courseId) || !m_courseIds.contains(courseId)) {
+                *error = QObject::tr("course %1 does not exist").arg(QString::fromUtf8(field(1)));
+                return false;
+            }
+            if (!parseInt(field(2), 1, TournamentSnapshot::MaxDays, &dayNum)) {
+                *error = QObject::tr("the day must be 1 to %1").arg(TournamentSnapshot::MaxDays);
+                return false;
+            }
+            if (!parseInt(field(3), 1, 18, &holeNum) || !parseInt(field(4), 1, 99, &score)) {
+                *error = QObject::tr("the hole number must be 1 to 18 and the score 1 to 99");
+                return false;
+            }
+            m_query.bindValue(0, playerId);
+            m_query.bindValue(1, courseId);
+            m_query.bindValue(2, holeNum);
+            m_query.bindValue(3, dayNum);
+            m_query.bindValue(4, score);
+            break;
+        }
+        case BulkImporter::Format::Unknown:
+            return false;
+        }
+        return exec(error);
+    }
+
+    /**
+     * @brief Releases the statement before the transaction ends.
+     */
+    void finish() { m_query.finish(); }
+
+private:
+    bool exec(QString *error)
+    {
+        if (!m_query.exec()) {
+            *error = m_query.lastError().databaseText();
+            return false;
+        }
+        return true;
+    }
+
+    BulkImporter::Format m_format;
+    QSqlQuery m_query;
+    QList<int> m_columns;   ///< The field index of each value, in statement order; -1 if optional and missing.
+    int m_fieldCount = 0;   ///< The fields a row needs to hold every column.
+    QSet<int> m_playerIds;
+    QSet<int> m_courseIds;
+};
+
+/**
+ * @brief Suspends the per-row triggers on scores inside the current transaction.
+ *
+ * Both the round summary and the change counter triggers run a statement for
+ * every inserted score, which would make a bulk load about four times slower.
+ */
+bool suspendScoreTriggers(QSqlDatabase &db, qint64 *lastScoreId)
+{
+    QSqlQuery query(db);
+    if (!RoundSummaries::beginBulkLoad(db, lastScoreId) ||
+        !query.exec("DROP TRIGGER IF EXISTS trg_scores_insert_changed")) {
+        qWarning() << "BulkImporter: Could not suspend the score triggers:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Brings the summaries and change counter up to date and restores the triggers.
+ */
+bool restoreScoreTriggers(QSqlDatabase &db, qint64 lastScoreId)
+{
+    QSqlQuery query(db);
+    if (!RoundSummaries::finishBulkLoad(db, lastScoreId) ||
+        !query.exec("UPDATE change_counters SET counter = counter + 1 WHERE table_name = 'scores'") ||
+        !query.exec(SchemaMigrator::changeCounterTrigger("scores", "INSERT", "scores"))) {
+        qWarning() << "BulkImporter: Could not restore the score triggers:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+BulkImporter::BulkImporter(const QString &connectionName, QObject *parent)
+    : QObject(parent)
+    , m_connectionName(connectionName)
+    , m_chunkSize(DefaultChunkSize)
+    , m_canceled(false)
+{
+}
+
+void BulkImporter::setChunkSize(int rows)
+{
+    if (rows >= 1) {
+        m_chunkSize = rows;
+    }
+}
+
+void BulkImporter::cancel()
+{
+    m_canceled = true;
+}
+
+BulkImporter::Format BulkImporter::detectFormat(const QStringList &header)
+{
+    const auto has = [&](std::initializer_list<const char *> names) { return findColumn(header, names) != -1; };
+
+    if (has({ "player_id" }) && has({ "course_id" }) && has({ "day_num" }) && has({ "hole_num" }) && has({ "score" })) {
+        return Format::Scores;
+    }
+    if (has({ "course_id" }) && has({ "hole_num" }) && has({ "par" }) && has({ "handicap" })) {
+        return Format::Holes;
+    }
+    if (has(playerNameColumn) && has({ "handicap" })) {
+        return Format::Players;
+    }
+    if (has(courseNameColumn)) {
+        return Format::Courses;
+    }
+    return Format::Unknown;
+}
+
+QString BulkImporter::formatName(Format format)
+{
+    switch (format) {
+    case Format::Players: return tr("players");
+    case Format::Courses: return tr("courses");
+    case Format::Holes:   return tr("holes");
+    case Format::Scores:  return tr("scores");
+    case Format::Unknown: break;
+    }
+    return tr("unknown");
+}
+
+BulkImporter::Format BulkImporter::detectFileFormat(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Format::Unknown;
+    }
+    CsvReader reader(&file);
+    QList<QByteArray> fields;
+    QStringList header;
+    if (reader.readRecord(fields)) {
+        for (const QByteArray &field : std::as_const(fields)) {
+            header << QString::fromUtf8(field).trimmed();
+        }
+    }
+    return detectFormat(header);
+}
+
+QString BulkImporter::summary(const Result &result)
+{
+    QString text = tr("Imported %n %1 row(s).", nullptr, result.imported).arg(formatName(result.format));
+    if (result.rejected > 0) {
+        text += "\n" + tr("Skipped %n invalid row(s):", nullptr, result.rejected) + "\n" + result.errors.mid(0, 10).join("\n");
+        if (result.rejected > 10) {
+            text += "\n...";
+        }
+    }
+    if (result.canceled) {
+        text += "\n" + tr("The import was canceled; the rows imported before that were kept.");
+    }
+    if (!result.error.isEmpty()) {
+        text += "\n" + tr("The import stopped: %1").arg(result.error);
+    }
+    return text;
+}
+
+BulkImporter::Result BulkImporter::importWithProgress(const QString &connectionName, const QString &filePath, QWidget *parent)
+{
+    const QString fileName = QFileInfo(filePath).fileName();
+    // Progress is reported in KiB so files over 2 GiB still fit the dialog's int range.
+    QProgressDialog progressDialog(tr("Importing %1...").arg(fileName), tr("Cancel"), 0, int(QFileInfo(filePath).size() / 1024), parent);
+    progressDialog.setWindowModality(Qt::WindowModal);
+    progressDialog.setMinimumDuration(500);
+
+    BulkImporter importer(connectionName);
+    connect(&importer, &BulkImporter::progress, &progressDialog, [&](qint64 bytesRead) {
+        progressDialog.setValue(int(bytesRead / 1024));
+        if (progressDialog.wasCanceled()) {
+            importer.cancel();
+        }
+    });
+    const Result result = importer.importFile(filePath);
+    progressDialog.reset();
+
+    if (result.isComplete() && result.rejected == 0) {
+        QMessageBox::information(parent, tr("Import Successful"), summary(result));
+    } else {
+        QMessageBox::warning(parent, tr("Import"), QDir::toNativeSeparators(filePath) + "\n\n" + summary(result));
+    }
+    return result;
+}
+
+BulkImporter::Result BulkImporter::importFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        Result result;
+        result.error = tr("Could not open %1: %2").arg(filePath, file.errorString());
+        return result;
+    }
+    return importCsv(&file);
+}
+
+BulkImporter::Result BulkImporter::importCsv(QIODevice *device)
+{
+    Result result;
+    m_canceled = false;
+
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    if (!db.isOpen()) {
+        result.error = tr("The database is not open.");
+        return result;
+    }
+
+    CsvReader reader(device);
+    QList<QByteArray> fields;
+    if (!reader.readRecord(fields)) {
+        result.error = tr("The file is empty.");
+        return result;
+    }
+    QStringList header;
+    for (const QByteArray &field : std::as_const(fields)) {
+        header << QString::fromUtf8(field).trimmed();
+    }
+    result.format = detectFormat(header);
+    if (result.format == Format::Unknown) {
+        result.error = tr("The columns %1 do not match a players, courses, holes or scores file.").arg(header.join(", "));
+        return result;
+    }
+
+    RowWriter writer(result.format, header, db);
+    if (!writer.prepare(db, &result.error)) {
+        qWarning() << "BulkImporter::importCsv: Could not prepare the" << formatName(result.format) << "import:" << result.error;
+        return result;
+    }
+
+    const qint64 totalBytes = device->isSequential() ? 0 : device->size();
+    const bool isScores = result.format == Format::Scores;
+    bool more = true;
+    while (more && !m_canceled) {
+        if (!db.transaction()) {
+            result.error = db.lastError().text();
+            break;
+        }
+        qint64 lastScoreId = 0;
+        if (isScores && !suspendScoreTriggers(db, &lastScoreId)) {
+            db.rollback();
+            result.error = tr("Could not prepare the scores table for the import.");
+            break;
+        }
+
+        int imported = 0;
+        int rejected = 0;
+        for (int rows = 0; rows < m_chunkSize && (more = reader.readRecord(fields)); ++rows) {
+            QString rowError;
+            if (writer.write(fields, &rowError)) {
+                ++imported;
+            } else {
+                ++rejected;
+                if (result.errors.size() < MaxReportedErrors) {
+                    result.errors << tr("Line %1: %2").arg(reader.recordLine()).arg(rowError);
+                }
+            }
+        }
+        writer.finish();
+
+        if (isScores && !restoreScoreTriggers(db, lastScoreId)) {
+            db.rollback();
+            result.error = tr("Could not update the round summaries.");
+            break;
+        }
+        if (!db.commit()) {
+            result.error = db.lastError().text();
+            db.rollback();
+            break;
+        }
+        result.imported += imported;
+        result.rejected += rejected;
+        emit progress(device->pos(), totalBytes);
+    }
+
+    result.canceled = m_canceled && more;
+    qDebug() << "BulkImporter::importCsv:" << formatName(result.format) << "imported:" << result.imported
+             << "rejected:" << result.rejected << (result.canceled ? "(canceled)" : "") << result.error;
+    return result;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file BulkImporter.h
+ * @brief Contains the declaration of the BulkImporter class.
+ */
+
+#ifndef BULKIMPORTER_H
+#define BULKIMPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QIODevice;
+class QWidget;
+
+/**
+ * @class BulkImporter
+ * @brief Imports players, courses, holes and scores from CSV files.
+ *
+ * The file is read one record at a time, so its size is not limited by memory.
+ * The kind of data is detected from the header row:
+ *
+ * - Players: Name, Handicap and optionally Active, as written by PlayerDialog::exportToCsv().
+ * - Courses: Course Name and optionally id, as written by CoursesDialog::exportData().
+ * - Holes: course_id, hole_num, par and handicap, as written by CoursesDialog::exportData().
+ * - Scores: player_id, course_id, day_num, hole_num and score, for the current event.
+ *
+ * Header names are matched without regard to case and column order. Every row
+ * is validated before it is written; a row that is invalid or rejected by the
+ * database is skipped and reported, and the import continues. Rows are upserted
+ * through one prepared statement and committed in chunks.
+ */
+class BulkImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultChunkSize = 10000; ///< Rows per transaction.
+    static constexpr int MaxReportedErrors = 100;  ///< Rejected rows listed in a Result.
+
+    /**
+     * @enum Format
+     * @brief The kind of data in a CSV file.
+     */
+    enum class Format {
+        Unknown,    ///< The header did not match any format.
+        Players,    ///< Upserted into players by name.
+        Courses,    ///< Upserted into courses by id, or added by name if there is no id.
+        Holes,      ///< Upserted into holes by course and hole number.
+        Scores      ///< Upserted into scores of the current event.
+    };
+
+    /**
+     * @struct Result
+     * @brief The outcome of an import.
+     */
+    struct Result {
+        Format format = Format::Unknown; ///< The detected format.
+        int imported = 0;                ///< Rows written to the database.
+        int rejected = 0;                ///< Rows skipped because they were invalid or failed.
+        QStringList errors;              ///< The first MaxReportedErrors rejections, with their line numbers.
+        QString error;                   ///< Why the import stopped, or empty if it ran to the end.
+        bool canceled = false;           ///< Whether cancel() stopped the import.
+
+        /**
+         * @brief Checks whether the whole file was read and committed.
+         */
+        bool isComplete() const { return error.isEmpty() && !canceled; }
+    };
+
+    /**
+     * @brief Constructs a BulkImporter object.
+     * @param connectionName The name of the database connection to write to.
+     * @param parent The parent object.
+     */
+    explicit BulkImporter(const QString &connectionName, QObject *parent = nullptr);
+
+    /**
+     * @brief Sets how many rows are written per transaction.
+     * @param rows The chunk size; values below 1 are ignored.
+     */
+    void setChunkSize(int rows);
+
+    /**
+     * @brief Imports a CSV file.
+     * @param filePath The file to read.
+     * @return The outcome. Chunks committed before an error or cancel() are kept.
+     */
+    Result importFile(const QString &filePath);
+
+    /**
+     * @brief Imports CSV data from an open device.
+     * @param device The device to read, positioned at the header row.
+     * @return The outcome. Chunks committed before an error or cancel() are kept.
+     */
+    Result importCsv(QIODevice *device);
+
+    /**
+     * @brief Detects the format of CSV data from its column names.
+     * @param header The column names.
+     */
+    static Format detectFormat(const QStringList &header);
+
+    /**
+     * @brief Detects the format of a CSV file from its header row.
+     * @param filePath The file to read.
+     */
+    static Format detectFileFormat(const QString &filePath);
+
+    /**
+     * @brief Gets a user-visible name for a format, e.g. "players".
+     */
+    static QString formatName(Format format);
+
+    /**
+     * @brief Describes the outcome of an import for the user.
+     */
+    static QString summary(const Result &result);
+
+    /**
+     * @brief Imports a file while showing a cancelable progress dialog, then shows the outcome.
+     * @param connectionName The name of the database connection to write to.
+     * @param filePath The file to read.
+     * @param parent The parent of the dialogs.
+     * @return The outcome.
+     */
+    static Result importWithProgress(const QString &connectionName, const QString &filePath, QWidget *parent);
+
+public slots:
+    /**
+     * @brief Stops the import after the chunk being written is committed.
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief Emitted after each committed chunk.
+     * @param bytesRead The bytes of the file read so far.
+     * @param totalBytes The size of the file, or 0 if it is not known.
+     */
+    void progress(qint64 bytesRead, qint64 totalBytes);
+
+private:
+    QString m_connectionName;
+    int m_chunkSize;
+    bool m_canceled;
+};
+
+#endif // BULKIMPORTER_H
@@ -0,0 +1,115 @@
+/**
+ * @file ChangeTracker.cpp
+ * @brief Implements the ChangeTracker class.
+ */
+
+#include "ChangeTracker.h"
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+
+ChangeTracker::ChangeTracker(const QString &connectionName)
+    : m_connectionName(connectionName)
+{
+}
+
+ChangeTracker::~ChangeTracker() = default;
+
+QString ChangeTracker::tableName(Table table)
+{
+    switch (table) {
+    case Players: return QStringLiteral("players");
+    case Courses: return QStringLiteral("courses");
+    case Holes: return QStringLiteral("holes");
+    case Teams: return QStringLiteral("teams");
+    case Scores: return QStringLiteral("scores");
+    case Settings: return QStringLiteral("settings");
+    case Events: return QStringLiteral("events");
+    }
+    return QString();
+}
+
+/**
+ * @brief Prepares the two statements on first use.
+ * @return True if both statements are ready.
+ */
+bool ChangeTracker::prepare()
+{
+    if (m_versionQuery && m_countersQuery) {
+        return true;
+    }
+
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    if (!db.isValid() || !db.isOpen()) {
+        qDebug() << "ChangeTracker::prepare: ERROR: Invalid or closed database connection.";
+        return false;
+    }
+
+    auto versionQuery = std::make_unique<QSqlQuery>(db);
+    auto countersQuery = std::make_unique<QSqlQuery>(db);
+    versionQuery->setForwardOnly(true);
+    countersQuery->setForwardOnly(true);
+    if (!versionQuery->prepare("SELECT data_version, total_changes() FROM pragma_data_version") ||
+        !countersQuery->prepare("SELECT table_name, counter FROM change_counters")) {
+        qDebug() << "ChangeTracker::prepare: ERROR:" << versionQuery->lastError().text() << countersQuery->lastError().text();
+        return false;
+    }
+    m_versionQuery = std::move(versionQuery);
+    m_countersQuery = std::move(countersQuery);
+    return true;
+}
+
+ChangeTracker::Stamp ChangeTracker::current()
+{
+    if (!prepare()) {
+        return Stamp();
+    }
+
+    if (!m_versionQuery->exec() || !m_versionQuery->next()) {
+        qDebug() << "ChangeTracker::current: ERROR reading data_version:" << m_versionQuery->lastError().text();
+        return Stamp();
+    }
+    const qint64 dataVersion = m_versionQuery->value(0).toLongLong();
+    const qint64 totalChanges = m_versionQuery->value(1).toLongLong();
+    m_versionQuery->finish();
+
+    if (m_last.isValid() && m_last.dataVersion == dataVersion && m_last.totalChanges == totalChanges) {
+        return m_last;
+    }
+
+    Stamp stamp;
+    stamp.dataVersion = dataVersion;
+    stamp.totalChanges = totalChanges;
+    if (!m_countersQuery->exec()) {
+        qDebug() << "ChangeTracker::current: ERROR reading change_counters:" << m_countersQuery->lastError().text();
+        return Stamp();
+    }
+    while (m_countersQuery->next()) {
+        const QString name = m_countersQuery->value(0).toString();
+        for (int i = 0; i < TableCount; ++i) {
+            if (name == tableName(Table(1 << i))) {
+                stamp.counters[i] = m_countersQuery->value(1).toLongLong();
+                break;
+            }
+        }
+    }
+    m_countersQuery->finish();
+
+    m_last = stamp;
+    return stamp;
+}
+
+ChangeTracker::Tables ChangeTracker::changedBetween(const Stamp &before, const Stamp &after)
+{
+    if (!before.isValid() || !after.isValid()) {
+        return AllTables;
+    }
+    Tables changed;
+    for (int i = 0; i < TableCount; ++i) {
+        if (before.counters[i] != after.counters[i]) {
+            changed |= Table(1 << i);
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file ChangeTracker.h
+ * @brief Contains the declaration of the ChangeTracker class.
+ */
+
+#ifndef CHANGETRACKER_H
+#define CHANGETRACKER_H
+
+#include <QFlags>
+#include <QSqlQuery>
+#include <QString>
+#include <array>
+#include <memory>
+
+/**
+ * @class ChangeTracker
+ * @brief Tells which tables have been written since an earlier point in time.
+ *
+ * Triggers created by SchemaMigrator count every insert, update and delete per
+ * table in change_counters, whichever connection or process makes it. A Stamp
+ * records those counters; comparing two stamps gives the tables that changed.
+ *
+ * Reading the counters is skipped while PRAGMA data_version (commits by other
+ * connections) and total_changes() (writes by this connection) are both
+ * unchanged, so checking an idle database costs a single tiny statement.
+ *
+ * A tracker uses the connection it was created for and must stay on the
+ * thread that owns that connection.
+ */
+class ChangeTracker
+{
+public:
+    /**
+     * @enum Table
+     * @brief The tracked tables.
+     */
+    enum Table {
+        Players  = 0x01,
+        Courses  = 0x02,
+        Holes    = 0x04,
+        Teams    = 0x08,
+        Scores   = 0x10,
+        Settings = 0x20,
+        Events   = 0x40     ///< Includes switching the current event.
+    };
+    Q_DECLARE_FLAGS(Tables, Table)
+
+    static constexpr int TableCount = 7;            ///< The number of tracked tables.
+    static constexpr Tables AllTables = Tables::fromInt(0x7f); ///< Every tracked table.
+
+    /**
+     * @struct Stamp
+     * @brief The change counters at one point in time.
+     */
+    struct Stamp {
+        qint64 dataVersion = -1;    ///< PRAGMA data_version when the stamp was taken.
+        qint64 totalChanges = -1;   ///< total_changes() when the stamp was taken.
+        std::array<qint64, TableCount> counters{}; ///< The change counter of each table.
+
+        /**
+         * @brief Checks whether the stamp was read from a database.
+         */
+        bool isValid() const { return dataVersion >= 0; }
+    };
+
+    /**
+     * @brief Constructs a ChangeTracker for a connection.
+     * @param connectionName The name of the database connection.
+     */
+    explicit ChangeTracker(const QString &connectionName);
+    ~ChangeTracker();
+
+    /**
+     * @brief Reads the current stamp.
+     * @return The stamp, invalid if the database could not be read.
+     */
+    Stamp current();
+
+    /**
+     * @brief Gets the tables that changed since a stamp was taken.
+     *
+     * An invalid stamp, or a failure to read the database, reports every table.
+     */
+    Tables changedSince(const Stamp &stamp) { return changedBetween(stamp, current()); }
+
+    /**
+     * @brief Gets the tables whose counters differ between two stamps.
+     */
+    static Tables changedBetween(const Stamp &before, const Stamp &after);
+
+    /**
+     * @brief Gets the name of a table in change_counters.
+     */
+    static QString tableName(Table table);
+
+private:
+    QString m_connectionName;
+    std::unique_ptr<QSqlQuery> m_versionQuery;  ///< Reads data_version and total_changes().
+    std::unique_ptr<QSqlQuery> m_countersQuery; ///< Reads change_counters.
+    Stamp m_last;                               ///< The last stamp read.
+
+    bool prepare();
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(ChangeTracker::Tables)
+
+#endif // CHANGETRACKER_H
@@ -6,6 +6,8 @@
 #include "CoursesDialog.h"
 #include "SpinBoxDelegate.h"
 #include "CheckBoxDelegate.h"
+#include "BulkImporter.h"
+#include "CsvExportEngine.h"
 #include <QtWidgets>
 #include <QtSql>
 
@@ -30,6 +32,7 @@ CoursesDialog::CoursesDialog(QSqlDatabase &db, QWidget *parent)
     , removeButton(new QPushButton(tr("Remove"), this))
     , exportButton(new QPushButton(tr("Export"), this))
     , closeButton(new QPushButton(tr("Close"), this))
+    , importButton(new QPushButton(tr("Import"), this))
 {
     // Models
     courseModel->setTable("courses");
@@ -76,6 +79,7 @@ CoursesDialog::CoursesDialog(QSqlDatabase &db, QWidget *parent)
     buttonLayout->addWidget(addButton);
     buttonLayout->addWidget(removeButton);
     buttonLayout->addWidget(exportButton);
+    buttonLayout->addWidget(importButton);
     buttonLayout->addStretch();
     buttonLayout->addWidget(closeButton);
 
@@ -90,6 +94,7 @@ CoursesDialog::CoursesDialog(QSqlDatabase &db, QWidget *parent)
     connect(addButton, &QPushButton::clicked, this, &CoursesDialog::addCourse);
     connect(removeButton, &QPushButton::clicked, this, &CoursesDialog::removeSelected);
     connect(exportButton, &QPushButton::clicked, this, &CoursesDialog::exportData);
+    connect(importButton, &QPushButton::clicked, this, &CoursesDialog::importData);
     connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
     auto *selModel = courseView->selectionModel();
     connect(selModel, &QItemSelectionModel::currentChanged,
@@ -139,7 +144,8 @@ void CoursesDialog::addCourse() {
         courseModel->index(row, /*id_column=*/0)
     ).toInt();
 
-    // 3) Populate exactly 18 holes for that course
+    // 3) Populate exactly 18 holes for that course, in one transaction
+    database.transaction();
     QSqlQuery q(database);
     q.prepare("INSERT INTO holes (course_id, hole_num, par, handicap) "
               "VALUES (:cid, :hnum, :par, :hc)");
@@ -148,7 +154,14 @@ void CoursesDialog::addCourse() {
         q.bindValue(":hnum", holeNum);
         q.bindValue(":par", 4);    // or whatever default par you choose
         q.bindValue(":hc", holeNum);
-        q.exec();
+        if (!q.exec()) {
+            qWarning() << "CoursesDialog::addCourse - Failed to add hole" << holeNum << ":" << q.lastError().text();
+        }
+    }
+    q.finish();
+    if (!database.commit()) {
+        qWarning() << "CoursesDialog::addCourse - Failed to commit the holes:" << database.lastError().text();
+        database.rollback();
     }
     // Refresh the model so the view picks up the new rows
     holesTransposedModel->setCourseId(courseId);
@@ -210,104 +223,54 @@ void CoursesDialog::exportData() {
         baseFilePath.chop(4); // Remove the last 4 characters (.csv)
     }
 
-    QString courseFilePath = baseFilePath + "_Courses.csv";
-
-    QStringList exportedFiles; // To list files successfully exported
-    QStringList failedFiles; // To list files that failed to export
-
-    // --- Export Course Data ---
-    QFile courseFile(courseFilePath);
-    if (courseFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&courseFile);
-        out.setEncoding(QStringConverter::Utf8);
-
-        // Write headers from courseModel
-        QStringList courseHeaderLabels;
-        for (int i = 0; i < courseModel->columnCount(); ++i) {
-            // Get header data, handle quoting for CSV
-            QString headerText = courseModel->headerData(i, Qt::Horizontal, Qt::DisplayRole).toString();
-            courseHeaderLabels << QString("\"%1\"").arg(headerText.replace("\"", "\"\""));
-        }
-        out << courseHeaderLabels.join(",") << "\n";
+    CsvExportEngine::exportWithProgress(database.connectionName(),
+                                        { { CsvExportEngine::Dataset::Courses, baseFilePath + "_Courses.csv" },
+                                          { CsvExportEngine::Dataset::Holes, baseFilePath + "_AllHoles_Normalized.csv" } },
+                                        this);
+}
 
-        // Write data rows from courseModel
-        for (int row = 0; row < courseModel->rowCount(); ++row) {
-            QStringList rowData;
-            for (int column = 0; column < courseModel->columnCount(); ++column) {
-                QVariant cellData = courseModel->data(courseModel->index(row, column), Qt::DisplayRole);
-                QString cellString = cellData.toString();
-                // Handle CSV quoting
-                if (cellString.contains(',') || cellString.contains('"') || cellString.contains('\n') || cellString.contains('\r')) {
-                     rowData << QString("\"%1\"").arg(cellString.replace("\"", "\"\""));
-                } else {
-                     rowData << cellString;
-                }
-            }
-            out << rowData.join(",") << "\n";
-        }
-        courseFile.close();
-        exportedFiles << QDir::toNativeSeparators(courseFilePath);
-    } else {
-        qCritical() << "Failed to open file for course data export:" << courseFilePath << "-" << courseFile.errorString();
-         QMessageBox::critical(this, tr("File Error"),
-                              tr("Could not open file for writing course data:\n%1\nError: %2")
-                              .arg(QDir::toNativeSeparators(courseFilePath)).arg(courseFile.errorString()));
+/**
+ * @brief Imports course and hole data from CSV files.
+ *
+ * This slot is called when the "Import" button is clicked. The user may pick
+ * the course file and the holes file written by exportData() together; course
+ * files are imported first so the holes can refer to their courses.
+ */
+void CoursesDialog::importData() {
+    QStringList filePaths = QFileDialog::getOpenFileNames(this,
+                                                          tr("Import Course Data"),
+                                                          QDir::homePath(),
+                                                          tr("CSV Files (*.csv);;All Files (*)")
+                                                          );
+    if (filePaths.isEmpty()) {
+        return;
     }
 
-    // --- Export Hole Data (for the currently selected course) ---
-    // --- Export All Hole Data (Normalized Format) ---
-    QString allHolesFilePath = baseFilePath + "_AllHoles_Normalized.csv";
-    QFile allHolesFile(allHolesFilePath);
-     if (allHolesFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&allHolesFile);
-        out.setEncoding(QStringConverter::Utf8);
-
-        QSqlQuery holesQuery(database);
-        // Select all hole data, ordered by course and hole number for readability
-        if (holesQuery.exec("SELECT course_id, id, hole_num, par, handicap FROM holes ORDER BY course_id, hole_num")) { // Added 'id' if you need the hole's primary key
-            // Write header row
-            QSqlRecord record = holesQuery.record();
-            QStringList headerLabels;
-            for (int i = 0; i < record.count(); ++i) {
-                QString fieldName = record.fieldName(i);
-                 headerLabels << QString("\"%1\"").arg(fieldName.replace("\"", "\"\""));
-            }
-            out << headerLabels.join(",") << "\n";
-
-            // Write data rows
-            while (holesQuery.next()) {
-                QStringList rowData;
-                for (int i = 0; i < record.count(); ++i) {
-                     QVariant cellData = holesQuery.value(i);
-                     QString cellString = cellData.toString();
-                     // Handle CSV quoting
-                    if (cellString.contains(',') || cellString.contains('"') || cellString.contains('\n') || cellString.contains('\r')) {
-                         rowData << QString("\"%1\"").arg(cellString.replace("\"", "\"\""));
-                    } else {
-                         rowData << cellString;
-                    }
-                }
-                out << rowData.join(",") << "\n";
-            }
-            allHolesFile.close();
-            exportedFiles << QDir::toNativeSeparators(allHolesFilePath);
-        } else {
-            allHolesFile.close(); // Close file even on query error
-            failedFiles << QDir::toNativeSeparators(allHolesFilePath);
-            qCritical() << "Failed to query holes table:" << holesQuery.lastError().text();
+    QStringList courseFiles;
+    QStringList holeFiles;
+    for (const QString &filePath : filePaths) {
+        switch (BulkImporter::detectFileFormat(filePath)) {
+        case BulkImporter::Format::Courses:
+            courseFiles << filePath;
+            break;
+        case BulkImporter::Format::Holes:
+            holeFiles << filePath;
+            break;
+        default:
+            QMessageBox::warning(this, tr("Import Course Data"),
+                                 tr("%1 is not a course or holes file and was skipped.").arg(QDir::toNativeSeparators(filePath)));
+            break;
         }
+    }
 
-     } else {
-        failedFiles << QDir::toNativeSeparators(allHolesFilePath);
-        qCritical() << "Failed to open file for holes data export:" << allHolesFilePath << "-" << allHolesFile.errorString();
-     }
-
+    for (const QString &filePath : courseFiles + holeFiles) {
+        BulkImporter::importWithProgress(database.connectionName(), filePath, this);
+    }
 
-    // Show a summary message if any files were exported
-    if (!exportedFiles.isEmpty()) {
-        QMessageBox::information(this, tr("Export Complete"),
-                                 tr("Successfully exported the following files:\n%1").arg(exportedFiles.join("\n")));
-    } else {
-         QMessageBox::warning(this, tr("Export Complete"), tr("No data was exported. Check if courses and holes exist."));
+    courseModel->select();
+    holesTransposedModel->setCourseId(-1);
+    if (courseModel->rowCount() > 0) {
+        courseView->selectRow(0);
+        onCourseSelectionChanged(courseModel->index(0, 0));
     }
 }
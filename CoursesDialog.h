@@ -61,6 +61,11 @@ private slots:
      */
     void exportData();
 
+    /**
+     * @brief Imports course and hole data from CSV files written by exportData().
+     */
+    void importData();
+
 private:
     QSqlTableModel *courseModel;            ///< The model for the course data.
     HolesTransposedModel *holesTransposedModel; ///< The model for the transposed hole data.
@@ -70,6 +75,7 @@ private:
     QPushButton *removeButton;              ///< The button for removing a selected course.
     QPushButton *closeButton;               ///< The button for closing the dialog.
     QPushButton *exportButton;              ///< The button for exporting data.
+    QPushButton *importButton;              ///< The button for importing data.
     QSqlDatabase &database;                 ///< A reference to the database connection.
 };
 
@@ -0,0 +1,567 @@
+/**
+ * @file CsvExportEngine.cpp
+ * @brief Implements the CsvExportEngine class.
+ */
+
+#include "CsvExportEngine.h"
+#include "DatabaseManager.h"
+#include "TournamentSnapshot.h"
+#include "TournamentLeaderboardModel.h"
+#include "DailyLeaderboardModel.h"
+#include "TeamLeaderboardModel.h"
+
+#include <QSaveFile>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QSqlError>
+#include <QAtomicInteger>
+#include <QPromise>
+#include <QtConcurrent>
+#include <QProgressDialog>
+#include <QEventLoop>
+#include <QMessageBox>
+#include <QDir>
+#include <QDebug>
+#include <climits>
+
+namespace {
+
+constexpr int ProgressInterval = 4096;      ///< Rows between progress reports and cancellation checks.
+constexpr qsizetype FlushThreshold = 64 * 1024; ///< Bytes buffered before they are written to the file.
+
+/**
+ * @struct DatasetDefinition
+ * @brief The default file name and queries of a dataset; leaderboards have no queries.
+ */
+struct DatasetDefinition {
+    const char *fileName;
+    const char *sql;
+    const char *countSql; ///< Counts the rows of sql without sorting them or looking up names.
+};
+
+// Indexed by CsvExportEngine::Dataset. Column names become the header row;
+// the players, courses and holes headers match what BulkImporter reads.
+// The count queries keep only the joins that can change the number of rows.
+constexpr DatasetDefinition dataset_definitions[] = {
+    { "Players.csv",
+      "SELECT name AS \"Name\", handicap AS \"Handicap\", active AS \"Active\" FROM players ORDER BY id",
+      "SELECT COUNT(*) FROM players" },
+    { "Courses.csv",
+      "SELECT id, name AS \"Course Name\" FROM courses ORDER BY id",
+      "SELECT COUNT(*) FROM courses" },
+    { "Holes.csv",
+      "SELECT course_id, id, hole_num, par, handicap FROM holes ORDER BY course_id, hole_num",
+      "SELECT COUNT(*) FROM holes" },
+    { "Scores.csv",
+      "SELECT player_id, course_id, day_num, hole_num, score FROM scores "
+      "WHERE event_id = (SELECT id FROM current_event) ORDER BY day_num, course_id, player_id, hole_num",
+      "SELECT COUNT(*) FROM scores WHERE event_id = (SELECT id FROM current_event)" },
+    { "ScoreHistory.csv",
+      "SELECT e.name AS event, s.event_id, s.player_id, p.name AS player, s.course_id, s.day_num, s.hole_num, s.score "
+      "FROM scores s JOIN events e ON e.id = s.event_id LEFT JOIN players p ON p.id = s.player_id "
+      "ORDER BY s.event_id, s.day_num, s.course_id, s.player_id, s.hole_num",
+      "SELECT COUNT(*) FROM scores s JOIN events e ON e.id = s.event_id" },
+    { "RoundSummaries.csv",
+      "SELECT e.name AS event, p.name AS player, r.day_num, c.name AS course, "
+      "r.holes_played, r.gross_strokes, r.gross_stableford "
+      "FROM round_summaries r JOIN events e ON e.id = r.event_id "
+      "LEFT JOIN players p ON p.id = r.player_id LEFT JOIN courses c ON c.id = r.course_id "
+      "ORDER BY r.event_id, r.player_id, r.day_num, r.course_id",
+      "SELECT COUNT(*) FROM round_summaries r JOIN events e ON e.id = r.event_id" },
+    { "Teams.csv",
+      "SELECT t.id AS team_id, t.name AS team, p.name AS player FROM teams t "
+      "LEFT JOIN team_members m ON m.event_id = t.event_id AND m.team_id = t.id "
+      "LEFT JOIN players p ON p.id = m.player_id "
+      "WHERE t.event_id = (SELECT id FROM current_event) ORDER BY t.id, p.name",
+      "SELECT COUNT(*) FROM teams t "
+      "LEFT JOIN team_members m ON m.event_id = t.event_id AND m.team_id = t.id "
+      "WHERE t.event_id = (SELECT id FROM current_event)" },
+    { "Events.csv",
+      "SELECT id, name, is_current FROM events ORDER BY id",
+      "SELECT COUNT(*) FROM events" },
+    { "MosleyOpenLeaderboard.csv", nullptr, nullptr },
+    { "TwistedCreekLeaderboard.csv", nullptr, nullptr },
+    { "Day1Leaderboard.csv", nullptr, nullptr },
+    { "Day2Leaderboard.csv", nullptr, nullptr },
+    { "Day3Leaderboard.csv", nullptr, nullptr },
+    { "TeamLeaderboard.csv", nullptr, nullptr },
+};
+static_assert(std::size(dataset_definitions) == static_cast<size_t>(CsvExportEngine::Dataset::TeamLeaderboard) + 1);
+
+const DatasetDefinition &definition(CsvExportEngine::Dataset dataset)
+{
+    return dataset_definitions[static_cast<int>(dataset)];
+}
+
+/**
+ * @class CsvWriter
+ * @brief Escapes fields and writes whole records to a file through a buffer.
+ */
+class CsvWriter
+{
+public:
+    explicit CsvWriter(QSaveFile *file) : m_file(file) { m_buffer.reserve(FlushThreshold + 4096); }
+
+    void addField(const QVariant &value)
+    {
+        if (m_fieldCount++ > 0) {
+            m_buffer += ',';
+        }
+        switch (value.typeId()) {
+        case QMetaType::UnknownType:
+            break;
+        case QMetaType::Int:
+        case QMetaType::LongLong:
+            m_buffer += QByteArray::number(value.toLongLong());
+            break;
+        case QMetaType::Bool:
+            m_buffer += value.toBool() ? '1' : '0';
+            break;
+        default:
+            if (!value.isNull()) {
+                addText(value.toString().toUtf8());
+            }
+            break;
+        }
+    }
+
+    void addText(const QByteArray &text)
+    {
+        // Quote when the field holds a separator, a quote or a line break, or
+        // starts or ends with a space that a reader might trim.
+        bool needsQuotes = !text.isEmpty() && (text.front() == ' ' || text.back() == ' ');
+        for (char c : text) {
+            if (c == ',' || c == '"' || c == '\n' || c == '\r') {
+                needsQuotes = true;
+                break;
+            }
+        }
+        if (!needsQuotes) {
+            m_buffer += text;
+            return;
+        }
+        m_buffer += '"';
+        for (char c : text) {
+            if (c == '"') {
+                m_buffer += '"';
+            }
+            m_buffer += c;
+        }
+        m_buffer += '"';
+    }
+
+    /**
+     * @brief Ends the record, writing the buffer out once it is large enough.
+     */
+    bool endRecord()
+    {
+        m_buffer += '\n';
+        m_fieldCount = 0;
+        return m_buffer.size() < FlushThreshold || flush();
+    }
+
+    bool flush()
+    {
+        if (m_buffer.isEmpty()) {
+            return true;
+        }
+        const bool written = m_file->write(m_buffer) == m_buffer.size();
+        m_buffer.clear();
+        return written;
+    }
+
+    /**
+     * @brief Writes a header row, quoting every name as the dialogs' exports did.
+     */
+    bool writeHeader(const QStringList &names)
+    {
+        for (const QString &name : names) {
+            if (m_fieldCount++ > 0) {
+                m_buffer += ',';
+            }
+            m_buffer += '"' + name.toUtf8().replace('"', "\"\"") + '"';
+        }
+        return endRecord();
+    }
+
+private:
+    QSaveFile *m_file;
+    QByteArray m_buffer;
+    int m_fieldCount = 0;
+};
+
+/**
+ * @class ExportProgress
+ * @brief Reports rows written to a promise and tells when it is canceled.
+ */
+class ExportProgress
+{
+public:
+    explicit ExportProgress(QPromise<CsvExportEngine::Result> *promise) : m_promise(promise) {}
+
+    void addTotal(qint64 rows)
+    {
+        m_total += rows;
+        if (m_promise) {
+            m_promise->setProgressRange(0, int(qMin<qint64>(m_total, INT_MAX)));
+        }
+    }
+
+    /**
+     * @brief Counts a written row.
+     * @return False if the export was canceled.
+     */
+    bool rowWritten()
+    {
+        if (++m_rows % ProgressInterval != 0) {
+            return true;
+        }
+        report();
+        return !isCanceled();
+    }
+
+    void report()
+    {
+        if (m_promise) {
+            m_promise->setProgressValue(int(qMin<qint64>(m_rows, INT_MAX)));
+        }
+    }
+
+    bool isCanceled() const { return m_promise && m_promise->isCanceled(); }
+    qint64 rows() const { return m_rows; }
+
+private:
+    QPromise<CsvExportEngine::Result> *m_promise;
+    qint64 m_total = 0;
+    qint64 m_rows = 0;
+};
+
+/**
+ * @brief Streams the rows of a query into a writer.
+ * @return An error message, or an empty string on success or cancellation.
+ */
+QString writeQuery(const QSqlDatabase &db, const char *sql, CsvWriter &writer, ExportProgress &progress)
+{
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec(QLatin1String(sql))) {
+        return query.lastError().text();
+    }
+
+    const QSqlRecord record = query.record();
+    const int columnCount = record.count();
+    QStringList header;
+    for (int column = 0; column < columnCount; ++column) {
+        header << record.fieldName(column);
+    }
+    if (!writer.writeHeader(header)) {
+        return QObject::tr("Could not write to the file.");
+    }
+
+    while (query.next()) {
+        for (int column = 0; column < columnCount; ++column) {
+            writer.addField(query.value(column));
+        }
+        if (!writer.endRecord()) {
+            return QObject::tr("Could not write to the file.");
+        }
+        if (!progress.rowWritten()) {
+            break;
+        }
+    }
+    if (query.lastError().isValid()) {
+        return query.lastError().text();
+    }
+    return QString();
+}
+
+/**
+ * @brief Writes what a leaderboard model displays, fetching its rows in batches as they are written.
+ */
+QString writeModel(QAbstractItemModel &model, CsvWriter &writer, ExportProgress &progress)
+{
+    int rowCount = model.rowCount();
+    const int columnCount = model.columnCount();
+    progress.addTotal(rowCount);
+
+    QStringList header;
+    for (int column = 0; column < columnCount; ++column) {
+        header << model.headerData(column, Qt::Horizontal, Qt::DisplayRole).toString();
+    }
+    if (!writer.writeHeader(header)) {
+        return QObject::tr("Could not write to the file.");
+    }
+    for (int row = 0; row < rowCount || model.canFetchMore(QModelIndex()); ++row) {
+        if (row == rowCount) {
+            model.fetchMore(QModelIndex());
+            progress.addTotal(model.rowCount() - rowCount);
+            rowCount = model.rowCount();
+            if (row == rowCount) {
+                break;
+            }
+        }
+        for (int column = 0; column < columnCount; ++column) {
+            writer.addField(model.data(model.index(row, column), Qt::DisplayRole));
+        }
+        if (!writer.endRecord()) {
+            return QObject::tr("Could not write to the file.");
+        }
+        if (!progress.rowWritten()) {
+            break;
+        }
+    }
+    return QString();
+}
+
+/**
+ * @brief Reads the cut line settings of the current event, as the leaderboard dialog stores them.
+ */
+void readCutSettings(const QSqlDatabase &db, int *cutLineScore, bool *isCutApplied)
+{
+    *cutLineScore = 0;
+    *isCutApplied = false;
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT key, value FROM settings WHERE event_id = (SELECT id FROM current_event) "
+                    "AND key IN ('cutLineScore', 'isCutApplied')")) {
+        qWarning() << "CsvExportEngine: Could not read the cut settings:" << query.lastError().text();
+        return;
+    }
+    while (query.next()) {
+        if (query.value(0).toString() == QLatin1String("cutLineScore")) {
+            *cutLineScore = query.value(1).toInt();
+        } else {
+            *isCutApplied = query.value(1).toBool();
+        }
+    }
+}
+
+/**
+ * @brief Calculates a leaderboard from the snapshot and writes it.
+ */
+QString writeLeaderboard(CsvExportEngine::Dataset dataset, const QString &connectionName, const TournamentSnapshot &snapshot,
+                         CsvWriter &writer, ExportProgress &progress)
+{
+    using Dataset = CsvExportEngine::Dataset;
+    switch (dataset) {
+    case Dataset::MosleyOpenLeaderboard:
+    case Dataset::TwistedCreekLeaderboard: {
+        const auto context = dataset == Dataset::MosleyOpenLeaderboard ? TournamentLeaderboardModel::MosleyOpen
+                                                                       : TournamentLeaderboardModel::TwistedCreek;
+        int cutLineScore = 0;
+        bool isCutApplied = false;
+        readCutSettings(QSqlDatabase::database(connectionName), &cutLineScore, &isCutApplied);
+        TournamentLeaderboardModel model(connectionName);
+        model.setTournamentContext(context);
+        model.setCutLineScore(cutLineScore);
+        model.setIsCutApplied(isCutApplied);
+        model.setResult(TournamentLeaderboardModel::calculate(snapshot, context, cutLineScore, isCutApplied));
+        return writeModel(model, writer, progress);
+    }
+    case Dataset::Day1Leaderboard:
+    case Dataset::Day2Leaderboard:
+    case Dataset::Day3Leaderboard: {
+        const int dayNum = static_cast<int>(dataset) - static_cast<int>(Dataset::Day1Leaderboard) + 1;
+        DailyLeaderboardModel model(connectionName, dayNum);
+        model.setResult(snapshot, DailyLeaderboardModel::calculate(snapshot, dayNum));
+        return writeModel(model, writer, progress);
+    }
+    case Dataset::TeamLeaderboard: {
+        TeamLeaderboardModel model(connectionName);
+        model.setResult(snapshot, TeamLeaderboardModel::calculate(snapshot));
+        return writeModel(model, writer, progress);
+    }
+    default:
+        return QObject::tr("Not a leaderboard.");
+    }
+}
+
+/**
+ * @brief Opens a read-only connection for the worker and writes the jobs.
+ */
+void runExport(QPromise<CsvExportEngine::Result> &promise, const QString &connectionName, const QList<CsvExportEngine::Job> &jobs)
+{
+    static QAtomicInteger<quint64> workerConnectionCounter;
+    const QString workerConnectionName = QString("%1_export_worker_%2").arg(connectionName).arg(++workerConnectionCounter);
+
+    CsvExportEngine::Result result;
+    {
+        QSqlDatabase db = DatabaseManager::open(workerConnectionName, DatabaseManager::Access::ReadOnly);
+        if (db.isOpen()) {
+            result = CsvExportEngine::exportNow(workerConnectionName, jobs, &promise);
+        } else {
+            result.error = db.lastError().text();
+        }
+    }
+    DatabaseManager::close(workerConnectionName);
+    promise.addResult(result);
+}
+
+} // namespace
+
+CsvExportEngine::CsvExportEngine(const QString &connectionName, QObject *parent)
+    : QObject(parent)
+    , m_connectionName(connectionName)
+{
+    connect(&m_watcher, &QFutureWatcher<Result>::progressValueChanged, this, [this](int value) {
+        emit progress(value, m_watcher.progressMaximum());
+    });
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, &CsvExportEngine::onWorkerFinished);
+}
+
+CsvExportEngine::~CsvExportEngine()
+{
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+}
+
+bool CsvExportEngine::start(const QList<Job> &jobs)
+{
+    if (m_watcher.isRunning()) {
+        return false;
+    }
+    m_watcher.setFuture(QtConcurrent::run(runExport, m_connectionName, jobs));
+    return true;
+}
+
+bool CsvExportEngine::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void CsvExportEngine::cancel()
+{
+    m_watcher.cancel();
+}
+
+void CsvExportEngine::onWorkerFinished()
+{
+    Result result;
+    if (m_watcher.future().resultCount() > 0) {
+        result = m_watcher.result();
+    }
+    // A canceled future drops results added after the cancellation.
+    result.canceled = result.canceled || m_watcher.isCanceled();
+    emit finished(result);
+}
+
+CsvExportEngine::Result CsvExportEngine::exportNow(const QString &connectionName, const QList<Job> &jobs, QPromise<Result> *promise)
+{
+    Result result;
+    ExportProgress progress(promise);
+    const QSqlDatabase db = QSqlDatabase::database(connectionName);
+
+    // Count the rows up front so progress can be shown as a fraction. The
+    // counts skip the sorting and name lookups, so they cost far less than the export.
+    for (const Job &job : jobs) {
+        if (const char *countSql = definition(job.dataset).countSql) {
+            QSqlQuery count(db);
+            count.setForwardOnly(true);
+            if (count.exec(QLatin1String(countSql)) && count.next()) {
+                progress.addTotal(count.value(0).toLongLong());
+            }
+        }
+    }
+
+    TournamentSnapshot snapshot;
+    for (const Job &job : jobs) {
+        if (progress.isCanceled()) {
+            break;
+        }
+
+        QSaveFile file(job.filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            result.error = tr("Could not open %1: %2").arg(QDir::toNativeSeparators(job.filePath), file.errorString());
+            break;
+        }
+
+        CsvWriter writer(&file);
+        QString error;
+        if (const char *sql = definition(job.dataset).sql) {
+            error = writeQuery(db, sql, writer, progress);
+        } else {
+            if (!snapshot.isValid()) {
+                snapshot = TournamentSnapshot::load(connectionName);
+            }
+            error = snapshot.isValid() ? writeLeaderboard(job.dataset, connectionName, snapshot, writer, progress)
+                                       : tr("Could not read the tournament data.");
+        }
+        if (error.isEmpty() && !writer.flush()) {
+            error = file.errorString();
+        }
+
+        if (!error.isEmpty() || progress.isCanceled()) {
+            file.cancelWriting();
+            result.error = error;
+            break;
+        }
+        if (!file.commit()) {
+            result.error = tr("Could not save %1: %2").arg(QDir::toNativeSeparators(job.filePath), file.errorString());
+            break;
+        }
+        result.writtenFiles << job.filePath;
+    }
+
+    progress.report();
+    result.rows = progress.rows();
+    result.canceled = progress.isCanceled();
+    if (!result.error.isEmpty()) {
+        qWarning() << "CsvExportEngine::exportNow: ERROR:" << result.error;
+    }
+    return result;
+}
+
+QString CsvExportEngine::defaultFileName(Dataset dataset)
+{
+    return QLatin1String(definition(dataset).fileName);
+}
+
+QList<CsvExportEngine::Dataset> CsvExportEngine::allDatasets()
+{
+    QList<Dataset> datasets;
+    for (int i = 0; i < int(std::size(dataset_definitions)); ++i) {
+        datasets << static_cast<Dataset>(i);
+    }
+    return datasets;
+}
+
+CsvExportEngine::Result CsvExportEngine::exportWithProgress(const QString &connectionName, const QList<Job> &jobs, QWidget *parent)
+{
+    QProgressDialog progressDialog(tr("Exporting..."), tr("Cancel"), 0, 0, parent);
+    progressDialog.setWindowModality(Qt::WindowModal);
+    progressDialog.setMinimumDuration(0);
+    progressDialog.setAutoReset(false);
+
+    CsvExportEngine engine(connectionName);
+    Result result;
+    QEventLoop loop;
+    connect(&engine, &CsvExportEngine::progress, &progressDialog, [&](qint64 rowsWritten, qint64 totalRows) {
+        progressDialog.setMaximum(int(totalRows));
+        progressDialog.setValue(int(rowsWritten));
+    });
+    connect(&engine, &CsvExportEngine::finished, &loop, [&](const Result &finishedResult) {
+        result = finishedResult;
+        loop.quit();
+    });
+    connect(&progressDialog, &QProgressDialog::canceled, &engine, &CsvExportEngine::cancel);
+
+    // The event loop keeps the window responsive; canceling only asks the worker to stop.
+    engine.start(jobs);
+    loop.exec();
+    progressDialog.reset();
+
+    QStringList files;
+    for (const QString &filePath : std::as_const(result.writtenFiles)) {
+        files << QDir::toNativeSeparators(filePath);
+    }
+    if (!result.error.isEmpty()) {
+        QMessageBox::critical(parent, tr("Export Failed"), tr("The export stopped: %1").arg(result.error));
+    } else if (result.canceled) {
+        QMessageBox::information(parent, tr("Export Canceled"), tr("The export was canceled."));
+    } else {
+        QMessageBox::information(parent, tr("Export Complete"),
+                                 tr("Successfully exported the following files:\n%1").arg(files.join("\n")));
+    }
+    return result;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file CsvExportEngine.h
+ * @brief Contains the declaration of the CsvExportEngine class.
+ */
+
+#ifndef CSVEXPORTENGINE_H
+#define CSVEXPORTENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QFutureWatcher>
+
+class QWidget;
+template <typename T> class QPromise;
+
+/**
+ * @class CsvExportEngine
+ * @brief Writes tables and leaderboards to CSV files on a worker thread.
+ *
+ * Each job streams one dataset from a forward-only query straight into a
+ * buffered file, so memory use does not grow with the number of rows.
+ * Leaderboards are calculated from a TournamentSnapshot and written as the
+ * leaderboard dialog shows them. Files are written through QSaveFile: a job
+ * that fails or is canceled leaves any existing file untouched.
+ *
+ * The worker opens its own read-only connection through DatabaseManager.
+ * The players, courses and holes files can be read back by BulkImporter.
+ */
+class CsvExportEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Dataset
+     * @brief The data a job writes.
+     */
+    enum class Dataset {
+        Players,                    ///< Name, Handicap and Active, as PlayerDialog shows them.
+        Courses,                    ///< Course ids and names.
+        Holes,                      ///< Every hole of every course.
+        Scores,                     ///< Hole scores of the current event.
+        ScoreHistory,               ///< Hole scores of every event.
+        RoundSummaries,             ///< Round totals of every event, with player and course names.
+        Teams,                      ///< Teams and their members in the current event.
+        Events,                     ///< Every event.
+        MosleyOpenLeaderboard,      ///< The Mosley Open leaderboard of the current event.
+        TwistedCreekLeaderboard,    ///< The Twisted Creek leaderboard of the current event.
+        Day1Leaderboard,            ///< The day 1 leaderboard of the current event.
+        Day2Leaderboard,            ///< The day 2 leaderboard of the current event.
+        Day3Leaderboard,            ///< The day 3 leaderboard of the current event.
+        TeamLeaderboard             ///< The team leaderboard of the current event.
+    };
+
+    /**
+     * @struct Job
+     * @brief One dataset and the file to write it to.
+     */
+    struct Job {
+        Dataset dataset;    ///< The data to write.
+        QString filePath;   ///< The file to create or replace.
+    };
+
+    /**
+     * @struct Result
+     * @brief The outcome of an export.
+     */
+    struct Result {
+        QStringList writtenFiles;   ///< The files written completely, in job order.
+        qint64 rows = 0;            ///< The data rows written, not counting headers.
+        QString error;              ///< Why the export stopped, or empty.
+        bool canceled = false;      ///< Whether cancel() stopped the export.
+    };
+
+    /**
+     * @brief Constructs a CsvExportEngine object.
+     * @param connectionName The name of the GUI thread's connection, used to name the worker's connection.
+     * @param parent The parent object.
+     */
+    explicit CsvExportEngine(const QString &connectionName, QObject *parent = nullptr);
+
+    /**
+     * @brief Cancels a running export and waits for the worker to stop.
+     */
+    ~CsvExportEngine();
+
+    /**
+     * @brief Starts writing the jobs, in order, on a worker thread.
+     * @param jobs The datasets and their files.
+     * @return False if an export is already running.
+     */
+    bool start(const QList<Job> &jobs);
+
+    /**
+     * @brief Checks whether an export is running.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Writes the jobs on the calling thread, using an open connection.
+     * @param connectionName The connection to read from.
+     * @param jobs The datasets and their files.
+     * @param promise Receives progress and is checked for cancellation; may be null.
+     * @return The outcome.
+     */
+    static Result exportNow(const QString &connectionName, const QList<Job> &jobs, QPromise<Result> *promise = nullptr);
+
+    /**
+     * @brief Gets the file name a dataset is written to by default, e.g. "Players.csv".
+     */
+    static QString defaultFileName(Dataset dataset);
+
+    /**
+     * @brief Gets every dataset.
+     */
+    static QList<Dataset> allDatasets();
+
+    /**
+     * @brief Exports while showing a cancelable progress dialog, then shows the outcome.
+     *
+     * The event loop keeps running during the export.
+     *
+     * @param connectionName The name of the GUI thread's connection.
+     * @param jobs The datasets and their files.
+     * @param parent The parent of the dialogs.
+     * @return The outcome.
+     */
+    static Result exportWithProgress(const QString &connectionName, const QList<Job> &jobs, QWidget *parent);
+
+public slots:
+    /**
+     * @brief Stops the export. The file being written is discarded.
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief Emitted as rows are written.
+     * @param rowsWritten The rows written so far.
+     * @param totalRows The rows to write in all, or 0 while it is not known.
+     */
+    void progress(qint64 rowsWritten, qint64 totalRows);
+
+    /**
+     * @brief Emitted when the export has finished, failed or been canceled.
+     */
+    void finished(const CsvExportEngine::Result &result);
+
+private slots:
+    void onWorkerFinished();
+
+private:
+    QString m_connectionName;
+    QFutureWatcher<Result> m_watcher;
+};
+
+#endif // CSVEXPORTENGINE_H
@@ -4,17 +4,18 @@
  */
 
 #include "dailyleaderboardmodel.h"
-#include "utils.h"
-#include <QSqlQuery>
-#include <QSqlError>
-#include <QSqlRecord>
-#include <QSqlField>
 #include <algorithm>
 
+namespace {
+const QVariant center_alignment = static_cast<int>(Qt::AlignCenter);
+}
+
 DailyLeaderboardModel::DailyLeaderboardModel(const QString &connectionName, int dayNum, QObject *parent)
     : QAbstractTableModel(parent)
     , m_connectionName(connectionName)
     , m_dayNum(dayNum)
+    , m_headers{ QStringLiteral("Rank"), QStringLiteral("Player"),
+                 QString("Day %1 Total").arg(dayNum), QString("Day %1 Net").arg(dayNum) }
 {
     // Data is loaded on demand via refreshData()
 }
@@ -23,21 +24,16 @@ DailyLeaderboardModel::~DailyLeaderboardModel()
 {
 }
 
-QSqlDatabase DailyLeaderboardModel::database() const
-{
-    return QSqlDatabase::database(m_connectionName);
-}
-
 int DailyLeaderboardModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return m_leaderboardData.size();
+    return m_displayRows.size();
 }
 
 int DailyLeaderboardModel::columnCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return 4; // Rank, Player Name, Daily Total Points, Daily Net Points
+    return ColumnCount;
 }
 
 QVariant DailyLeaderboardModel::data(const QModelIndex &index, int role) const
@@ -47,20 +43,12 @@ QVariant DailyLeaderboardModel::data(const QModelIndex &index, int role) const
         return QVariant();
     }
 
-    const DailyLeaderboardRow* rowData = getLeaderboardRow(index.row());
-    if (!rowData) {
-        return QVariant();
-    }
-
     if (role == Qt::DisplayRole) {
-        if (index.column() == getColumnForRank()) return rowData->rank;
-        if (index.column() == getColumnForPlayerName()) return rowData->playerName;
-        if (index.column() == getColumnForDailyTotalPoints()) return rowData->dailyTotalPoints;
-        if (index.column() == getColumnForDailyNetPoints()) return rowData->dailyNetPoints;
+        return m_displayRows.at(index.row())[index.column()];
     }
 
     if (role == Qt::TextAlignmentRole) {
-        return static_cast<int>(Qt::AlignCenter);
+        return center_alignment;
     }
 
     return QVariant();
@@ -68,184 +56,286 @@ QVariant DailyLeaderboardModel::data(const QModelIndex &index, int role) const
 
 QVariant DailyLeaderboardModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
-    if (role == Qt::DisplayRole && orientation == Qt::Horizontal) {
-        if (section == getColumnForRank()) return "Rank";
-        if (section == getColumnForPlayerName()) return "Player";
-        if (section == getColumnForDailyTotalPoints()) return QString("Day %1 Total").arg(m_dayNum);
-        if (section == getColumnForDailyNetPoints()) return QString("Day %1 Net").arg(m_dayNum);
+    if (orientation != Qt::Horizontal || section < 0 || section >= ColumnCount) {
+        return QVariant();
+    }
+
+    if (role == Qt::DisplayRole) {
+        return m_headers[section];
     }
 
-    if (role == Qt::TextAlignmentRole && orientation == Qt::Horizontal) {
-        return static_cast<int>(Qt::AlignCenter);
+    if (role == Qt::TextAlignmentRole) {
+        return center_alignment;
     }
 
     return QVariant();
 }
 
-void DailyLeaderboardModel::refreshData()
+bool DailyLeaderboardModel::canFetchMore(const QModelIndex &parent) const
 {
-    beginResetModel();
+    return !parent.isValid() && m_displayRows.size() < m_leaderboardData.size();
+}
+
+void DailyLeaderboardModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    const int first = m_displayRows.size();
+    const int last = std::min(first + FetchBatchSize, static_cast<int>(m_leaderboardData.size())) - 1;
+    beginInsertRows(QModelIndex(), first, last);
+    for (int i = first; i <= last; ++i) {
+        m_displayRows.append(displayRow(m_leaderboardData.at(i)));
+    }
+    endInsertRows();
+}
 
-    m_allPlayers.clear();
-    m_allHoleDetails.clear();
-    m_dailyScores.clear();
-    m_leaderboardData.clear();
+int DailyLeaderboardModel::sortKey(int row, int column) const
+{
+    const DailyLeaderboardRow &rowData = m_leaderboardData.at(row);
+    if (column == getColumnForDailyTotalPoints()) return rowData.dailyTotalPoints;
+    if (column == getColumnForDailyNetPoints()) return rowData.dailyNetPoints;
+    return column == getColumnForRank() ? row : 0;
+}
 
-    fetchAllPlayers();
-    fetchAllHoleDetails();
-    fetchDailyScores();
+void DailyLeaderboardModel::refreshData()
+{
+    refreshData(TournamentSnapshot::load(m_connectionName, TournamentSnapshot::Detail::RoundTotals));
+}
 
-    calculateLeaderboard();
+void DailyLeaderboardModel::refreshData(const TournamentSnapshot &snapshot)
+{
+    setResult(snapshot, calculate(snapshot, m_dayNum));
+}
 
+void DailyLeaderboardModel::setResult(const TournamentSnapshot &snapshot, const QVector<DailyLeaderboardRow> &rows)
+{
+    beginResetModel();
+    m_snapshot = snapshot;
+    m_leaderboardData = rows;
+    m_displayRows.clear();
+    const int fetchedRows = std::min(FetchBatchSize, static_cast<int>(m_leaderboardData.size()));
+    for (int i = 0; i < fetchedRows; ++i) {
+        m_displayRows.append(displayRow(m_leaderboardData.at(i)));
+    }
     endResetModel();
 }
 
 /**
- * @brief Fetches all active players from the database.
+ * @brief Builds the displayed cells of a leaderboard row.
  */
-void DailyLeaderboardModel::fetchAllPlayers()
+DailyLeaderboardModel::DisplayRow DailyLeaderboardModel::displayRow(const DailyLeaderboardRow &row)
 {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "DailyLeaderboardModel::fetchAllPlayers: ERROR: Invalid or closed database connection.";
-        return;
-    }
+    return { row.rank, row.playerName, row.dailyTotalPoints, row.dailyNetPoints };
+}
 
-    QSqlQuery query(db);
-    if (query.exec("SELECT id, name, handicap FROM players WHERE active = 1")) {
-        while (query.next()) {
-            PlayerInfo player;
-            player.id = query.value("id").toInt();
-            player.name = query.value("name").toString();
-            player.handicap = query.value("handicap").toInt();
-            m_allPlayers[player.id] = player;
-        }
-    } else {
-        qDebug() << "DailyLeaderboardModel::fetchAllPlayers: ERROR executing query:" << query.lastError().text();
+/**
+ * @brief Builds the unranked leaderboard row of a player for a day.
+ * @param snapshot The tournament data.
+ * @param playerRow The player's snapshot row.
+ * @param dayNum The day number.
+ */
+DailyLeaderboardRow DailyLeaderboardModel::buildLeaderboardRow(const TournamentSnapshot &snapshot, int playerRow, int dayNum)
+{
+    const PlayerInfo &playerInfo = snapshot.players().at(playerRow);
+    DailyLeaderboardRow row;
+    row.playerId = playerInfo.id;
+    row.playerName = playerInfo.name;
+    row.rank = 0;
+    row.dailyTotalPoints = snapshot.roundGrossPoints(playerRow, dayNum);
+    row.dailyNetPoints = row.dailyTotalPoints - playerInfo.handicap;
+    return row;
+}
+
+/**
+ * @brief The leaderboard ordering: highest net first, ties broken by name then id.
+ */
+bool DailyLeaderboardModel::ranksAbove(const DailyLeaderboardRow &a, const DailyLeaderboardRow &b)
+{
+    if (a.dailyNetPoints != b.dailyNetPoints) {
+        return a.dailyNetPoints > b.dailyNetPoints;
+    }
+    if (a.playerName != b.playerName) {
+        return a.playerName < b.playerName;
     }
+    return a.playerId < b.playerId;
 }
 
 /**
- * @brief Fetches details (par, handicap) for all holes on all courses.
+ * @brief Calculates the Stableford points and ranks the players for a day.
+ *
+ * This is a pure function of its arguments, so it can run on a worker thread.
+ *
+ * @param snapshot The tournament data.
+ * @param dayNum The day number.
+ * @return The ranked leaderboard rows.
  */
-void DailyLeaderboardModel::fetchAllHoleDetails()
+QVector<DailyLeaderboardRow> DailyLeaderboardModel::calculate(const TournamentSnapshot &snapshot, int dayNum)
 {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "DailyLeaderboardModel::fetchAllHoleDetails: ERROR: Invalid or closed database connection.";
-        return;
+    QVector<DailyLeaderboardRow> rows;
+    const QVector<PlayerInfo> &allPlayers = snapshot.players();
+
+    for (int playerRow = 0; playerRow < allPlayers.size(); ++playerRow) {
+        if (!snapshot.hasRound(playerRow, dayNum)) {
+            continue;
+        }
+        rows.append(buildLeaderboardRow(snapshot, playerRow, dayNum));
     }
 
-    QSqlQuery query(db);
-    if (query.exec("SELECT course_id, hole_num, par, handicap FROM holes ORDER BY course_id, hole_num")) {
-        while (query.next()) {
-            int courseId = query.value("course_id").toInt();
-            int holeNum = query.value("hole_num").toInt();
-            int par = query.value("par").toInt();
-            int handicap = query.value("handicap").toInt();
-            m_allHoleDetails[qMakePair(courseId, holeNum)] = qMakePair(par, handicap);
+    std::sort(rows.begin(), rows.end(), &DailyLeaderboardModel::ranksAbove);
+
+    if (!rows.isEmpty()) {
+        rows[0].rank = 1;
+        for (int i = 1; i < rows.size(); ++i) {
+            if (rows[i].dailyNetPoints == rows[i-1].dailyNetPoints) {
+                rows[i].rank = rows[i-1].rank;
+            } else {
+                rows[i].rank = i + 1;
+            }
         }
-    } else {
-        qDebug() << "DailyLeaderboardModel::fetchAllHoleDetails: ERROR executing query:" << query.lastError().text();
     }
+    return rows;
 }
 
-/**
- * @brief Fetches scores for active players for the specific day of this model.
- */
-void DailyLeaderboardModel::fetchDailyScores()
+void DailyLeaderboardModel::applyScoreChange(const TournamentSnapshot &snapshot, int playerId, int dayNum)
 {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "DailyLeaderboardModel::fetchDailyScores: ERROR: Invalid or closed database connection.";
+    if (snapshot.players().size() != m_snapshot.players().size()) {
+        refreshData(snapshot);
         return;
     }
 
-    QStringList activePlayerIds;
-    for (auto const& [playerId, playerInfo] : m_allPlayers.asKeyValueRange()) {
-        activePlayerIds << QString::number(playerId);
+    const int oldPos = dayNum == m_dayNum ? findLeaderboardRow(playerId) : -1;
+
+    m_snapshot = snapshot;
+    int playerRow = m_snapshot.rowForPlayer(playerId);
+    if (dayNum != m_dayNum || playerRow < 0) {
+        return;
     }
 
-     if (activePlayerIds.isEmpty()) {
-        qDebug() << "DailyLeaderboardModel::fetchDailyScores: No active players to fetch scores for.";
+    if (!m_snapshot.hasRound(playerRow, m_dayNum)) {
+        if (oldPos >= 0) {
+            removeLeaderboardRow(oldPos);
+            updateRanks(oldPos, m_leaderboardData.size() - 1);
+        }
         return;
     }
 
-    QSqlQuery query(db);
-    QString queryString = QString("SELECT player_id, course_id, hole_num, score FROM scores WHERE player_id IN (%1) AND day_num = %2 ORDER BY player_id, hole_num;")
-                          .arg(activePlayerIds.join(",")).arg(m_dayNum);
+    DailyLeaderboardRow row = buildLeaderboardRow(m_snapshot, playerRow, m_dayNum);
+    int insertPos = static_cast<int>(std::lower_bound(m_leaderboardData.cbegin(), m_leaderboardData.cend(), row, &DailyLeaderboardModel::ranksAbove) - m_leaderboardData.cbegin());
 
-    if (query.exec(queryString)) {
-        while (query.next()) {
-            int playerId = query.value("player_id").toInt();
-            int courseId = query.value("course_id").toInt();
-            int holeNum = query.value("hole_num").toInt();
-            int score = query.value("score").toInt();
+    if (oldPos < 0) {
+        insertLeaderboardRow(insertPos, row);
+        updateRanks(insertPos, m_leaderboardData.size() - 1);
+        return;
+    }
 
-            m_dailyScores[playerId][holeNum] = qMakePair(score, courseId);
-        }
+    row.rank = m_leaderboardData.at(oldPos).rank;
+    int newPos = insertPos > oldPos ? insertPos - 1 : insertPos;
+    const int fetchedRows = m_displayRows.size();
+    if (newPos != oldPos && (oldPos >= fetchedRows || newPos >= fetchedRows)) {
+        // The row enters or leaves the fetched rows, or moves among unfetched ones.
+        removeLeaderboardRow(oldPos);
+        insertLeaderboardRow(newPos, row);
     } else {
-        qDebug() << "DailyLeaderboardModel::fetchDailyScores: ERROR executing query:" << query.lastError().text();
+        if (newPos != oldPos) {
+            beginMoveRows(QModelIndex(), oldPos, oldPos, QModelIndex(), insertPos);
+            m_leaderboardData.move(oldPos, newPos);
+            m_displayRows.move(oldPos, newPos);
+            endMoveRows();
+        }
+        m_leaderboardData[newPos] = row;
+        if (newPos < fetchedRows) {
+            m_displayRows[newPos] = displayRow(row);
+            emit dataChanged(index(newPos, 0), index(newPos, columnCount() - 1));
+        }
     }
+    updateRanks(std::min(oldPos, newPos), std::max(oldPos, newPos));
 }
 
 /**
- * @brief Calculates the Stableford points and ranks the players for the day.
+ * @brief Finds a player's current row with a binary search.
+ *
+ * The rows were ranked from m_snapshot, so rebuilding the player's row from
+ * it gives the key the row is sorted by.
+ *
+ * @param playerId The player to find.
+ * @return The player's position, or -1 if the player has no round on this day.
  */
-void DailyLeaderboardModel::calculateLeaderboard()
-{
-    m_leaderboardData.clear();
-
-    for (auto const& [playerId, playerInfo] : m_allPlayers.asKeyValueRange()) {
-        if (m_dailyScores.contains(playerId)) {
-            DailyLeaderboardRow row;
-            row.playerId = playerId;
-            row.playerName = playerInfo.name;
-            row.dailyTotalPoints = 0;
-            row.dailyNetPoints = 0;
-
-            for (auto const& [holeNum, scoreAndCourse] : m_dailyScores[playerId].asKeyValueRange()) {
-                int score = scoreAndCourse.first;
-                int courseIdForScore = scoreAndCourse.second;
-
-                if (m_allHoleDetails.contains(qMakePair(courseIdForScore, holeNum))) {
-                    int par = m_allHoleDetails[qMakePair(courseIdForScore, holeNum)].first;
-                    if (stableford_conversion.contains(score - par)) {
-                        row.dailyTotalPoints += stableford_conversion.at(score - par);
-                    } else {
-                        qDebug() << "Invalid score " << score << "on par " << par << "for " << playerInfo.name;
-                    }
-                } else {
-                     qDebug() << QString("DailyLeaderboardModel::calculateLeaderboard (Day %1): Warning: Hole details not found for Course %2 Hole %3").arg(m_dayNum).arg(courseIdForScore).arg(holeNum);
-                }
-            }
-
-            row.dailyNetPoints = row.dailyTotalPoints - playerInfo.handicap;
-            m_leaderboardData.append(row);
-        }
+int DailyLeaderboardModel::findLeaderboardRow(int playerId) const
+{
+    const int playerRow = m_snapshot.rowForPlayer(playerId);
+    if (!m_snapshot.hasRound(playerRow, m_dayNum)) {
+        return -1;
     }
+    const DailyLeaderboardRow key = buildLeaderboardRow(m_snapshot, playerRow, m_dayNum);
+    auto it = std::lower_bound(m_leaderboardData.cbegin(), m_leaderboardData.cend(), key, &DailyLeaderboardModel::ranksAbove);
+    return it != m_leaderboardData.cend() && it->playerId == playerId ? static_cast<int>(it - m_leaderboardData.cbegin()) : -1;
+}
 
-    std::sort(m_leaderboardData.begin(), m_leaderboardData.end(),
-              [](const DailyLeaderboardRow& a, const DailyLeaderboardRow& b) {
-                  return a.dailyNetPoints > b.dailyNetPoints;
-              });
+/**
+ * @brief Inserts a ranked row, showing it only if it falls among the fetched rows.
+ * @param pos The position in the full ranking.
+ * @param row The row to insert.
+ */
+void DailyLeaderboardModel::insertLeaderboardRow(int pos, const DailyLeaderboardRow &row)
+{
+    if (pos < m_displayRows.size() || !canFetchMore(QModelIndex())) {
+        beginInsertRows(QModelIndex(), pos, pos);
+        m_leaderboardData.insert(pos, row);
+        m_displayRows.insert(pos, displayRow(row));
+        endInsertRows();
+    } else {
+        m_leaderboardData.insert(pos, row);
+    }
+}
 
-    if (!m_leaderboardData.isEmpty()) {
-        m_leaderboardData[0].rank = 1;
-        for (int i = 1; i < m_leaderboardData.size(); ++i) {
-            if (m_leaderboardData[i].dailyNetPoints == m_leaderboardData[i-1].dailyNetPoints) {
-                m_leaderboardData[i].rank = m_leaderboardData[i-1].rank;
-            } else {
-                m_leaderboardData[i].rank = i + 1;
-            }
-        }
+/**
+ * @brief Removes a ranked row, and from the views if it was fetched.
+ * @param pos The position in the full ranking.
+ */
+void DailyLeaderboardModel::removeLeaderboardRow(int pos)
+{
+    if (pos < m_displayRows.size()) {
+        beginRemoveRows(QModelIndex(), pos, pos);
+        m_leaderboardData.removeAt(pos);
+        m_displayRows.removeAt(pos);
+        endRemoveRows();
+    } else {
+        m_leaderboardData.removeAt(pos);
     }
 }
 
-const DailyLeaderboardRow* DailyLeaderboardModel::getLeaderboardRow(int row) const
+/**
+ * @brief Recalculates ranks from @p first, stopping at the first unchanged rank past @p last.
+ *
+ * Stopping early is only safe when no row after @p last changed position, as
+ * after a move; an insert or remove must pass the last row.
+ *
+ * @param first The first position whose row changed or moved.
+ * @param last The last position whose row changed or moved.
+ */
+void DailyLeaderboardModel::updateRanks(int first, int last)
 {
-    if (row >= 0 && row < m_leaderboardData.size()) {
-        return &m_leaderboardData.at(row);
+    int firstChanged = -1;
+    int lastChanged = -1;
+    for (int i = std::max(first, 0); i < m_leaderboardData.size(); ++i) {
+        int rank = i + 1;
+        if (i > 0 && m_leaderboardData.at(i).dailyNetPoints == m_leaderboardData.at(i - 1).dailyNetPoints) {
+            rank = m_leaderboardData.at(i - 1).rank;
+        }
+        if (rank == m_leaderboardData.at(i).rank) {
+            if (i > last) break;
+            continue;
+        }
+        m_leaderboardData[i].rank = rank;
+        if (i < m_displayRows.size()) {
+            m_displayRows[i][getColumnForRank()] = rank;
+            if (firstChanged < 0) firstChanged = i;
+            lastChanged = i;
+        }
+    }
+
+    if (firstChanged >= 0) {
+        emit dataChanged(index(firstChanged, getColumnForRank()), index(lastChanged, getColumnForRank()), {Qt::DisplayRole});
     }
-    return nullptr;
 }
@@ -14,8 +14,12 @@
 #include <QMap>
 #include <QPair>
 #include <QDebug>
+#include <array>
 
 #include "CommonStructs.h"
+#include "TournamentSnapshot.h"
+#include "ChangeTracker.h"
+#include "LeaderboardProxyModel.h"
 
 /**
  * @struct DailyLeaderboardRow
@@ -34,13 +38,19 @@ struct DailyLeaderboardRow {
  * @brief A model for calculating and displaying a daily leaderboard.
  *
  * This model fetches player scores for a specific day, calculates Stableford points,
- * ranks the players, and provides the data to a view.
+ * ranks the players, and provides the data to a view. Like
+ * TournamentLeaderboardModel, it hands the ranked rows to views in batches
+ * through fetchMore() and builds the displayed cells of a row when it is
+ * fetched, so data() only indexes into an array.
  */
-class DailyLeaderboardModel : public QAbstractTableModel
+class DailyLeaderboardModel : public QAbstractTableModel, public LeaderboardSortKeys
 {
     Q_OBJECT
 
 public:
+    static constexpr int ColumnCount = 4; ///< Rank, player name, daily total points and daily net points.
+    static constexpr int FetchBatchSize = 256; ///< Rows handed to views per fetchMore().
+
     /**
      * @brief Constructs a DailyLeaderboardModel object.
      * @param connectionName The name of the database connection to use.
@@ -59,6 +69,13 @@ public:
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    // LeaderboardSortKeys overrides
+    int sortKey(int row, int column) const override;
+    const QString &rowName(int row) const override { return m_leaderboardData.at(row).playerName; }
+    int nameColumn() const override { return getColumnForPlayerName(); }
 
     /**
      * @brief Refreshes the data and recalculates the leaderboard.
@@ -68,6 +85,44 @@ public:
      */
     void refreshData();
 
+    /**
+     * @brief Recalculates the leaderboard from an already loaded snapshot.
+     * @param snapshot The tournament data shared with the other leaderboard models.
+     */
+    void refreshData(const TournamentSnapshot &snapshot);
+
+    /**
+     * @brief Updates one player's row after a single score change.
+     *
+     * Recalculates only that player's points for the day and moves the row to its
+     * new rank, emitting targeted row and dataChanged signals instead of a reset.
+     *
+     * @param snapshot The snapshot with the change applied.
+     * @param playerId The player whose score changed.
+     * @param dayNum The day the score was entered for.
+     */
+    void applyScoreChange(const TournamentSnapshot &snapshot, int playerId, int dayNum);
+
+    /**
+     * @brief Calculates the ranked rows for a day without touching any model.
+     * @param snapshot The tournament data.
+     * @param dayNum The day number.
+     * @return The ranked leaderboard rows.
+     */
+    static QVector<DailyLeaderboardRow> calculate(const TournamentSnapshot &snapshot, int dayNum);
+
+    /**
+     * @brief Gets the tables whose changes affect the daily leaderboards.
+     */
+    static ChangeTracker::Tables dependencies() { return ChangeTracker::Players | ChangeTracker::Courses | ChangeTracker::Holes | ChangeTracker::Scores | ChangeTracker::Events; }
+
+    /**
+     * @brief Swaps rows returned by calculate() into the model.
+     * @param snapshot The snapshot the rows were calculated from.
+     * @param rows The ranked leaderboard rows.
+     */
+    void setResult(const TournamentSnapshot &snapshot, const QVector<DailyLeaderboardRow> &rows);
+
     /**
      * @brief Gets the day number this model represents.
      * @return The day number.
@@ -84,33 +139,23 @@ public:
     int getColumnForDailyNetPoints() const { return 3; }
 
 private:
+    using DisplayRow = std::array<QVariant, ColumnCount>; ///< The DisplayRole value of each column.
+
     QString m_connectionName; ///< The name of the database connection.
     int m_dayNum;             ///< The day number this model represents (1, 2, or 3).
-    QVector<DailyLeaderboardRow> m_leaderboardData; ///< Stores the calculated leaderboard rows.
-
-    // Internal data structures for calculations
-    QMap<int, PlayerInfo> m_allPlayers; ///< Map of PlayerId to PlayerInfo for all active players.
-    QMap<QPair<int, int>, QPair<int, int>> m_allHoleDetails; ///< Map of <CourseId, HoleNum> to <Par, Handicap>.
-    QMap<int, QMap<int, QPair<int, int>>> m_dailyScores; ///< Map of PlayerId to a map of <HoleNum, <Score, CourseId>>.
-
-    /**
-     * @brief Gets the database connection by name.
-     * @return The QSqlDatabase object.
-     */
-    QSqlDatabase database() const;
-
-    // Private helper methods for data fetching and calculation
-    void fetchAllPlayers();
-    void fetchAllHoleDetails();
-    void fetchDailyScores();
-    void calculateLeaderboard();
-
-    /**
-     * @brief Gets the leaderboard row data for a given row index.
-     * @param row The row index.
-     * @return A pointer to the DailyLeaderboardRow, or nullptr if the index is invalid.
-     */
-    const DailyLeaderboardRow* getLeaderboardRow(int row) const;
+    QVector<DailyLeaderboardRow> m_leaderboardData; ///< Stores every ranked row, fetched or not.
+    QVector<DisplayRow> m_displayRows;              ///< The displayed cells of the fetched rows, the first of m_leaderboardData.
+    DisplayRow m_headers;                           ///< The column headers, which name the day.
+
+    TournamentSnapshot m_snapshot; ///< The tournament data the leaderboard was calculated from.
+
+    static DailyLeaderboardRow buildLeaderboardRow(const TournamentSnapshot &snapshot, int playerRow, int dayNum);
+    static bool ranksAbove(const DailyLeaderboardRow &a, const DailyLeaderboardRow &b);
+    static DisplayRow displayRow(const DailyLeaderboardRow &row);
+    int findLeaderboardRow(int playerId) const;
+    void updateRanks(int first, int last);
+    void insertLeaderboardRow(int pos, const DailyLeaderboardRow &row);
+    void removeLeaderboardRow(int pos);
 };
 
 #endif // DAILYLEADERBOARDMODEL_H
@@ -11,6 +11,7 @@
 #include <QTableView>
 #include <QVBoxLayout>
 #include <QHeaderView>
+#include <QLineEdit>
 #include <QPainter>
 #include <QPixmap>
 #include <QImage>
@@ -19,6 +20,8 @@
 #include <QDir>
 
 #include "dailyleaderboardmodel.h"
+#include "LeaderboardProxyModel.h"
+#include "LeaderboardImageExporter.h"
 
 /**
  * @class DailyLeaderboardWidget
@@ -54,17 +57,40 @@ public:
     void refreshData();
 
     /**
-     * @brief Exports the leaderboard as an image.
-     * @return The leaderboard rendered as a QImage.
+     * @brief Refreshes the leaderboard from an already loaded snapshot.
+     * @param snapshot The tournament data shared with the other leaderboards.
      */
-    QImage exportToImage() const;
+    void refreshData(const TournamentSnapshot &snapshot);
+
+    /**
+     * @brief Applies a single score change without resetting the view.
+     * @param snapshot The snapshot with the change applied.
+     * @param playerId The player whose score changed.
+     * @param dayNum The day the score was entered for.
+     */
+    void applyScoreChange(const TournamentSnapshot &snapshot, int playerId, int dayNum);
+
+    /**
+     * @brief Shows rows calculated on a worker thread.
+     * @param snapshot The snapshot the rows were calculated from.
+     * @param rows The ranked leaderboard rows.
+     */
+    void setResult(const TournamentSnapshot &snapshot, const QVector<DailyLeaderboardRow> &rows);
+
+    /**
+     * @brief Gets an exporter that renders the leaderboard as fixed-size pages.
+     * @return An exporter reading this widget's model.
+     */
+    LeaderboardImageExporter imageExporter() const;
 
 private:
     QString m_connectionName; ///< The name of the database connection.
     int m_dayNum;             ///< The day number this widget represents.
 
     DailyLeaderboardModel *leaderboardModel; ///< The model for this leaderboard.
+    LeaderboardProxyModel *proxyModel; ///< Searches and sorts the leaderboard for the view.
     QTableView *leaderboardView; ///< The view to display this leaderboard.
+    QLineEdit *searchEdit;       ///< Filters the view by player name.
 
     /**
      * @brief Gets the database connection by name.
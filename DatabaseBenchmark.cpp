@@ -0,0 +1,186 @@
+/**
+ * @file DatabaseBenchmark.cpp
+ * @brief Implements the database profile benchmark.
+ */
+
+#include "DatabaseBenchmark.h"
+#include "DatabaseManager.h"
+#include "TournamentRepository.h"
+#include "TournamentSnapshot.h"
+#include "SchemaMigrator.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDebug>
+
+namespace DatabaseBenchmark {
+
+namespace {
+
+constexpr int SnapshotRepetitions = 5;  ///< Snapshot loads averaged per profile.
+constexpr int ScoreWrites = 200;        ///< Scores saved by each write test.
+
+struct ProfileResult {
+    double openMs = 0;
+    double snapshotMs = 0;
+    double roundTotalsMs = 0;
+    double autocommitMs = 0;
+    double transactionMs = 0;
+    DatabaseManager::ConnectionStats stats;
+};
+
+double elapsedMs(const QElapsedTimer &timer)
+{
+    return timer.nsecsElapsed() / 1e6;
+}
+
+/**
+ * @brief Saves ScoreWrites scores, cycling through the holes and days of one player.
+ */
+bool writeScores(TournamentRepository &repository, int playerId, int courseId, int scoreOffset)
+{
+    for (int i = 0; i < ScoreWrites; ++i) {
+        int holeNum = i % 18 + 1;
+        int dayNum = i / 18 % 3 + 1;
+        if (!repository.saveScore(playerId, courseId, holeNum, dayNum, 3 + (i + scoreOffset) % 4)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool runProfile(const QString &path, DatabaseManager::Profile profile, ProfileResult *result)
+{
+    const QString connectionName = "benchmark_" + DatabaseManager::profileName(profile);
+    bool ok = true;
+    {
+        QElapsedTimer timer;
+        timer.start();
+        QSqlDatabase db = DatabaseManager::open(connectionName, path, profile);
+        result->openMs = elapsedMs(timer);
+        if (!db.isOpen()) {
+            ok = false;
+        } else {
+            timer.restart();
+            for (int i = 0; i < SnapshotRepetitions; ++i) {
+                TournamentSnapshot::load(connectionName);
+            }
+            result->snapshotMs = elapsedMs(timer) / SnapshotRepetitions;
+
+            timer.restart();
+            for (int i = 0; i < SnapshotRepetitions; ++i) {
+                TournamentSnapshot::load(connectionName, TournamentSnapshot::Detail::RoundTotals);
+            }
+            result->roundTotalsMs = elapsedMs(timer) / SnapshotRepetitions;
+
+            int playerId = 1;
+            int courseId = 1;
+            QSqlQuery query(db);
+            if (query.exec("SELECT (SELECT MIN(id) FROM players), (SELECT MIN(id) FROM courses)") && query.next()) {
+                playerId = query.value(0).isNull() ? 1 : query.value(0).toInt();
+                courseId = query.value(1).isNull() ? 1 : query.value(1).toInt();
+            }
+            query.finish();
+
+            TournamentRepository &repository = TournamentRepository::forConnection(connectionName);
+            timer.restart();
+            ok = writeScores(repository, playerId, courseId, 0);
+            result->autocommitMs = elapsedMs(timer);
+
+            timer.restart();
+            ok = ok && db.transaction();
+            ok = ok && writeScores(repository, playerId, courseId, 1);
+            ok = ok && db.commit();
+            result->transactionMs = elapsedMs(timer);
+            if (!ok) {
+                qWarning() << "DatabaseBenchmark: Write test failed for" << connectionName << ":" << repository.lastError() << db.lastError().text();
+            }
+
+            result->stats = DatabaseManager::statistics(connectionName);
+        }
+    }
+    DatabaseManager::close(connectionName);
+    return ok;
+}
+
+/**
+ * @brief Copies the database and brings the copy to the current schema.
+ *
+ * The snapshot and repository queries need the current_event view and the
+ * round_summaries table, so an old database must be migrated before it is timed.
+ */
+bool prepareSource(const QString &databasePath, const QString &sourcePath, QString *error)
+{
+    if (!QFile::copy(databasePath, sourcePath)) {
+        *error = QStringLiteral("could not copy the database.");
+        return false;
+    }
+
+    const QString connectionName = QStringLiteral("benchmark_migrate");
+    bool migrated = false;
+    {
+        QSqlDatabase db = DatabaseManager::open(connectionName, sourcePath, DatabaseManager::Profile::Safe);
+        if (!db.isOpen()) {
+            *error = db.lastError().text();
+        } else {
+            migrated = SchemaMigrator::migrate(db, error);
+        }
+    }
+    DatabaseManager::close(connectionName);
+    return migrated;
+}
+
+} // namespace
+
+int run(const QString &databasePath, QTextStream &out)
+{
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid() || !QFile::exists(databasePath)) {
+        out << "Cannot benchmark " << databasePath << ": the database or a temporary directory is unavailable.\n";
+        return 1;
+    }
+
+    // Every profile starts from the same migrated copy.
+    const QString sourcePath = tempDir.filePath("source.db");
+    QString error;
+    if (!prepareSource(databasePath, sourcePath, &error)) {
+        out << "Cannot benchmark " << databasePath << ": " << error << "\n";
+        return 1;
+    }
+
+    out << "Database profile benchmark on " << databasePath << "\n"
+        << "Snapshot loads are averaged over " << SnapshotRepetitions << " runs; write tests save "
+        << ScoreWrites << " scores.\n\n";
+    out << qSetFieldWidth(12) << Qt::left << "profile" << Qt::right
+        << "open ms" << "holes ms" << "totals ms" << "autocommit" << "one txn"
+        << "stmts" << "cache hit" << "cache miss" << qSetFieldWidth(0) << "\n";
+    out << qSetRealNumberPrecision(2) << Qt::fixed;
+
+    int exitCode = 0;
+    const QList<DatabaseManager::Profile> profiles = { DatabaseManager::Profile::Safe, DatabaseManager::Profile::Balanced, DatabaseManager::Profile::Fast };
+    for (DatabaseManager::Profile profile : profiles) {
+        const QString name = DatabaseManager::profileName(profile);
+        const QString copyPath = tempDir.filePath(name + ".db");
+        if (!QFile::copy(sourcePath, copyPath)) {
+            out << name << ": could not copy the database.\n";
+            exitCode = 1;
+            continue;
+        }
+
+        ProfileResult result;
+        if (!runProfile(copyPath, profile, &result)) {
+            exitCode = 1;
+        }
+        out << qSetFieldWidth(12) << Qt::left << name << Qt::right
+            << result.openMs << result.snapshotMs << result.roundTotalsMs
+            << result.autocommitMs << result.transactionMs
+            << result.stats.statementCount << result.stats.cacheHits << result.stats.cacheMisses
+            << qSetFieldWidth(0) << "\n";
+    }
+    out.flush();
+    return exitCode;
+}
+
+} // namespace DatabaseBenchmark
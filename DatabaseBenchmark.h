@@ -0,0 +1,36 @@
+/**
+ * @file DatabaseBenchmark.h
+ * @brief Contains the declaration of the database profile benchmark.
+ */
+
+#ifndef DATABASEBENCHMARK_H
+#define DATABASEBENCHMARK_H
+
+#include <QString>
+#include <QTextStream>
+
+/**
+ * @namespace DatabaseBenchmark
+ * @brief Compares the DatabaseManager profiles on a copy of a real database.
+ */
+namespace DatabaseBenchmark {
+
+/**
+ * @brief Runs the benchmark for every profile and prints a table of timings.
+ *
+ * Each profile works on its own temporary copy of the database, migrated to
+ * the current schema before anything is timed, so the source file is never
+ * modified. For each profile the benchmark measures opening a
+ * connection, loading the leaderboard snapshot with hole scores and with round
+ * totals, saving scores one autocommit statement at a time, and saving the same
+ * number of scores in one transaction.
+ *
+ * @param databasePath The database to copy.
+ * @param out Receives the results.
+ * @return 0 on success, 1 if the database could not be copied, migrated or opened.
+ */
+int run(const QString &databasePath, QTextStream &out);
+
+} // namespace DatabaseBenchmark
+
+#endif // DATABASEBENCHMARK_H
@@ -0,0 +1,245 @@
+/**
+ * @file DatabaseManager.cpp
+ * @brief Implements the DatabaseManager class.
+ */
+
+#include "DatabaseManager.h"
+#include "TournamentRepository.h"
+#include "SqliteFunctions.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QDebug>
+#include <atomic>
+#include <memory>
+
+#ifdef MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+#include <sqlite3.h>
+#endif
+
+namespace {
+
+struct ConnectionRecord {
+    qint64 openNsecs = -1;
+    // Counted by the SQLite trace callback of the connection.
+    std::shared_ptr<std::atomic<qint64>> statementCount;
+};
+
+struct ManagerState {
+    QMutex mutex;
+    QString databasePath;
+    DatabaseManager::Profile profile = DatabaseManager::Profile::Balanced;
+    QHash<QString, ConnectionRecord> connections;
+};
+
+ManagerState &state()
+{
+    static ManagerState managerState;
+    return managerState;
+}
+
+#ifdef MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+
+int countStatement(unsigned type, void *context, void *statement, void *sql)
+{
+    Q_UNUSED(type);
+    Q_UNUSED(statement);
+    Q_UNUSED(sql);
+    static_cast<std::atomic<qint64> *>(context)->fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+#endif
+
+/**
+ * @brief Applies the PRAGMAs of a profile to an open connection.
+ */
+void applyProfile(QSqlDatabase &db, const DatabaseManager::ProfileSettings &settings, DatabaseManager::Access access)
+{
+    QStringList pragmas;
+    // The journal mode is stored in the database file; read-only connections cannot change it.
+    if (access == DatabaseManager::Access::ReadWrite) {
+        pragmas << QString("PRAGMA journal_mode = %1").arg(settings.journalMode);
+    }
+    pragmas << QString("PRAGMA synchronous = %1").arg(settings.synchronous)
+            << QString("PRAGMA cache_size = %1").arg(-settings.cacheSizeKiB)
+            << QString("PRAGMA mmap_size = %1").arg(settings.mmapSize)
+            << QString("PRAGMA temp_store = %1").arg(settings.tempStore)
+            << QString("PRAGMA busy_timeout = %1").arg(settings.busyTimeout);
+
+    QSqlQuery query(db);
+    for (const QString &pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            qWarning() << "DatabaseManager: Failed to apply" << pragma << "on" << db.connectionName() << ":" << query.lastError().text();
+        }
+        query.finish();
+    }
+}
+
+} // namespace
+
+void DatabaseManager::setDatabasePath(const QString &path)
+{
+    QMutexLocker locker(&state().mutex);
+    state().databasePath = path;
+}
+
+QString DatabaseManager::databasePath()
+{
+    QMutexLocker locker(&state().mutex);
+    return state().databasePath;
+}
+
+void DatabaseManager::setProfile(Profile profile)
+{
+    QMutexLocker locker(&state().mutex);
+    state().profile = profile;
+}
+
+DatabaseManager::Profile DatabaseManager::profile()
+{
+    QMutexLocker locker(&state().mutex);
+    return state().profile;
+}
+
+DatabaseManager::ProfileSettings DatabaseManager::settings(Profile profile)
+{
+    switch (profile) {
+    case Profile::Safe:
+        return { "DELETE", "FULL", 2000, 0, "DEFAULT", 5000 };
+    case Profile::Balanced:
+        return { "WAL", "NORMAL", 16384, 64ll * 1024 * 1024, "MEMORY", 5000 };
+    case Profile::Fast:
+        return { "WAL", "OFF", 65536, 256ll * 1024 * 1024, "MEMORY", 5000 };
+    }
+    return settings(Profile::Balanced);
+}
+
+QString DatabaseManager::profileName(Profile profile)
+{
+    switch (profile) {
+    case Profile::Safe: return QStringLiteral("safe");
+    case Profile::Balanced: return QStringLiteral("balanced");
+    case Profile::Fast: return QStringLiteral("fast");
+    }
+    return QString();
+}
+
+QStringList DatabaseManager::profileNames()
+{
+    return { profileName(Profile::Safe), profileName(Profile::Balanced), profileName(Profile::Fast) };
+}
+
+bool DatabaseManager::profileFromName(const QString &name, Profile *profile)
+{
+    for (Profile candidate : { Profile::Safe, Profile::Balanced, Profile::Fast }) {
+        if (name.compare(profileName(candidate), Qt::CaseInsensitive) == 0) {
+            *profile = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+QSqlDatabase DatabaseManager::open(const QString &connectionName, Access access)
+{
+    return open(connectionName, databasePath(), profile(), access);
+}
+
+QSqlDatabase DatabaseManager::open(const QString &connectionName, const QString &path, Profile profile, Access access)
+{
+    const ProfileSettings profileSettings = settings(profile);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(path);
+    QString options = QString("QSQLITE_BUSY_TIMEOUT=%1").arg(profileSettings.busyTimeout);
+    if (access == Access::ReadOnly) {
+        options.prepend("QSQLITE_OPEN_READONLY;");
+    }
+    db.setConnectOptions(options);
+
+    if (!db.open()) {
+        qDebug() << "DatabaseManager::open: ERROR opening" << connectionName << ":" << db.lastError().text();
+        return db;
+    }
+    applyProfile(db, profileSettings, access);
+
+    ConnectionRecord record;
+    record.statementCount = std::make_shared<std::atomic<qint64>>(0);
+#ifdef MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+    if (sqlite3 *handle = SqliteFunctions::nativeHandle(db)) {
+        sqlite3_trace_v2(handle, SQLITE_TRACE_STMT, &countStatement, record.statementCount.get());
+    }
+#endif
+    record.openNsecs = timer.nsecsElapsed();
+
+    QMutexLocker locker(&state().mutex);
+    state().connections.insert(connectionName, record);
+    return db;
+}
+
+void DatabaseManager::close(const QString &connectionName)
+{
+    TournamentRepository::release(connectionName);
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        if (db.isOpen()) {
+#ifdef MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+            if (sqlite3 *handle = SqliteFunctions::nativeHandle(db)) {
+                sqlite3_trace_v2(handle, 0, nullptr, nullptr);
+            }
+#endif
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    QMutexLocker locker(&state().mutex);
+    state().connections.remove(connectionName);
+}
+
+DatabaseManager::ConnectionStats DatabaseManager::statistics(const QString &connectionName)
+{
+    ConnectionStats stats;
+    stats.connectionName = connectionName;
+
+    ConnectionRecord record;
+    {
+        QMutexLocker locker(&state().mutex);
+        record = state().connections.value(connectionName);
+    }
+    stats.openNsecs = record.openNsecs;
+
+#ifdef MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+    if (record.statementCount) {
+        stats.statementCount = record.statementCount->load(std::memory_order_relaxed);
+    }
+    if (sqlite3 *handle = SqliteFunctions::nativeHandle(QSqlDatabase::database(connectionName, false))) {
+        int current = 0;
+        int highwater = 0;
+        if (sqlite3_db_status(handle, SQLITE_DBSTATUS_CACHE_HIT, &current, &highwater, 0) == SQLITE_OK) {
+            stats.cacheHits = current;
+        }
+        if (sqlite3_db_status(handle, SQLITE_DBSTATUS_CACHE_MISS, &current, &highwater, 0) == SQLITE_OK) {
+            stats.cacheMisses = current;
+        }
+    }
+#endif
+    return stats;
+}
+
+void DatabaseManager::logStatistics(const QString &connectionName)
+{
+    const ConnectionStats stats = statistics(connectionName);
+    qDebug() << "DatabaseManager:" << stats.connectionName
+             << "open ms:" << stats.openNsecs / 1e6
+             << "statements:" << stats.statementCount
+             << "cache hits:" << stats.cacheHits
+             << "cache misses:" << stats.cacheMisses;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file DatabaseManager.h
+ * @brief Contains the declaration of the DatabaseManager class.
+ */
+
+#ifndef DATABASEMANAGER_H
+#define DATABASEMANAGER_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @class DatabaseManager
+ * @brief Creates and closes every connection to the tournament database.
+ *
+ * All connections, including the ones worker threads open for themselves, are
+ * opened through open() so they share the same database file and performance
+ * profile. A QSqlDatabase connection may only be used by the thread that
+ * opened it; each thread opens its own under a unique name and closes it
+ * with close() when done.
+ */
+class DatabaseManager
+{
+public:
+    /**
+     * @enum Profile
+     * @brief Sets of SQLite settings trading durability for speed.
+     */
+    enum class Profile {
+        Safe,       ///< SQLite's defaults: rollback journal, full fsync on every commit.
+        Balanced,   ///< WAL journal, fsync at checkpoints, larger page cache and memory mapping.
+        Fast        ///< As Balanced, but never fsyncs. A power cut can lose recent commits.
+    };
+
+    /**
+     * @enum Access
+     * @brief How a connection may use the database.
+     */
+    enum class Access {
+        ReadWrite,  ///< The connection may read and write.
+        ReadOnly    ///< The connection only reads; used by worker threads.
+    };
+
+    /**
+     * @struct ProfileSettings
+     * @brief The SQLite settings applied for a profile.
+     */
+    struct ProfileSettings {
+        QString journalMode;    ///< PRAGMA journal_mode.
+        QString synchronous;    ///< PRAGMA synchronous.
+        int cacheSizeKiB;       ///< The page cache size in KiB (PRAGMA cache_size = -cacheSizeKiB).
+        qint64 mmapSize;        ///< PRAGMA mmap_size in bytes.
+        QString tempStore;      ///< PRAGMA temp_store.
+        int busyTimeout;        ///< How long to wait for a lock, in milliseconds.
+    };
+
+    /**
+     * @struct ConnectionStats
+     * @brief Statistics of one connection. Counters are -1 when SQLite cannot report them.
+     */
+    struct ConnectionStats {
+        QString connectionName;     ///< The name of the connection.
+        qint64 openNsecs = -1;      ///< The time taken to open and configure the connection.
+        qint64 statementCount = -1; ///< The number of statements the connection has run.
+        qint64 cacheHits = -1;      ///< Page cache hits.
+        qint64 cacheMisses = -1;    ///< Page cache misses.
+    };
+
+    /**
+     * @brief Sets the database file that connections open.
+     */
+    static void setDatabasePath(const QString &path);
+
+    /**
+     * @brief Gets the database file that connections open.
+     */
+    static QString databasePath();
+
+    /**
+     * @brief Selects the profile applied to connections opened from now on.
+     */
+    static void setProfile(Profile profile);
+
+    /**
+     * @brief Gets the profile applied to new connections.
+     */
+    static Profile profile();
+
+    /**
+     * @brief Gets the settings of a profile.
+     */
+    static ProfileSettings settings(Profile profile);
+
+    /**
+     * @brief Gets the command-line name of a profile.
+     */
+    static QString profileName(Profile profile);
+
+    /**
+     * @brief Gets the command-line names of all profiles.
+     */
+    static QStringList profileNames();
+
+    /**
+     * @brief Finds a profile by its command-line name.
+     * @param name The name, case-insensitive.
+     * @param profile Receives the profile if the name is known.
+     * @return True if the name is known.
+     */
+    static bool profileFromName(const QString &name, Profile *profile);
+
+    /**
+     * @brief Opens a connection on the calling thread and applies the current profile.
+     * @param connectionName The name of the new connection.
+     * @param access Whether the connection may write.
+     * @return The connection; check isOpen() and lastError() for failure.
+     */
+    static QSqlDatabase open(const QString &connectionName, Access access = Access::ReadWrite);
+
+    /**
+     * @brief Opens a connection to any database file with a given profile.
+     *
+     * Used by the benchmark to compare profiles; the current profile and path are unchanged.
+     */
+    static QSqlDatabase open(const QString &connectionName, const QString &path, Profile profile, Access access = Access::ReadWrite);
+
+    /**
+     * @brief Closes and removes a connection, releasing its prepared statements first.
+     *
+     * Every QSqlDatabase copy of the connection must have gone out of scope.
+     */
+    static void close(const QString &connectionName);
+
+    /**
+     * @brief Gets the statistics of a connection. Call on the thread that opened it.
+     */
+    static ConnectionStats statistics(const QString &connectionName);
+
+    /**
+     * @brief Writes the statistics of a connection to the debug output.
+     */
+    static void logStatistics(const QString &connectionName);
+};
+
+#endif // DATABASEMANAGER_H
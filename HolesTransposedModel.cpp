@@ -4,6 +4,7 @@
  */
 
 #include "HolesTransposedModel.h"
+#include "TournamentRepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
@@ -229,15 +230,9 @@ bool HolesTransposedModel::setData(const QModelIndex &index, const QVariant &val
 
             QSqlDatabase db = database();
             if (db.isValid() && db.isOpen()) {
-                QSqlQuery query(db);
-                query.prepare("UPDATE holes SET par = :par, handicap = :hc WHERE course_id = :cid AND hole_num = :hnum;");
-                query.bindValue(":par", hole->par);
-                query.bindValue(":hc", hole->handicap);
-                query.bindValue(":cid", m_currentCourseId);
-                query.bindValue(":hnum", hole->holeNum);
-
-                if (!query.exec()) {
-                     qDebug() << "HolesTransposedModel::setData: ERROR updating database:" << query.lastError().text();
+                TournamentRepository &repository = TournamentRepository::forConnection(m_connectionName);
+                if (!repository.updateHole(m_currentCourseId, hole->holeNum, hole->par, hole->handicap)) {
+                     qDebug() << "HolesTransposedModel::setData: ERROR updating database:" << repository.lastError();
                      return false;
                 }
             } else {
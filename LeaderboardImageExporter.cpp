@@ -0,0 +1,223 @@
+/**
+ * @file LeaderboardImageExporter.cpp
+ * @brief Implements the LeaderboardImageExporter class.
+ */
+
+#include "LeaderboardImageExporter.h"
+#include <QAbstractItemModel>
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QDir>
+#include <QImage>
+#include <QImageWriter>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QPageSize>
+#include <QDebug>
+#include <algorithm>
+#include <climits>
+
+namespace {
+Qt::Alignment alignmentOf(const QVariant &value)
+{
+    return value.isValid() ? Qt::Alignment(value.toInt()) : Qt::Alignment(Qt::AlignCenter);
+}
+
+void setError(QString *error, const QString &message)
+{
+    qDebug() << "LeaderboardImageExporter: ERROR:" << message;
+    if (error) {
+        *error = message;
+    }
+}
+}
+
+LeaderboardImageExporter::LeaderboardImageExporter(QAbstractItemModel *model, const Layout &layout)
+    : m_model(model), m_layout(layout)
+{
+    m_layout.rowsPerPage = std::max(1, m_layout.rowsPerPage);
+}
+
+int LeaderboardImageExporter::pageWidth() const
+{
+    int width = m_layout.padding * 2;
+    for (const Column &column : m_layout.columns) {
+        width += column.width;
+    }
+    return width;
+}
+
+QSize LeaderboardImageExporter::pageSize() const
+{
+    return QSize(pageWidth(), m_layout.padding * 2 + m_layout.titleHeight + m_layout.headerHeight +
+                              m_layout.rowsPerPage * m_layout.rowHeight);
+}
+
+/**
+ * @brief Fetches rows until the model has at least @p rows or holds none back.
+ * @return The rows the model now has.
+ */
+int LeaderboardImageExporter::fetchRows(int rows)
+{
+    while (m_model->rowCount() < rows && m_model->canFetchMore(QModelIndex())) {
+        m_model->fetchMore(QModelIndex());
+    }
+    return m_model->rowCount();
+}
+
+int LeaderboardImageExporter::pageCount()
+{
+    const int rows = fetchRows(INT_MAX);
+    return std::max(1, (rows + m_layout.rowsPerPage - 1) / m_layout.rowsPerPage);
+}
+
+bool LeaderboardImageExporter::exportImages(const QString &filePath, QStringList *writtenFiles, QString *error)
+{
+    const int pages = pageCount();
+    const int rows = m_model->rowCount();
+    if (rows == 0 || m_layout.columns.isEmpty()) {
+        setError(error, QCoreApplication::translate("LeaderboardImageExporter", "There is no data to export."));
+        return false;
+    }
+
+    const QFileInfo info(filePath);
+    const QString suffix = info.suffix().isEmpty() ? QStringLiteral("png") : info.suffix();
+    QImage buffer(pageSize(), QImage::Format_ARGB32);
+    if (buffer.isNull()) {
+        setError(error, QCoreApplication::translate("LeaderboardImageExporter", "Not enough memory for a page of %1 rows.").arg(m_layout.rowsPerPage));
+        return false;
+    }
+
+    for (int page = 0; page < pages; ++page) {
+        const int firstRow = page * m_layout.rowsPerPage;
+        const int pageRows = std::min(m_layout.rowsPerPage, rows - firstRow);
+
+        buffer.fill(Qt::white);
+        QPainter painter(&buffer);
+        paintPage(painter, page, firstRow, pageRows, pages);
+        painter.end();
+
+        const QString pagePath = pages == 1 ? filePath
+            : info.dir().filePath(QString("%1_p%2.%3").arg(info.completeBaseName()).arg(page + 1, 3, 10, QChar('0')).arg(suffix));
+        const int usedHeight = m_layout.padding * 2 + m_layout.titleHeight + m_layout.headerHeight + pageRows * m_layout.rowHeight;
+        QImageWriter writer(pagePath, suffix.toLatin1());
+        const bool written = pageRows == m_layout.rowsPerPage ? writer.write(buffer)
+                                                              : writer.write(buffer.copy(0, 0, buffer.width(), usedHeight));
+        if (!written) {
+            setError(error, QCoreApplication::translate("LeaderboardImageExporter", "Could not write %1: %2").arg(QDir::toNativeSeparators(pagePath), writer.errorString()));
+            return false;
+        }
+        if (writtenFiles) {
+            writtenFiles->append(pagePath);
+        }
+    }
+    return true;
+}
+
+bool LeaderboardImageExporter::exportPdf(const QString &filePath, QString *error)
+{
+    const int pages = pageCount();
+    const int rows = m_model->rowCount();
+    if (rows == 0 || m_layout.columns.isEmpty()) {
+        setError(error, QCoreApplication::translate("LeaderboardImageExporter", "There is no data to export."));
+        return false;
+    }
+
+    // At 96 dots per inch one PDF device unit is one pixel of the image layout.
+    constexpr int resolution = 96;
+    const QSize size = pageSize();
+    QPdfWriter pdf(filePath);
+    pdf.setResolution(resolution);
+    pdf.setPageSize(QPageSize(QSizeF(size.width() * 72.0 / resolution, size.height() * 72.0 / resolution),
+                              QPageSize::Point, QString(), QPageSize::ExactMatch));
+    pdf.setPageMargins(QMarginsF(0, 0, 0, 0));
+    pdf.setTitle(m_layout.title);
+
+    QPainter painter;
+    if (!painter.begin(&pdf)) {
+        setError(error, QCoreApplication::translate("LeaderboardImageExporter", "Could not write %1.").arg(QDir::toNativeSeparators(filePath)));
+        return false;
+    }
+    for (int page = 0; page < pages; ++page) {
+        if (page > 0) {
+            pdf.newPage();
+        }
+        const int firstRow = page * m_layout.rowsPerPage;
+        paintPage(painter, page, firstRow, std::min(m_layout.rowsPerPage, rows - firstRow), pages);
+    }
+    return painter.end();
+}
+
+/**
+ * @brief Paints the title, the headers and one band of rows.
+ * @param painter The painter, positioned at the top left of the page.
+ * @param page The page number, from 0.
+ * @param firstRow The model row at the top of the band.
+ * @param rowCount The rows in the band.
+ * @param pageCount The number of pages, shown in the title when above 1.
+ */
+void LeaderboardImageExporter::paintPage(QPainter &painter, int page, int firstRow, int rowCount, int pageCount) const
+{
+    const int width = pageWidth();
+    const int padding = m_layout.padding;
+    const int headerTop = padding + m_layout.titleHeight;
+    const int rowsTop = headerTop + m_layout.headerHeight;
+    const int rowsBottom = rowsTop + rowCount * m_layout.rowHeight;
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::white);
+
+    QString title = m_layout.title;
+    if (pageCount > 1) {
+        title = QCoreApplication::translate("LeaderboardImageExporter", "%1 (%2 of %3)").arg(title).arg(page + 1).arg(pageCount);
+    }
+    painter.setFont(QFont("Arial", m_layout.titleFontSize, QFont::Bold));
+    const QRect titleRect(padding, padding, width - 2 * padding, m_layout.titleHeight);
+    painter.fillRect(titleRect, Qt::black);
+    painter.drawText(titleRect, Qt::AlignCenter, title);
+
+    painter.setFont(QFont("Arial", m_layout.headerFontSize, QFont::Bold));
+    int x = padding;
+    for (const Column &column : m_layout.columns) {
+        const QRect headerRect(x, headerTop, column.width, m_layout.headerHeight);
+        painter.fillRect(headerRect, Qt::black);
+        painter.drawText(headerRect, alignmentOf(m_model->headerData(column.modelColumn, Qt::Horizontal, Qt::TextAlignmentRole)),
+                         m_model->headerData(column.modelColumn, Qt::Horizontal, Qt::DisplayRole).toString());
+        x += column.width;
+    }
+
+    painter.setFont(QFont("Arial", m_layout.rowFontSize));
+    painter.setPen(Qt::black);
+    for (int i = 0; i < rowCount; ++i) {
+        const int row = firstRow + i;
+        const int y = rowsTop + i * m_layout.rowHeight;
+
+        QColor rowColor = (row % 2 == 0) ? Qt::white : QColor(240, 240, 240);
+        bool ok = false;
+        const int rank = m_model->data(m_model->index(row, 0), Qt::DisplayRole).toInt(&ok);
+        if (ok && rank >= 1 && rank <= m_layout.highlightedRanks) {
+            rowColor = QColor(255, 165, 0, 255);
+        }
+        painter.fillRect(padding, y, width - 2 * padding, m_layout.rowHeight, rowColor);
+
+        x = padding;
+        for (const Column &column : m_layout.columns) {
+            const QModelIndex index = m_model->index(row, column.modelColumn);
+            const QRect cellRect(x, y, column.width, m_layout.rowHeight);
+            painter.drawText(cellRect, alignmentOf(m_model->data(index, Qt::TextAlignmentRole)),
+                             m_model->data(index, Qt::DisplayRole).toString());
+            x += column.width;
+        }
+    }
+
+    for (int i = 0; i <= rowCount; ++i) {
+        const int y = rowsTop + i * m_layout.rowHeight;
+        painter.drawLine(padding, y, width - padding, y);
+    }
+    x = padding;
+    painter.drawLine(x, rowsTop, x, rowsBottom);
+    for (const Column &column : m_layout.columns) {
+        x += column.width;
+        painter.drawLine(x, rowsTop, x, rowsBottom);
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * @file LeaderboardImageExporter.h
+ * @brief Contains the declaration of the LeaderboardImageExporter class.
+ */
+
+#ifndef LEADERBOARDIMAGEEXPORTER_H
+#define LEADERBOARDIMAGEEXPORTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QSize>
+
+class QAbstractItemModel;
+class QPainter;
+
+/**
+ * @class LeaderboardImageExporter
+ * @brief Renders a leaderboard as pages of a fixed number of rows.
+ *
+ * Every page repeats the title and the column headers, then shows the next
+ * band of rows. Pages are painted one at a time, either into a single image
+ * buffer that is reused for every PNG (or other image) file, or straight onto
+ * the pages of a PDF. Memory use therefore depends on the page size, not on
+ * the size of the field.
+ *
+ * Rows the model still holds back behind fetchMore() are fetched before the
+ * first page is painted, so every page can show the page count.
+ */
+class LeaderboardImageExporter
+{
+public:
+    static constexpr int DefaultRowsPerPage = 50; ///< Rows per page unless the layout says otherwise.
+
+    /**
+     * @struct Column
+     * @brief A model column shown in the export and its width in pixels.
+     */
+    struct Column {
+        int modelColumn;
+        int width;
+    };
+
+    /**
+     * @struct Layout
+     * @brief How a leaderboard is drawn, in pixels and points.
+     */
+    struct Layout {
+        QString title;                  ///< Drawn above the headers of every page.
+        QVector<Column> columns;        ///< The columns, left to right.
+        int titleHeight = 100;
+        int headerHeight = 60;
+        int rowHeight = 50;
+        int padding = 15;
+        int titleFontSize = 32;
+        int headerFontSize = 24;
+        int rowFontSize = 18;
+        int highlightedRanks = 3;       ///< Rows ranked this high or better in column 0 are highlighted.
+        int rowsPerPage = DefaultRowsPerPage;
+    };
+
+    /**
+     * @brief Constructs an exporter for a leaderboard model.
+     * @param model The model to read; it must outlive the exporter.
+     * @param layout How to draw it.
+     */
+    LeaderboardImageExporter(QAbstractItemModel *model, const Layout &layout);
+
+    /**
+     * @brief Gets the size of a full page in pixels.
+     */
+    QSize pageSize() const;
+
+    /**
+     * @brief Gets the number of pages, fetching every row first.
+     */
+    int pageCount();
+
+    /**
+     * @brief Writes each page to its own image file.
+     *
+     * A single page is written to @p filePath; otherwise the page number is
+     * added before the suffix, e.g. "Leaderboard_p002.png". The format follows
+     * the suffix.
+     *
+     * @param filePath The file name to write, or to number.
+     * @param writtenFiles Receives the files written; may be null.
+     * @param error Receives why the export failed; may be null.
+     * @return True if every page was written.
+     */
+    bool exportImages(const QString &filePath, QStringList *writtenFiles = nullptr, QString *error = nullptr);
+
+    /**
+     * @brief Writes every page to one PDF file, as vector graphics.
+     * @param filePath The file to create or replace.
+     * @param error Receives why the export failed; may be null.
+     * @return True if the file was written.
+     */
+    bool exportPdf(const QString &filePath, QString *error = nullptr);
+
+private:
+    QAbstractItemModel *m_model;
+    Layout m_layout;
+
+    int pageWidth() const;
+    int fetchRows(int rows);
+    void paintPage(QPainter &painter, int page, int firstRow, int rowCount, int pageCount) const;
+};
+
+#endif // LEADERBOARDIMAGEEXPORTER_H
@@ -0,0 +1,88 @@
+/**
+ * @file LeaderboardProxyModel.cpp
+ * @brief Implements the LeaderboardProxyModel class.
+ */
+
+#include "LeaderboardProxyModel.h"
+
+LeaderboardProxyModel::LeaderboardProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setDynamicSortFilter(true);
+}
+
+void LeaderboardProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (QAbstractItemModel *previous = QSortFilterProxyModel::sourceModel()) {
+        disconnect(previous, &QAbstractItemModel::modelReset, this, nullptr);
+    }
+    m_keys = dynamic_cast<const LeaderboardSortKeys *>(sourceModel);
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+    if (sourceModel) {
+        // A new result starts with only its first batch fetched.
+        connect(sourceModel, &QAbstractItemModel::modelReset, this, [this]() {
+            if (sortColumn() > RankColumn || !m_nameFilter.isEmpty()) {
+                fetchAllSourceRows();
+            }
+        });
+    }
+}
+
+/**
+ * @brief Sorts by a column, fetching every source row first unless it is the rank column.
+ */
+void LeaderboardProxyModel::sort(int column, Qt::SortOrder order)
+{
+    if (column > RankColumn) {
+        fetchAllSourceRows();
+    }
+    QSortFilterProxyModel::sort(column, order);
+}
+
+void LeaderboardProxyModel::setNameFilter(const QString &text)
+{
+    const QString filter = text.trimmed();
+    if (filter == m_nameFilter) {
+        return;
+    }
+    if (!filter.isEmpty()) {
+        fetchAllSourceRows();
+    }
+    m_nameFilter = filter;
+    invalidateRowsFilter();
+}
+
+bool LeaderboardProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+    if (m_nameFilter.isEmpty() || !m_keys) {
+        return true;
+    }
+    return m_keys->rowName(sourceRow).contains(m_nameFilter, Qt::CaseInsensitive);
+}
+
+bool LeaderboardProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    if (!m_keys) {
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+    const int column = left.column();
+    if (column == m_keys->nameColumn()) {
+        return m_keys->rowName(left.row()).compare(m_keys->rowName(right.row()), Qt::CaseInsensitive) < 0;
+    }
+    return m_keys->sortKey(left.row(), column) < m_keys->sortKey(right.row(), column);
+}
+
+/**
+ * @brief Makes the source hand over every row it has been holding back.
+ */
+void LeaderboardProxyModel::fetchAllSourceRows()
+{
+    QAbstractItemModel *source = sourceModel();
+    if (!source) {
+        return;
+    }
+    while (source->canFetchMore(QModelIndex())) {
+        source->fetchMore(QModelIndex());
+    }
+}
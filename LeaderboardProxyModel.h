@@ -0,0 +1,100 @@
+/**
+ * @file LeaderboardProxyModel.h
+ * @brief Contains the declaration of the LeaderboardProxyModel class.
+ */
+
+#ifndef LEADERBOARDPROXYMODEL_H
+#define LEADERBOARDPROXYMODEL_H
+
+#include <QSortFilterProxyModel>
+#include <QString>
+
+/**
+ * @class LeaderboardSortKeys
+ * @brief Gives LeaderboardProxyModel the values to sort and filter a leaderboard by.
+ *
+ * The leaderboard models implement this next to QAbstractTableModel, so the
+ * proxy reads integers and names straight from their rows instead of calling
+ * data(). Column 0 is the rank; its key is the source row, which keeps the
+ * calculated order including ties.
+ */
+class LeaderboardSortKeys
+{
+public:
+    virtual ~LeaderboardSortKeys() = default;
+
+    /**
+     * @brief Gets the integer a numeric column sorts by.
+     * @param row The source row.
+     * @param column The column; not the name column.
+     * @return The key; days without a round sort below every score.
+     */
+    virtual int sortKey(int row, int column) const = 0;
+
+    /**
+     * @brief Gets the player or team name of a row, used for searching and for the name column.
+     * @param row The source row.
+     */
+    virtual const QString &rowName(int row) const = 0;
+
+    /**
+     * @brief Gets the column that shows rowName().
+     */
+    virtual int nameColumn() const = 0;
+};
+
+/**
+ * @class LeaderboardProxyModel
+ * @brief Searches a leaderboard by name and sorts it by any column.
+ *
+ * Sorting by the rank column keeps the source order, so the source can keep
+ * handing rows to the view in batches. Searching, or sorting by any other
+ * column, first fetches the rest of the source rows, so no player is missed.
+ */
+class LeaderboardProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RankColumn = 0; ///< The column whose order is the calculated ranking.
+
+    /**
+     * @brief Constructs a LeaderboardProxyModel object.
+     * @param parent The parent object.
+     */
+    explicit LeaderboardProxyModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Sets the leaderboard model, which should implement LeaderboardSortKeys.
+     *
+     * Without LeaderboardSortKeys the proxy sorts through data() and shows
+     * every row.
+     */
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    /**
+     * @brief Gets the text names are searched for.
+     */
+    QString nameFilter() const { return m_nameFilter; }
+
+public slots:
+    /**
+     * @brief Shows only rows whose name contains the text, ignoring case.
+     * @param text The text to search for; empty shows every row.
+     */
+    void setNameFilter(const QString &text);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    const LeaderboardSortKeys *m_keys = nullptr;
+    QString m_nameFilter;
+
+    void fetchAllSourceRows();
+};
+
+#endif // LEADERBOARDPROXYMODEL_H
@@ -9,6 +9,9 @@
 #include "ScoreEntryDialog.h"
 #include "TournamentLeaderboardDialog.h"
 #include "TeamAssemblyDialog.h"
+#include "TournamentSnapshot.h"
+#include "TournamentEvents.h"
+#include "CsvExportEngine.h"
 #include <QtWidgets>
 #include <QSqlDatabase>
 #include <QDebug>
@@ -17,7 +20,7 @@
  * @brief Constructs a MainWindow object.
  *
  * This constructor sets up the main window UI, including buttons for accessing
- * different parts of the application. It also initializes the various dialogs.
+ * different parts of the application. The dialogs are created when first opened.
  *
  * @param db The database connection to use.
  * @param parent The parent widget.
@@ -26,27 +29,30 @@ MainWindow::MainWindow(QSqlDatabase &db, QWidget *parent)
     : QMainWindow(parent)
     , database(db)
 {
-    QString connNameToPass = database.connectionName();
-
-    playerDialog = new PlayerDialog(database, this);
-    coursesDialog = new CoursesDialog(database, this);
-    scoreDialog = new ScoreEntryDialog(connNameToPass, this);
-    tournamentLeaderboardDialog = new TournamentLeaderboardDialog(connNameToPass, this);
-    teamAssemblyDialog = new TeamAssemblyDialog(database, this);
-
     auto *central = new QWidget(this);
     auto *layout = new QVBoxLayout(central);
+    auto *eventLayout = new QHBoxLayout();
+    eventComboBox = new QComboBox(central);
+    auto *newEventButton = new QPushButton(tr("New Event..."), central);
     auto *playersButton = new QPushButton(tr("Manage Players"), central);
     auto *coursesButton = new QPushButton(tr("Manage Courses"), central);
     auto *scoreButton = new QPushButton(tr("Manage Scores"), central);
     auto *leaderboardButton = new QPushButton(tr("Tournament Leaderboard"), central);
     auto *teamAssemblyButton = new QPushButton(tr("Assemble Teams"), central);
+    auto *archiveButton = new QPushButton(tr("Open Archive..."), central);
+    auto *exportButton = new QPushButton(tr("Export All Data..."), central);
 
+    eventLayout->addWidget(new QLabel(tr("Event:"), central));
+    eventLayout->addWidget(eventComboBox, 1);
+    eventLayout->addWidget(newEventButton);
+    layout->addLayout(eventLayout);
     layout->addWidget(playersButton);
     layout->addWidget(coursesButton);
     layout->addWidget(scoreButton);
     layout->addWidget(leaderboardButton);
     layout->addWidget(teamAssemblyButton);
+    layout->addWidget(archiveButton);
+    layout->addWidget(exportButton);
 
     central->setLayout(layout);
     setCentralWidget(central);
@@ -56,15 +62,43 @@ MainWindow::MainWindow(QSqlDatabase &db, QWidget *parent)
     connect(scoreButton, &QPushButton::clicked, this, &MainWindow::openScoreDialog);
     connect(leaderboardButton, &QPushButton::clicked, this, &MainWindow::openLeaderboardDialog);
     connect(teamAssemblyButton, &QPushButton::clicked, this, &MainWindow::openTeamAssemblyDialog);
+    connect(archiveButton, &QPushButton::clicked, this, &MainWindow::openArchive);
+    connect(exportButton, &QPushButton::clicked, this, &MainWindow::exportAllData);
+    connect(newEventButton, &QPushButton::clicked, this, &MainWindow::createEvent);
+
+    loadEvents();
+    connect(eventComboBox, &QComboBox::currentIndexChanged, this, &MainWindow::selectEvent);
 
     setWindowTitle(tr("Tournament App"));
     resize(400, 300);
 }
 
+bool MainWindow::event(QEvent *event)
+{
+    bool result = QMainWindow::event(event);
+    if (event->type() == QEvent::Paint && !firstPaintReported) {
+        firstPaintReported = true;
+        emit firstPaintDone();
+    }
+    return result;
+}
+
+/**
+ * @brief Forwards saved scores to the leaderboard dialog once both dialogs exist.
+ */
+void MainWindow::connectScoreUpdates() {
+    if (scoreDialog && tournamentLeaderboardDialog) {
+        connect(scoreDialog, &ScoreEntryDialog::scoreSaved, tournamentLeaderboardDialog, &TournamentLeaderboardDialog::applyScoreChange);
+    }
+}
+
 /**
  * @brief Opens the player management dialog.
  */
 void MainWindow::openPlayerDialog() {
+    if (!playerDialog) {
+        playerDialog = new PlayerDialog(database, this);
+    }
     playerDialog->exec();
 }
 
@@ -72,6 +106,9 @@ void MainWindow::openPlayerDialog() {
  * @brief Opens the course management dialog.
  */
 void MainWindow::openCoursesDialog() {
+    if (!coursesDialog) {
+        coursesDialog = new CoursesDialog(database, this);
+    }
     coursesDialog->exec();
 }
 
@@ -79,6 +116,10 @@ void MainWindow::openCoursesDialog() {
  * @brief Opens the score entry dialog.
  */
 void MainWindow::openScoreDialog() {
+    if (!scoreDialog) {
+        scoreDialog = new ScoreEntryDialog(database.connectionName(), this);
+        connectScoreUpdates();
+    }
     scoreDialog->exec();
 }
 
@@ -86,6 +127,10 @@ void MainWindow::openScoreDialog() {
  * @brief Opens the tournament leaderboard dialog.
  */
 void MainWindow::openLeaderboardDialog() {
+    if (!tournamentLeaderboardDialog) {
+        tournamentLeaderboardDialog = new TournamentLeaderboardDialog(database.connectionName(), this);
+        connectScoreUpdates();
+    }
     tournamentLeaderboardDialog->exec();
 }
 
@@ -93,5 +138,119 @@ void MainWindow::openLeaderboardDialog() {
  * @brief Opens the team assembly dialog.
  */
 void MainWindow::openTeamAssemblyDialog() {
+    if (!teamAssemblyDialog) {
+        teamAssemblyDialog = new TeamAssemblyDialog(database, this);
+    }
     teamAssemblyDialog->exec();
 }
+
+/**
+ * @brief Opens an archived tournament in a read-only leaderboard dialog.
+ */
+void MainWindow::openArchive() {
+    QString filePath = QFileDialog::getOpenFileName(this, tr("Open Tournament Archive"), QDir::homePath(), tr("Tournament Archives (*.mosnap)"));
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    TournamentSnapshot::CutSettings cut;
+    QString error;
+    TournamentSnapshot archive = TournamentSnapshot::openArchive(filePath, &cut, &error);
+    if (!archive.isValid()) {
+        QMessageBox::warning(this, tr("Open Archive"), tr("Could not open the archive:\n%1").arg(error));
+        return;
+    }
+
+    TournamentLeaderboardDialog dialog(archive, cut, this);
+    dialog.exec();
+}
+
+/**
+ * @brief Exports every table and leaderboard to CSV files in a chosen folder.
+ *
+ * The files are written on a worker thread, so the window stays responsive
+ * while a long score history is exported.
+ */
+void MainWindow::exportAllData() {
+    const QString dirPath = QFileDialog::getExistingDirectory(this, tr("Export All Data"), QDir::homePath());
+    if (dirPath.isEmpty()) {
+        return;
+    }
+
+    QList<CsvExportEngine::Job> jobs;
+    const QDir dir(dirPath);
+    for (CsvExportEngine::Dataset dataset : CsvExportEngine::allDatasets()) {
+        jobs.append({ dataset, dir.filePath(CsvExportEngine::defaultFileName(dataset)) });
+    }
+    CsvExportEngine::exportWithProgress(database.connectionName(), jobs, this);
+}
+
+/**
+ * @brief Fills the event selector and selects the current event.
+ */
+void MainWindow::loadEvents() {
+    const QSignalBlocker blocker(eventComboBox);
+    eventComboBox->clear();
+    for (const EventInfo &event : TournamentEvents::list(database)) {
+        eventComboBox->addItem(event.name, event.id);
+        if (event.isCurrent) {
+            eventComboBox->setCurrentIndex(eventComboBox->count() - 1);
+        }
+    }
+}
+
+/**
+ * @brief Deletes the dialogs that show data of the current event.
+ *
+ * The score entry dialog writes its pending scores when it is destroyed, so
+ * this must run before the current event changes.
+ */
+void MainWindow::closeEventDialogs() {
+    delete scoreDialog;
+    scoreDialog = nullptr;
+    delete tournamentLeaderboardDialog;
+    tournamentLeaderboardDialog = nullptr;
+    delete teamAssemblyDialog;
+    teamAssemblyDialog = nullptr;
+}
+
+/**
+ * @brief Makes the event chosen in the event selector the current event.
+ * @param index The index of the event in the selector.
+ */
+void MainWindow::selectEvent(int index) {
+    const int eventId = eventComboBox->itemData(index).toInt();
+    if (eventId == TournamentEvents::currentEventId(database)) {
+        return;
+    }
+
+    closeEventDialogs();
+    if (!TournamentEvents::setCurrentEvent(database, eventId)) {
+        QMessageBox::critical(this, tr("Select Event"), tr("Could not switch to %1.").arg(eventComboBox->itemText(index)));
+        loadEvents();
+    }
+}
+
+/**
+ * @brief Asks for a name and adds a new event, which becomes the current event.
+ */
+void MainWindow::createEvent() {
+    bool ok = false;
+    const QString name = QInputDialog::getText(this, tr("New Event"), tr("Event name:"), QLineEdit::Normal,
+                                               tr("Mosley Open %1").arg(QDate::currentDate().year()), &ok).trimmed();
+    if (!ok || name.isEmpty()) {
+        return;
+    }
+
+    const int eventId = TournamentEvents::createEvent(database, name);
+    if (eventId < 0) {
+        QMessageBox::critical(this, tr("New Event"), tr("Could not add the event %1. Event names must be unique.").arg(name));
+        return;
+    }
+
+    closeEventDialogs();
+    if (!TournamentEvents::setCurrentEvent(database, eventId)) {
+        QMessageBox::critical(this, tr("New Event"), tr("The event was added but could not be selected."));
+    }
+    loadEvents();
+}
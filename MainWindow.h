@@ -14,6 +14,7 @@ class CoursesDialog;
 class ScoreEntryDialog;
 class TournamentLeaderboardDialog;
 class TeamAssemblyDialog;
+class QComboBox;
 
 /**
  * @class MainWindow
@@ -21,6 +22,9 @@ class TeamAssemblyDialog;
  *
  * This class creates the main application window and provides access to the
  * various dialogs for managing players, courses, scores, teams, and the leaderboard.
+ * Each dialog is created the first time it is opened and kept for later use.
+ * An event selector switches the current event; the dialogs showing per-event
+ * data are then discarded and created again for the new event.
  */
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -32,6 +36,15 @@ public:
      */
     explicit MainWindow(QSqlDatabase &db, QWidget *parent = nullptr);
 
+signals:
+    /**
+     * @brief Emitted once, after the window has been painted for the first time.
+     */
+    void firstPaintDone();
+
+protected:
+    bool event(QEvent *event) override;
+
 private slots:
     /**
      * @brief Opens the player management dialog.
@@ -58,13 +71,40 @@ private slots:
      */
     void openTeamAssemblyDialog();
 
+    /**
+     * @brief Opens an archived tournament in a read-only leaderboard dialog.
+     */
+    void openArchive();
+
+    /**
+     * @brief Exports every table and leaderboard to CSV files in a chosen folder.
+     */
+    void exportAllData();
+
+    /**
+     * @brief Makes the event chosen in the event selector the current event.
+     * @param index The index of the event in the selector.
+     */
+    void selectEvent(int index);
+
+    /**
+     * @brief Asks for a name and adds a new event, which becomes the current event.
+     */
+    void createEvent();
+
 private:
-    PlayerDialog *playerDialog;                     ///< The player management dialog.
-    CoursesDialog *coursesDialog;                   ///< The course management dialog.
-    ScoreEntryDialog *scoreDialog;                  ///< The score entry dialog.
-    TournamentLeaderboardDialog *tournamentLeaderboardDialog; ///< The tournament leaderboard dialog.
-    TeamAssemblyDialog *teamAssemblyDialog;         ///< The team assembly dialog.
+    PlayerDialog *playerDialog = nullptr;           ///< The player management dialog.
+    CoursesDialog *coursesDialog = nullptr;         ///< The course management dialog.
+    ScoreEntryDialog *scoreDialog = nullptr;        ///< The score entry dialog.
+    TournamentLeaderboardDialog *tournamentLeaderboardDialog = nullptr; ///< The tournament leaderboard dialog.
+    TeamAssemblyDialog *teamAssemblyDialog = nullptr; ///< The team assembly dialog.
+    QComboBox *eventComboBox = nullptr;             ///< Selects the current event.
     QSqlDatabase &database;                         ///< A reference to the database connection.
+    bool firstPaintReported = false;                ///< Whether firstPaintDone() has been emitted.
+
+    void connectScoreUpdates();
+    void loadEvents();
+    void closeEventDialogs();
 };
 
 #endif // MAINWINDOW_H
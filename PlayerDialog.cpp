@@ -6,6 +6,8 @@
 #include "PlayerDialog.h"
 #include "SpinBoxDelegate.h"    // For SpinBoxDelegate
 #include "CheckBoxDelegate.h" // For CheckBoxDelegate
+#include "BulkImporter.h"       // For BulkImporter
+#include "CsvExportEngine.h"    // For CsvExportEngine
 #include <QtWidgets>            // For QTableView, QPushButton, Layouts etc.
 #include <QtSql>                // For QSqlTableModel, QSqlQuery, QSqlError
 
@@ -27,6 +29,7 @@ PlayerDialog::PlayerDialog(QSqlDatabase &db, QWidget *parent)
     , removeButton(new QPushButton(tr("Remove"), this))
     , closeButton(new QPushButton(tr("Close"), this))
     , exportButton(new QPushButton(tr("Export to CSV"), this))
+    , importButton(new QPushButton(tr("Import from CSV"), this))
 {
     model->setTable("players");
     model->setEditStrategy(QSqlTableModel::OnFieldChange);
@@ -49,6 +52,7 @@ PlayerDialog::PlayerDialog(QSqlDatabase &db, QWidget *parent)
     buttonLayout->addWidget(addButton);
     buttonLayout->addWidget(removeButton);
     buttonLayout->addWidget(exportButton);
+    buttonLayout->addWidget(importButton);
     buttonLayout->addStretch();
     buttonLayout->addWidget(closeButton);
 
@@ -62,6 +66,7 @@ PlayerDialog::PlayerDialog(QSqlDatabase &db, QWidget *parent)
     connect(removeButton, &QPushButton::clicked, this, &PlayerDialog::removeSelected);
     connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
     connect(exportButton, &QPushButton::clicked, this, &PlayerDialog::exportToCsv);
+    connect(importButton, &QPushButton::clicked, this, &PlayerDialog::importFromCsv);
 }
 
 /**
@@ -119,7 +124,7 @@ void PlayerDialog::removeSelected() {
  *
  * This slot is called when the "Export to CSV" button is clicked. It opens a
  * file dialog to choose a location to save the CSV file, and then writes the
- * player data to the selected file.
+ * player data to the selected file on a worker thread.
  */
 void PlayerDialog::exportToCsv() {
     QString filePath = QFileDialog::getSaveFileName(this,
@@ -134,41 +139,32 @@ void PlayerDialog::exportToCsv() {
         filePath += ".csv";
     }
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, tr("File Error"),
-                              tr("Could not open file for writing: %1").arg(file.errorString()));
-        return;
-    }
-
-    QTextStream out(&file);
-    out.setEncoding(QStringConverter::Utf8); 
+    CsvExportEngine::exportWithProgress(model->database().connectionName(),
+                                        { { CsvExportEngine::Dataset::Players, filePath } }, this);
+}
 
-    QStringList headerLabels;
-    for (int i = 0; i < model->columnCount(); ++i) {
-        if (tableView->isColumnHidden(i)) continue; // Skip hidden columns like 'id'
-        QString headerText = model->headerData(i, Qt::Horizontal, Qt::DisplayRole).toString();
-        headerLabels << QString("\"%1\"").arg(headerText.replace("\"", "\"\"")); 
+/**
+ * @brief Imports players from a CSV file.
+ *
+ * This slot is called when the "Import from CSV" button is clicked. The file
+ * may be one written by exportToCsv(); players whose name already exists are
+ * updated, the others are added.
+ */
+void PlayerDialog::importFromCsv() {
+    QString filePath = QFileDialog::getOpenFileName(this,
+                                                    tr("Import Player Data"),
+                                                    QDir::homePath(),
+                                                    tr("CSV Files (*.csv);;All Files (*)")
+                                                    );
+    if (filePath.isEmpty()) {
+        return;
     }
-    out << headerLabels.join(",") << "\n"; 
-
-    for (int row = 0; row < model->rowCount(); ++row) {
-        QStringList rowData;
-        for (int column = 0; column < model->columnCount(); ++column) {
-            if (tableView->isColumnHidden(column)) continue;
-            QVariant cellData = model->data(model->index(row, column), Qt::DisplayRole);
-            QString cellString = cellData.toString(); 
-            if (cellData.typeId() == QMetaType::Bool) { // Handle boolean for 'active' column
-                cellString = cellData.toBool() ? "1" : "0";
-            }
-            if (cellString.contains(',') || cellString.contains('"') || cellString.contains('\n') || cellString.contains('\r')) {
-                 rowData << QString("\"%1\"").arg(cellString.replace("\"", "\"\"")); 
-            } else {
-                 rowData << cellString; 
-            }
-        }
-        out << rowData.join(",") << "\n"; 
+    if (BulkImporter::detectFileFormat(filePath) != BulkImporter::Format::Players) {
+        QMessageBox::warning(this, tr("Import Player Data"),
+                             tr("The file does not have Name and Handicap columns."));
+        return;
     }
-    QMessageBox::information(this, tr("Export Successful"),
-                             tr("Player data exported to:\n%1").arg(QDir::toNativeSeparators(filePath)));
+
+    BulkImporter::importWithProgress(model->database().connectionName(), filePath, this);
+    model->select();
 }
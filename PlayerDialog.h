@@ -17,7 +17,7 @@ class QPushButton;
  * @brief A dialog for managing players in the database.
  *
  * This dialog displays a list of players from the database in a table view.
- * It allows adding new players, removing existing players, and exporting the player list to a CSV file.
+ * It allows adding new players, removing existing players, and importing and exporting the player list as a CSV file.
  */
 class PlayerDialog : public QDialog {
     Q_OBJECT
@@ -45,6 +45,11 @@ public slots:
      */
     void exportToCsv();
 
+    /**
+     * @brief Imports players from a CSV file, updating players with the same name.
+     */
+    void importFromCsv();
+
 private:
     QSqlTableModel *model;        ///< The model for the player data.
     QTableView *tableView;        ///< The table view for displaying player data.
@@ -52,6 +57,7 @@ private:
     QPushButton *removeButton;    ///< The button for removing selected players.
     QPushButton *closeButton;     ///< The button for closing the dialog.
     QPushButton *exportButton;    ///< The button for exporting data to CSV.
+    QPushButton *importButton;    ///< The button for importing data from CSV.
 };
 
 #endif // PLAYERDIALOG_H
\ No newline at end of file
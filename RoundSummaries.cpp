@@ -0,0 +1,209 @@
+/**
+ * @file RoundSummaries.cpp
+ * @brief Implements the round_summaries table.
+ */
+
+#include "RoundSummaries.h"
+#include "SqliteFunctions.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+namespace RoundSummaries {
+
+namespace {
+
+/**
+ * @brief Gets the columns identifying a round.
+ */
+QStringList keyColumns(Key key)
+{
+    if (key == Key::PlayerDayCourse) {
+        return { "player_id", "day_num", "course_id" };
+    }
+    return { "event_id", "player_id", "day_num", "course_id" };
+}
+
+/**
+ * @brief Joins the key columns as "prefix.a <separator> prefix.b ...", or "a = prefix.a AND ..." when @p compare is set.
+ */
+QString joinColumns(const QStringList &columns, const QString &prefix, const QString &separator, const QString &compare = QString())
+{
+    QStringList parts;
+    for (const QString &column : columns) {
+        parts << (compare.isEmpty() ? QString("%1%2").arg(prefix, column) : QString("%1%2 = %3.%2").arg(prefix, column, compare));
+    }
+    return parts.join(separator);
+}
+
+/**
+ * @brief Builds the INSERT that recalculates the summaries of the rounds matching a condition.
+ * @param key The columns identifying a round.
+ * @param where An SQL condition on scores s, e.g. "s.course_id = NEW.course_id".
+ * @param useNativeFunctions Whether stableford() is registered; never set for trigger bodies.
+ */
+QString insertSummaries(Key key, const QString &where, bool useNativeFunctions = false)
+{
+    const QStringList columns = keyColumns(key);
+    const QString scoreColumns = joinColumns(columns, "s.", ", ");
+    const QString points = SqliteFunctions::stablefordExpression("s.score", "h.par", useNativeFunctions);
+    return QString("INSERT INTO round_summaries (%1, holes_played, gross_strokes, gross_stableford, last_score_id) "
+                   "SELECT %2, "
+                   "SUM(s.score > 0), SUM(CASE WHEN s.score > 0 THEN s.score ELSE 0 END), COALESCE(SUM(%3), 0), MAX(s.id) "
+                   "FROM scores s "
+                   "LEFT JOIN holes h ON h.course_id = s.course_id AND h.hole_num = s.hole_num "
+                   "WHERE %4 "
+                   "GROUP BY %2")
+        .arg(columns.join(", "), scoreColumns, points, where);
+}
+
+/**
+ * @brief Builds the trigger body statements that recalculate one round.
+ * @param key The columns identifying a round.
+ * @param row "NEW" or "OLD".
+ * @param guard An extra SQL condition; the statements do nothing when it is false.
+ */
+QString recalculateRound(Key key, const QString &row, const QString &guard = "1")
+{
+    const QStringList columns = keyColumns(key);
+    const QString roundKey = joinColumns(columns, "", " AND ", row);
+    const QString scoreKey = joinColumns(columns, "s.", " AND ", row);
+    return QString("DELETE FROM round_summaries WHERE %1 AND %2; %3;")
+        .arg(roundKey, guard, insertSummaries(key, QString("%1 AND %2").arg(scoreKey, guard)));
+}
+
+/**
+ * @brief Builds the trigger body statements that recalculate every round on one course.
+ * @param key The columns identifying a round.
+ * @param row "NEW" or "OLD".
+ * @param guard An extra SQL condition; the statements do nothing when it is false.
+ */
+QString recalculateCourse(Key key, const QString &row, const QString &guard = "1")
+{
+    return QString("DELETE FROM round_summaries WHERE course_id = %1.course_id AND %2; %3;")
+        .arg(row, guard, insertSummaries(key, QString("s.course_id = %1.course_id AND %2").arg(row, guard)));
+}
+
+/**
+ * @brief Builds the trigger that recalculates the round of each inserted score.
+ */
+QString scoresInsertTrigger(Key key)
+{
+    return "CREATE TRIGGER IF NOT EXISTS trg_scores_insert_summary AFTER INSERT ON scores BEGIN " + recalculateRound(key, "NEW") + " END";
+}
+
+} // namespace
+
+QStringList triggerNames()
+{
+    return { "trg_scores_insert_summary", "trg_scores_update_summary", "trg_scores_delete_summary",
+             "trg_holes_insert_summary", "trg_holes_update_summary", "trg_holes_delete_summary" };
+}
+
+QStringList schemaStatements(Key key)
+{
+    const QStringList columns = keyColumns(key);
+    QStringList columnDefinitions;
+    for (const QString &column : columns) {
+        columnDefinitions << column + " INTEGER NOT NULL, ";
+    }
+    // An update normally stays within its round; the old round is only recalculated if it moved.
+    const QString roundMoved = QString("NOT (%1)").arg(joinColumns(columns, "OLD.", " AND ", "NEW"));
+
+    return {
+        "CREATE TABLE IF NOT EXISTS round_summaries (" +
+        columnDefinitions.join(QString()) +
+        "holes_played INTEGER NOT NULL, "
+        "gross_strokes INTEGER NOT NULL, "
+        "gross_stableford INTEGER NOT NULL, "
+        "last_score_id INTEGER NOT NULL, "
+        "PRIMARY KEY (" + columns.join(", ") + ")) WITHOUT ROWID",
+
+        scoresInsertTrigger(key),
+        "CREATE TRIGGER IF NOT EXISTS trg_scores_update_summary AFTER UPDATE ON scores BEGIN " +
+            recalculateRound(key, "OLD", roundMoved) + " " + recalculateRound(key, "NEW") + " END",
+        "CREATE TRIGGER IF NOT EXISTS trg_scores_delete_summary AFTER DELETE ON scores BEGIN " + recalculateRound(key, "OLD") + " END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_holes_insert_summary AFTER INSERT ON holes BEGIN " + recalculateCourse(key, "NEW") + " END",
+        "CREATE TRIGGER IF NOT EXISTS trg_holes_update_summary AFTER UPDATE ON holes BEGIN " +
+            recalculateCourse(key, "OLD", "OLD.course_id <> NEW.course_id") + " " + recalculateCourse(key, "NEW") + " END",
+        "CREATE TRIGGER IF NOT EXISTS trg_holes_delete_summary AFTER DELETE ON holes BEGIN " + recalculateCourse(key, "OLD") + " END",
+
+        "DELETE FROM round_summaries",
+        insertSummaries(key, "1"),
+    };
+}
+
+bool rebuild(QSqlDatabase &db)
+{
+    if (!db.transaction()) {
+        qWarning() << "RoundSummaries::rebuild: Could not start transaction:" << db.lastError().text();
+        return false;
+    }
+
+    const bool native = SqliteFunctions::registerScoringFunctions(db);
+    QSqlQuery query(db);
+    if (!query.exec("DELETE FROM round_summaries") || !query.exec(insertSummaries(Key::EventPlayerDayCourse, "1", native))) {
+        qWarning() << "RoundSummaries::rebuild: ERROR:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+    query.finish();
+
+    if (!db.commit()) {
+        qWarning() << "RoundSummaries::rebuild: Could not commit:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+    return true;
+}
+
+bool beginBulkLoad(QSqlDatabase &db, qint64 *lastScoreId)
+{
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT COALESCE(MAX(id), 0) FROM scores") || !query.next()) {
+        qWarning() << "RoundSummaries::beginBulkLoad: ERROR:" << query.lastError().text();
+        return false;
+    }
+    *lastScoreId = query.value(0).toLongLong();
+    query.finish();
+
+    // INSERT OR REPLACE only fires the insert trigger, so it is the only one to suspend.
+    if (!query.exec("DROP TRIGGER IF EXISTS trg_scores_insert_summary")) {
+        qWarning() << "RoundSummaries::beginBulkLoad: ERROR:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool finishBulkLoad(QSqlDatabase &db, qint64 lastScoreId)
+{
+    // New rows always get a larger id, and a replaced row keeps its round, so
+    // the rounds with an id above lastScoreId are exactly the changed ones.
+    // The key is listed in idx_scores_event_day_course order so both statements use that index.
+    const QString changedRounds = "(SELECT event_id, day_num, course_id, player_id FROM scores WHERE id > :lastScoreId)";
+    const bool native = SqliteFunctions::registerScoringFunctions(db);
+    const QStringList statements = {
+        "DELETE FROM round_summaries WHERE (event_id, day_num, course_id, player_id) IN " + changedRounds,
+        insertSummaries(Key::EventPlayerDayCourse, "(s.event_id, s.day_num, s.course_id, s.player_id) IN " + changedRounds, native),
+    };
+
+    QSqlQuery query(db);
+    for (const QString &statement : statements) {
+        query.prepare(statement);
+        query.bindValue(":lastScoreId", lastScoreId);
+        if (!query.exec()) {
+            qWarning() << "RoundSummaries::finishBulkLoad: ERROR:" << query.lastError().text();
+            return false;
+        }
+    }
+    if (!query.exec(scoresInsertTrigger(Key::EventPlayerDayCourse))) {
+        qWarning() << "RoundSummaries::finishBulkLoad: Could not restore the trigger:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+} // namespace RoundSummaries
@@ -0,0 +1,88 @@
+/**
+ * @file RoundSummaries.h
+ * @brief Contains the declarations for the round_summaries table.
+ */
+
+#ifndef ROUNDSUMMARIES_H
+#define ROUNDSUMMARIES_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @namespace RoundSummaries
+ * @brief One pre-aggregated row per player round, kept current by triggers.
+ *
+ * round_summaries holds, for every (event_id, player_id, day_num, course_id)
+ * with at least one score row:
+ *
+ * - holes_played: the holes with a positive score.
+ * - gross_strokes: the sum of those scores.
+ * - gross_stableford: the gross Stableford points, counting only holes with a par.
+ * - last_score_id: the newest scores.id of the round, to tell which course was entered last.
+ *
+ * Triggers on scores recalculate the affected round(s); triggers on holes
+ * recalculate every round on the course. The triggers score in plain SQL so
+ * they work in any process that writes to the database. rebuild() and
+ * finishBulkLoad() run on one known connection, so they use the native
+ * stableford() function when SqliteFunctions can register it.
+ */
+namespace RoundSummaries {
+
+/**
+ * @enum Key
+ * @brief The columns identifying a round.
+ */
+enum class Key {
+    PlayerDayCourse,        ///< Schema version 5, before scores belonged to an event.
+    EventPlayerDayCourse    ///< The current schema.
+};
+
+/**
+ * @brief Gets the statements that create the table and its triggers and fill it.
+ * @param key The columns identifying a round; migrations pass the key of their schema version.
+ */
+QStringList schemaStatements(Key key = Key::EventPlayerDayCourse);
+
+/**
+ * @brief Gets the names of the triggers created by schemaStatements().
+ */
+QStringList triggerNames();
+
+/**
+ * @brief Recalculates every summary from the scores and holes tables.
+ *
+ * For repairing a database whose summaries were changed by hand or written
+ * with the triggers missing. Runs in a single transaction.
+ *
+ * @param db An open read-write connection.
+ * @return True if the summaries were rebuilt.
+ */
+bool rebuild(QSqlDatabase &db);
+
+/**
+ * @brief Suspends the per-score trigger before a bulk load of scores.
+ *
+ * Recalculating a round for every inserted score makes large imports several
+ * times slower than the inserts themselves. Call this and finishBulkLoad()
+ * inside the same transaction as the inserts, so no other connection ever
+ * sees the trigger missing. Scores must be written with INSERT OR REPLACE.
+ *
+ * @param db The connection with the open transaction.
+ * @param[out] lastScoreId The newest scores.id before the load.
+ * @return True if the trigger was suspended.
+ */
+bool beginBulkLoad(QSqlDatabase &db, qint64 *lastScoreId);
+
+/**
+ * @brief Recalculates the rounds changed since beginBulkLoad() and restores the trigger.
+ * @param db The connection with the open transaction.
+ * @param lastScoreId The id returned by beginBulkLoad().
+ * @return True if the summaries are current and the trigger is back.
+ */
+bool finishBulkLoad(QSqlDatabase &db, qint64 lastScoreId);
+
+} // namespace RoundSummaries
+
+#endif // ROUNDSUMMARIES_H
@@ -0,0 +1,275 @@
+/**
+ * @file SchemaMigrator.cpp
+ * @brief Implements the SchemaMigrator class.
+ */
+
+#include "SchemaMigrator.h"
+#include "RoundSummaries.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QElapsedTimer>
+#include <QDebug>
+
+/**
+ * @brief Builds the triggers that bump a change counter on every insert, update and delete.
+ * @param table The table to watch.
+ * @param counter The row in change_counters to bump.
+ */
+static QStringList changeCounterTriggers(const QString &table, const QString &counter)
+{
+    QStringList statements;
+    for (const char *operation : { "INSERT", "UPDATE", "DELETE" }) {
+        statements << SchemaMigrator::changeCounterTrigger(table, operation, counter);
+    }
+    return statements;
+}
+
+/**
+ * @brief Builds the statements of the change counter migration.
+ *
+ * Every insert, update and delete on a tracked table bumps its row in
+ * change_counters; ChangeTracker compares the counters.
+ */
+static QStringList changeCounterStatements()
+{
+    const QStringList tables = { "players", "courses", "holes", "teams", "scores", "settings" };
+    QStringList statements = {
+        "CREATE TABLE IF NOT EXISTS change_counters (table_name TEXT PRIMARY KEY, counter INTEGER NOT NULL DEFAULT 0) WITHOUT ROWID",
+    };
+    for (const QString &table : tables) {
+        statements << QString("INSERT OR IGNORE INTO change_counters (table_name) VALUES ('%1')").arg(table);
+        statements << changeCounterTriggers(table, table);
+    }
+    return statements;
+}
+
+/**
+ * @brief Builds the statements of the events migration.
+ *
+ * Existing data becomes the first event. scores, settings and teams are
+ * rebuilt with an event_id leading their keys, so every per-event lookup is a
+ * range scan within one event however many past events the file holds. Team
+ * assignments move from players.team_id to team_members, and the old column
+ * is dropped with its index. Rebuilding a table drops its triggers, so
+ * the change counter and round summary triggers are created again.
+ */
+static QStringList eventStatements()
+{
+    QStringList statements;
+    for (const QString &trigger : RoundSummaries::triggerNames()) {
+        statements << QString("DROP TRIGGER IF EXISTS %1").arg(trigger);
+    }
+    statements << "DROP TABLE IF EXISTS round_summaries";
+
+    statements << R"(CREATE TABLE events (
+                        id INTEGER PRIMARY KEY AUTOINCREMENT,
+                        name TEXT NOT NULL UNIQUE,
+                        is_current INTEGER NOT NULL DEFAULT 0,
+                        created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP
+                    ))"
+               << "CREATE UNIQUE INDEX idx_events_current ON events (is_current) WHERE is_current = 1"
+               << "INSERT INTO events (id, name, is_current) VALUES (1, 'Mosley Open ' || strftime('%Y', 'now'), 1)"
+               // Queries select the current event with (SELECT id FROM current_event), which SQLite evaluates once per statement.
+               << "CREATE VIEW current_event AS SELECT id FROM events WHERE is_current = 1";
+
+    statements << R"(CREATE TABLE scores_new (
+                        id INTEGER PRIMARY KEY AUTOINCREMENT,
+                        event_id INTEGER NOT NULL REFERENCES events(id) ON DELETE CASCADE,
+                        player_id INTEGER NOT NULL,
+                        course_id INTEGER NOT NULL,
+                        hole_num INTEGER NOT NULL CHECK (hole_num >= 1 AND hole_num <= 18),
+                        day_num INTEGER NOT NULL CHECK (day_num >= 1 AND day_num <= 3),
+                        score INTEGER,
+                        UNIQUE (event_id, player_id, course_id, hole_num, day_num)
+                    ))"
+               << "INSERT INTO scores_new (id, event_id, player_id, course_id, hole_num, day_num, score) "
+                  "SELECT id, 1, player_id, course_id, hole_num, day_num, score FROM scores"
+               << "DROP TABLE scores"
+               << "ALTER TABLE scores_new RENAME TO scores"
+               << "CREATE INDEX idx_scores_event_day_course ON scores (event_id, day_num, course_id, player_id, hole_num, score)";
+
+    statements << R"(CREATE TABLE settings_new (
+                        event_id INTEGER NOT NULL REFERENCES events(id) ON DELETE CASCADE,
+                        key TEXT NOT NULL,
+                        value TEXT,
+                        PRIMARY KEY (event_id, key)
+                    ) WITHOUT ROWID)"
+               << "INSERT INTO settings_new (event_id, key, value) SELECT 1, key, value FROM settings"
+               << "DROP TABLE settings"
+               << "ALTER TABLE settings_new RENAME TO settings";
+
+    statements << R"(CREATE TABLE teams_new (
+                        event_id INTEGER NOT NULL REFERENCES events(id) ON DELETE CASCADE,
+                        id INTEGER NOT NULL,
+                        name TEXT NOT NULL,
+                        PRIMARY KEY (event_id, id),
+                        UNIQUE (event_id, name)
+                    ) WITHOUT ROWID)"
+               << "INSERT INTO teams_new (event_id, id, name) SELECT 1, id, name FROM teams"
+               << "DROP TABLE teams"
+               << "ALTER TABLE teams_new RENAME TO teams";
+
+    statements << R"(CREATE TABLE team_members (
+                        event_id INTEGER NOT NULL REFERENCES events(id) ON DELETE CASCADE,
+                        player_id INTEGER NOT NULL,
+                        team_id INTEGER NOT NULL,
+                        PRIMARY KEY (event_id, player_id)
+                    ) WITHOUT ROWID)"
+               << "INSERT INTO team_members (event_id, player_id, team_id) SELECT 1, id, team_id FROM players WHERE team_id IS NOT NULL"
+               << "CREATE INDEX idx_team_members_team ON team_members (event_id, team_id)"
+               // A column cannot be dropped while an index uses it.
+               << "DROP INDEX IF EXISTS idx_players_active_team"
+               << "ALTER TABLE players DROP COLUMN team_id";
+
+    statements << "INSERT OR IGNORE INTO change_counters (table_name) VALUES ('events')";
+    for (const QString &table : { "events", "scores", "settings", "teams" }) {
+        statements << changeCounterTriggers(table, table);
+    }
+    statements << changeCounterTriggers("team_members", "teams");
+
+    statements << RoundSummaries::schemaStatements(RoundSummaries::Key::EventPlayerDayCourse)
+               << "ANALYZE";
+    return statements;
+}
+
+QString SchemaMigrator::changeCounterTrigger(const QString &table, const QString &operation, const QString &counter)
+{
+    return QString("CREATE TRIGGER IF NOT EXISTS trg_%1_%2_changed AFTER %3 ON %1 "
+                   "BEGIN UPDATE change_counters SET counter = counter + 1 WHERE table_name = '%4'; END")
+        .arg(table, operation.toLower(), operation, counter);
+}
+
+const QVector<SchemaMigrator::Migration> &SchemaMigrator::migrations()
+{
+    static const QVector<Migration> all = {
+        { 1, "Create tables", {
+            R"(CREATE TABLE IF NOT EXISTS players (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL UNIQUE,
+                handicap INTEGER NOT NULL DEFAULT 0,
+                active INTEGER NOT NULL DEFAULT 1,
+                team_id INTEGER DEFAULT NULL
+            ))",
+            R"(CREATE TABLE IF NOT EXISTS courses (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL UNIQUE
+            ))",
+            R"(CREATE TABLE IF NOT EXISTS holes (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                course_id INTEGER NOT NULL REFERENCES courses(id) ON DELETE CASCADE,
+                hole_num INTEGER NOT NULL,
+                par INTEGER NOT NULL,
+                handicap INTEGER NOT NULL,
+                UNIQUE(course_id, hole_num)
+            ))",
+            R"(CREATE TABLE IF NOT EXISTS teams (
+                id INTEGER PRIMARY KEY,
+                name TEXT NOT NULL UNIQUE
+            ))",
+            R"(CREATE TABLE IF NOT EXISTS scores (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                player_id INTEGER NOT NULL,
+                course_id INTEGER NOT NULL,
+                hole_num INTEGER NOT NULL CHECK (hole_num >= 1 AND hole_num <= 18),
+                day_num INTEGER NOT NULL CHECK (day_num >= 1 AND day_num <= 3),
+                score INTEGER,
+                UNIQUE (player_id, course_id, hole_num, day_num)
+            ))",
+            R"(CREATE TABLE IF NOT EXISTS settings (
+                key TEXT PRIMARY KEY UNIQUE,
+                value TEXT
+            ))",
+        } },
+        { 2, "Add players.team_id", {
+            "ALTER TABLE players ADD COLUMN team_id INTEGER DEFAULT NULL",
+        }, [](const QSqlDatabase &db) { return db.record("players").indexOf("team_id") != -1; } },
+        { 3, "Add covering indexes for per-day score and player lookups", {
+            // Daily leaderboards, score entry and resets filter on day and course;
+            // the trailing columns let them read everything from the index.
+            "CREATE INDEX IF NOT EXISTS idx_scores_day_course ON scores (day_num, course_id, player_id, hole_num, score)",
+            // Active-player lists and team assembly.
+            "CREATE INDEX IF NOT EXISTS idx_players_active_team ON players (active, team_id)",
+            "ANALYZE",
+        } },
+        { 4, "Count changes per table for ChangeTracker", changeCounterStatements() },
+        { 5, "Add trigger-maintained round_summaries", RoundSummaries::schemaStatements(RoundSummaries::Key::PlayerDayCourse) },
+        { 6, "Add events and key scores, settings and teams by event", eventStatements() },
+    };
+    return all;
+}
+
+int SchemaMigrator::latestVersion()
+{
+    return migrations().isEmpty() ? 0 : migrations().constLast().version;
+}
+
+int SchemaMigrator::currentVersion(const QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        qDebug() << "SchemaMigrator::currentVersion: ERROR reading user_version:" << query.lastError().text();
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+bool SchemaMigrator::migrate(QSqlDatabase &db, QString *errorMessage)
+{
+    auto fail = [&](const QString &message) {
+        qWarning() << "SchemaMigrator::migrate:" << message;
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return false;
+    };
+
+    const int startVersion = currentVersion(db);
+    if (startVersion < 0) {
+        return fail(QString("Could not read the schema version of %1.").arg(db.databaseName()));
+    }
+    if (startVersion > latestVersion()) {
+        return fail(QString("The database schema version %1 is newer than this application supports (%2).")
+                        .arg(startVersion).arg(latestVersion()));
+    }
+
+    QSqlQuery query(db);
+    for (const Migration &migration : migrations()) {
+        if (migration.version <= startVersion) {
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        if (!db.transaction()) {
+            return fail(QString("Could not start migration %1: %2").arg(migration.version).arg(db.lastError().text()));
+        }
+
+        const bool alreadyApplied = migration.alreadyApplied && migration.alreadyApplied(db);
+        for (qsizetype i = 0; !alreadyApplied && i < migration.statements.size(); ++i) {
+            const QString &statement = migration.statements.at(i);
+            if (!query.exec(statement)) {
+                QString error = query.lastError().text();
+                db.rollback();
+                return fail(QString("Migration %1 (%2) failed: %3\n%4")
+                                .arg(migration.version).arg(migration.description, error, statement.simplified()));
+            }
+        }
+
+        // PRAGMA statements cannot take bound values.
+        if (!query.exec(QString("PRAGMA user_version = %1").arg(migration.version))) {
+            QString error = query.lastError().text();
+            db.rollback();
+            return fail(QString("Could not record schema version %1: %2").arg(migration.version).arg(error));
+        }
+        if (!db.commit()) {
+            QString error = db.lastError().text();
+            db.rollback();
+            return fail(QString("Could not commit migration %1: %2").arg(migration.version).arg(error));
+        }
+
+        qDebug() << "SchemaMigrator: Applied migration" << migration.version << migration.description
+                 << "in" << timer.nsecsElapsed() / 1e6 << "ms";
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file SchemaMigrator.h
+ * @brief Contains the declaration of the SchemaMigrator class.
+ */
+
+#ifndef SCHEMAMIGRATOR_H
+#define SCHEMAMIGRATOR_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+#include <QStringList>
+#include <functional>
+
+/**
+ * @class SchemaMigrator
+ * @brief Brings the database schema up to date, one numbered migration at a time.
+ *
+ * The schema version is stored in PRAGMA user_version. migrate() runs every
+ * migration newer than the stored version in ascending order. Each one runs in
+ * its own transaction together with the version update, so it is applied
+ * exactly once or not at all. Databases created before versioning report
+ * version 0; the first migration only creates what is missing, so it is safe
+ * for them.
+ */
+class SchemaMigrator
+{
+public:
+    /**
+     * @struct Migration
+     * @brief One step of the schema history.
+     */
+    struct Migration {
+        int version;            ///< The user_version after this migration.
+        QString description;    ///< A short description for the log.
+        QStringList statements; ///< The SQL statements to run, in order.
+        /// Optional check for databases that already have the change from before versioning.
+        std::function<bool(const QSqlDatabase &)> alreadyApplied;
+    };
+
+    /**
+     * @brief Gets every migration, ordered by version.
+     */
+    static const QVector<Migration> &migrations();
+
+    /**
+     * @brief Gets the version of the newest migration.
+     */
+    static int latestVersion();
+
+    /**
+     * @brief Reads the schema version of a database.
+     * @return The version, or -1 if it could not be read.
+     */
+    static int currentVersion(const QSqlDatabase &db);
+
+    /**
+     * @brief Runs all pending migrations.
+     * @param db An open read-write connection.
+     * @param errorMessage Receives a description of the failure, if any.
+     * @return True if the schema is at latestVersion().
+     */
+    static bool migrate(QSqlDatabase &db, QString *errorMessage = nullptr);
+
+    /**
+     * @brief Builds the trigger that bumps a change counter on one kind of write to a table.
+     *
+     * The trigger is named trg_<table>_<operation>_changed.
+     *
+     * @param table The table to watch.
+     * @param operation "INSERT", "UPDATE" or "DELETE".
+     * @param counter The row in change_counters to bump.
+     */
+    static QString changeCounterTrigger(const QString &table, const QString &operation, const QString &counter);
+};
+
+#endif // SCHEMAMIGRATOR_H
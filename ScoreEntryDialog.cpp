@@ -4,10 +4,14 @@
  */
 
 #include "ScoreEntryDialog.h"
+#include "TournamentRepository.h"
+#include "BulkImporter.h"
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QMessageBox>
+#include <QFileDialog>
+#include <QDir>
 #include <QPushButton>
 #include <QDebug>
 #include <QHeaderView>
@@ -15,94 +19,36 @@
 ScoreEntryDialog::ScoreEntryDialog(const QString &connectionName, QWidget *parent)
     : QDialog(parent)
     , m_connectionName(connectionName)
+    , m_roster(ScoreRoster::load(connectionName))
     , tabWidget(new QTabWidget(this))
-    , day1Tab(new QWidget(this))
-    , day1CourseComboBox(new QComboBox(this))
-    , day1TableView(new QTableView(this))
-    , day1ScoreModel(new ScoreTableModel(m_connectionName, 1, this))
-    , day2Tab(new QWidget(this))
-    , day2CourseComboBox(new QComboBox(this))
-    , day2TableView(new QTableView(this))
-    , day2ScoreModel(new ScoreTableModel(m_connectionName, 2, this))
-    , day3Tab(new QWidget(this))
-    , day3CourseComboBox(new QComboBox(this))
-    , day3TableView(new QTableView(this))
-    , day3ScoreModel(new ScoreTableModel(m_connectionName, 3, this))
 {
     QSqlDatabase db = database();
     if (!db.isValid() || !db.isOpen()) {
          qDebug() << "ScoreEntryDialog: ERROR: Invalid or closed database connection passed to constructor.";
     }
 
-    tabWidget->addTab(day1Tab, tr("Day 1"));
-    tabWidget->addTab(day2Tab, tr("Day 2"));
-    tabWidget->addTab(day3Tab, tr("Day 3"));
-
-    QVBoxLayout *day1Layout = new QVBoxLayout(day1Tab);
-    QHBoxLayout *day1CourseLayout = new QHBoxLayout();
-    day1CourseLayout->addWidget(new QLabel(tr("Course:"), day1Tab));
-    day1CourseLayout->addWidget(day1CourseComboBox);
-    day1CourseLayout->addStretch();
-    day1Layout->addLayout(day1CourseLayout);
-    day1Layout->addWidget(day1TableView);
-
-    QVBoxLayout *day2Layout = new QVBoxLayout(day2Tab);
-    QHBoxLayout *day2CourseLayout = new QHBoxLayout();
-    day2CourseLayout->addWidget(new QLabel(tr("Course:"), day2Tab));
-    day2CourseLayout->addWidget(day2CourseComboBox);
-    day2CourseLayout->addStretch();
-    day2Layout->addLayout(day2CourseLayout);
-    day2Layout->addWidget(day2TableView);
-
-    QVBoxLayout *day3Layout = new QVBoxLayout(day3Tab);
-    QHBoxLayout *day3CourseLayout = new QHBoxLayout();
-    day3CourseLayout->addWidget(new QLabel(tr("Course:"), day3Tab));
-    day3CourseLayout->addWidget(day3CourseComboBox);
-    day3CourseLayout->addStretch();
-    day3Layout->addLayout(day3CourseLayout);
-    day3Layout->addWidget(day3TableView);
-
-    day1TableView->setModel(day1ScoreModel);
-    day2TableView->setModel(day2ScoreModel);
-    day3TableView->setModel(day3ScoreModel);
-
-    day1TableView->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
-    for(int i = 1; i <= 18; ++i) {
-        day1TableView->horizontalHeader()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
+    for (int dayNum = 1; dayNum <= DayCount; ++dayNum) {
+        m_days[dayNum - 1].page = new QWidget(tabWidget);
+        tabWidget->addTab(m_days[dayNum - 1].page, tr("Day %1").arg(dayNum));
     }
-    day1TableView->verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-
-    day2TableView->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
-    for(int i = 1; i <= 18; ++i) {
-        day2TableView->horizontalHeader()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
-    }
-    day2TableView->verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-
-    day3TableView->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
-    for(int i = 1; i <= 18; ++i) {
-        day3TableView->horizontalHeader()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
-    }
-    day3TableView->verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-
-    populateCourseComboBoxes();
-    loadSavedCourseSelections();
-
-    connect(day1CourseComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ScoreEntryDialog::onDay1CourseSelected);
-    connect(day2CourseComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ScoreEntryDialog::onDay2CourseSelected);
-    connect(day3CourseComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ScoreEntryDialog::onDay3CourseSelected);
+    ensureDayTab(tabWidget->currentIndex() + 1);
+    connect(tabWidget, &QTabWidget::currentChanged, this, &ScoreEntryDialog::onTabChanged);
 
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     mainLayout->addWidget(tabWidget);
     
+    QPushButton *importButton = new QPushButton(tr("Import Scores..."), this);
     QPushButton *resetButton = new QPushButton(tr("Reset Data"), this);
     QPushButton *closeButton = new QPushButton(tr("Close"), this);
     QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(importButton);
     buttonLayout->addStretch();
     buttonLayout->addWidget(resetButton);
     buttonLayout->addWidget(closeButton);
     mainLayout->addLayout(buttonLayout);
     connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
     connect(resetButton, &QPushButton::clicked, this, &ScoreEntryDialog::clearData);
+    connect(importButton, &QPushButton::clicked, this, &ScoreEntryDialog::importScores);
 
     setLayout(mainLayout);
     setWindowTitle(tr("Tournament Score Entry"));
@@ -111,88 +57,140 @@ ScoreEntryDialog::ScoreEntryDialog(const QString &connectionName, QWidget *paren
 
 ScoreEntryDialog::~ScoreEntryDialog()
 {
+    flushPendingScores();
 }
 
-QSqlDatabase ScoreEntryDialog::database() const
+void ScoreEntryDialog::done(int result)
 {
-    return QSqlDatabase::database(m_connectionName);
+    flushPendingScores();
+    QDialog::done(result);
 }
 
 /**
- * @brief Populates the course combo boxes with data from the database.
+ * @brief Writes the scores still queued by every day's score table.
  */
-void ScoreEntryDialog::populateCourseComboBoxes()
+void ScoreEntryDialog::flushPendingScores()
 {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "ScoreEntryDialog::populateCourseComboBoxes: ERROR: Invalid or closed database connection.";
-        return;
+    for (const DayTab &day : m_days) {
+        if (day.model) {
+            day.model->flushPendingScores();
+        }
     }
+}
 
-    day1CourseComboBox->clear();
-    day2CourseComboBox->clear();
-    day3CourseComboBox->clear();
-
-    day1CourseComboBox->addItem(tr("-- Select Course --"), -1);
-    day2CourseComboBox->addItem(tr("-- Select Course --"), -1);
-    day3CourseComboBox->addItem(tr("-- Select Course --"), -1);
-
-    QSqlQuery query(db);
-    if (query.exec("SELECT id, name FROM courses ORDER BY name")) {
-        while (query.next()) {
-            int courseId = query.value("id").toInt();
-            QString courseName = query.value("name").toString();
-            day1CourseComboBox->addItem(courseName, courseId);
-            day2CourseComboBox->addItem(courseName, courseId);
-            day3CourseComboBox->addItem(courseName, courseId);
-        }
-    } else {
-        qDebug() << "ScoreEntryDialog::populateCourseComboBoxes: ERROR executing query:" << query.lastError().text();
+/**
+ * @brief Writes pending scores and builds the newly shown day's tab if needed.
+ * @param index The index of the shown tab.
+ */
+void ScoreEntryDialog::onTabChanged(int index)
+{
+    flushPendingScores();
+    if (index >= 0 && index < DayCount) {
+        ensureDayTab(index + 1);
     }
 }
 
 /**
- * @brief Loads saved course selections from the settings table and sets the combo boxes.
+ * @brief Builds a day's tab the first time it is needed.
+ *
+ * The course selector is filled from the shared roster and set to the course
+ * saved for the day, whose scores the new model then loads.
+ *
+ * @param dayNum The day number (1 to DayCount).
+ * @return The day's tab.
  */
-void ScoreEntryDialog::loadSavedCourseSelections()
+ScoreEntryDialog::DayTab &ScoreEntryDialog::ensureDayTab(int dayNum)
 {
-    day1CourseComboBox->blockSignals(true);
-    day2CourseComboBox->blockSignals(true);
-    day3CourseComboBox->blockSignals(true);
-
-    int day1CourseId = getSavedCourseSelection(1);
-    int day1Index = day1CourseComboBox->findData(day1CourseId);
-    if (day1Index != -1) {
-        day1CourseComboBox->setCurrentIndex(day1Index);
-        onDay1CourseSelected(day1Index);
-    } else {
-        day1CourseComboBox->setCurrentIndex(day1CourseComboBox->findData(-1));
-        onDay1CourseSelected(day1CourseComboBox->findData(-1));
+    DayTab &day = m_days[dayNum - 1];
+    if (day.model) {
+        return day;
     }
 
-    int day2CourseId = getSavedCourseSelection(2);
-    int day2Index = day2CourseComboBox->findData(day2CourseId);
-    if (day2Index != -1) {
-        day2CourseComboBox->setCurrentIndex(day2Index);
-        onDay2CourseSelected(day2Index);
-    } else {
-        day2CourseComboBox->setCurrentIndex(day2CourseComboBox->findData(-1));
-         onDay2CourseSelected(day2CourseComboBox->findData(-1));
+    day.courseComboBox = new QComboBox(day.page);
+    day.tableView = new QTableView(day.page);
+    day.model = new ScoreTableModel(m_connectionName, dayNum, m_roster, this);
+
+    QVBoxLayout *layout = new QVBoxLayout(day.page);
+    QHBoxLayout *courseLayout = new QHBoxLayout();
+    courseLayout->addWidget(new QLabel(tr("Course:"), day.page));
+    courseLayout->addWidget(day.courseComboBox);
+    courseLayout->addStretch();
+    layout->addLayout(courseLayout);
+    layout->addWidget(day.tableView);
+
+    day.tableView->setModel(day.model);
+    day.tableView->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    for(int i = 1; i <= 18; ++i) {
+        day.tableView->horizontalHeader()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
     }
+    day.tableView->verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
 
-    int day3CourseId = getSavedCourseSelection(3);
-    int day3Index = day3CourseComboBox->findData(day3CourseId);
-    if (day3Index != -1) {
-        day3CourseComboBox->setCurrentIndex(day3Index);
-        onDay3CourseSelected(day3Index);
-    } else {
-        day3CourseComboBox->setCurrentIndex(day3CourseComboBox->findData(-1));
-         onDay3CourseSelected(day3CourseComboBox->findData(-1));
+    day.courseComboBox->addItem(tr("-- Select Course --"), -1);
+    for (const ScoreRoster::Course &course : m_roster.courses()) {
+        day.courseComboBox->addItem(course.name, course.id);
+    }
+    int index = day.courseComboBox->findData(getSavedCourseSelection(dayNum));
+    if (index == -1) {
+        index = day.courseComboBox->findData(-1);
+    }
+    day.courseComboBox->setCurrentIndex(index);
+    onCourseSelected(dayNum, index);
+
+    connect(day.courseComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            [this, dayNum](int index) { onCourseSelected(dayNum, index); });
+    connect(day.model, &ScoreTableModel::scoreSaved, this, &ScoreEntryDialog::scoreSaved);
+    connect(day.model, &ScoreTableModel::scoresNotSaved, this, &ScoreEntryDialog::showScoresNotSaved);
+    return day;
+}
+
+/**
+ * @brief Tells the user which scores could not be saved.
+ * @param cells A description of each score that was not saved.
+ * @param error The database error.
+ */
+void ScoreEntryDialog::showScoresNotSaved(const QStringList &cells, const QString &error)
+{
+    QMessageBox::warning(this, tr("Scores Not Saved"),
+                         tr("The following scores could not be saved and have been reverted:\n%1\n\n%2")
+                             .arg(cells.join("\n"), error));
+}
+
+/**
+ * @brief Imports scores of the current event from a CSV file and reloads every day.
+ *
+ * The file has the columns player_id, course_id, day_num, hole_num and score;
+ * existing scores for the same cell are replaced.
+ */
+void ScoreEntryDialog::importScores()
+{
+    QString filePath = QFileDialog::getOpenFileName(this, tr("Import Scores"), QDir::homePath(),
+                                                    tr("CSV Files (*.csv);;All Files (*)"));
+    if (filePath.isEmpty()) {
+        return;
+    }
+    if (BulkImporter::detectFileFormat(filePath) != BulkImporter::Format::Scores) {
+        QMessageBox::warning(this, tr("Import Scores"),
+                             tr("The file needs the columns player_id, course_id, day_num, hole_num and score."));
+        return;
     }
 
-    day1CourseComboBox->blockSignals(false);
-    day2CourseComboBox->blockSignals(false);
-    day3CourseComboBox->blockSignals(false);
+    // Queued edits are written first so the imported scores replace them, not the other way round.
+    flushPendingScores();
+    BulkImporter::importWithProgress(m_connectionName, filePath, this);
+
+    for (const DayTab &day : m_days) {
+        if (!day.model) {
+            continue; // Loads the imported scores when first shown.
+        }
+        // Selecting the same course again does not reload it, so clear the model first.
+        day.model->setCourseId(-1);
+        day.model->setCourseId(day.courseComboBox->currentData().toInt());
+    }
+}
+
+QSqlDatabase ScoreEntryDialog::database() const
+{
+    return QSqlDatabase::database(m_connectionName);
 }
 
 /**
@@ -211,13 +209,9 @@ void ScoreEntryDialog::saveCourseSelection(int dayNum, int courseId)
     QString key = QString("day%1_course_id").arg(dayNum);
     QString value = QString::number(courseId);
 
-    QSqlQuery query(db);
-    query.prepare("INSERT OR REPLACE INTO settings (key, value) VALUES (:key, :value);");
-    query.bindValue(":key", key);
-    query.bindValue(":value", value);
-
-    if (!query.exec()) {
-        qDebug() << "ScoreEntryDialog::saveCourseSelection: ERROR saving setting" << key << ":" << query.lastError().text();
+    TournamentRepository &repository = TournamentRepository::forConnection(m_connectionName);
+    if (!repository.writeSetting(key, value)) {
+        qDebug() << "ScoreEntryDialog::saveCourseSelection: ERROR saving setting" << key << ":" << repository.lastError();
     }
 }
 
@@ -235,17 +229,15 @@ int ScoreEntryDialog::getSavedCourseSelection(int dayNum)
     }
 
     QString key = QString("day%1_course_id").arg(dayNum);
-    QSqlQuery query(db);
-    query.prepare("SELECT value FROM settings WHERE key = :key;");
-    query.bindValue(":key", key);
+    QVariant value = TournamentRepository::forConnection(m_connectionName).readSetting(key);
 
-    if (query.exec() && query.next()) {
+    if (value.isValid()) {
         bool ok;
-        int savedValue = query.value(0).toInt(&ok);
+        int savedValue = value.toInt(&ok);
         if (ok) {
             return savedValue;
         } else {
-            qDebug() << "ScoreEntryDialog::getSavedCourseSelection: Conversion failed for setting" << key << ". Value was:" << query.value(0).toString();
+            qDebug() << "ScoreEntryDialog::getSavedCourseSelection: Conversion failed for setting" << key << ". Value was:" << value.toString();
             return -1;
         }
     } else {
@@ -255,36 +247,16 @@ int ScoreEntryDialog::getSavedCourseSelection(int dayNum)
 }
 
 /**
- * @brief Slot for when the course for Day 1 is selected.
- * @param index The index of the selected item in the combo box.
- */
-void ScoreEntryDialog::onDay1CourseSelected(int index)
-{
-    int courseId = day1CourseComboBox->itemData(index).toInt();
-    day1ScoreModel->setCourseId(courseId);
-    saveCourseSelection(1, courseId);
-}
-
-/**
- * @brief Slot for when the course for Day 2 is selected.
- * @param index The index of the selected item in the combo box.
- */
-void ScoreEntryDialog::onDay2CourseSelected(int index)
-{
-    int courseId = day2CourseComboBox->itemData(index).toInt();
-    day2ScoreModel->setCourseId(courseId);
-    saveCourseSelection(2, courseId);
-}
-
-/**
- * @brief Slot for when the course for Day 3 is selected.
- * @param index The index of the selected item in the combo box.
+ * @brief Loads the course chosen for a day and remembers the choice.
+ * @param dayNum The day number (1 to DayCount).
+ * @param index The index of the selected item in the day's combo box.
  */
-void ScoreEntryDialog::onDay3CourseSelected(int index)
+void ScoreEntryDialog::onCourseSelected(int dayNum, int index)
 {
-    int courseId = day3CourseComboBox->itemData(index).toInt();
-    day3ScoreModel->setCourseId(courseId);
-    saveCourseSelection(3, courseId);
+    const DayTab &day = m_days[dayNum - 1];
+    int courseId = day.courseComboBox->itemData(index).toInt();
+    day.model->setCourseId(courseId);
+    saveCourseSelection(dayNum, courseId);
 }
 
 /**
@@ -295,31 +267,13 @@ void ScoreEntryDialog::clearData()
     int currentDayIndex = tabWidget->currentIndex();
     int currentDayNum = currentDayIndex + 1;
 
-    int currentCourseId = -1;
-    ScoreTableModel *currentModel = nullptr;
-    QComboBox *currentComboBox = nullptr;
-
-    switch (currentDayNum) {
-        case 1:
-            currentComboBox = day1CourseComboBox;
-            currentModel = day1ScoreModel;
-            break;
-        case 2:
-            currentComboBox = day2CourseComboBox;
-            currentModel = day2ScoreModel;
-            break;
-        case 3:
-            currentComboBox = day3CourseComboBox;
-            currentModel = day3ScoreModel;
-            break;
-        default:
-            qDebug() << "ScoreEntryDialog::resetScores: ERROR: Invalid current day index:" << currentDayIndex;
-            return;
-    }
-
-    if (currentComboBox) {
-        currentCourseId = currentComboBox->itemData(currentComboBox->currentIndex()).toInt();
+    if (currentDayIndex < 0 || currentDayIndex >= DayCount) {
+        qDebug() << "ScoreEntryDialog::resetScores: ERROR: Invalid current day index:" << currentDayIndex;
+        return;
     }
+    ScoreTableModel *currentModel = ensureDayTab(currentDayNum).model;
+    QComboBox *currentComboBox = m_days[currentDayIndex].courseComboBox;
+    int currentCourseId = currentComboBox->itemData(currentComboBox->currentIndex()).toInt();
 
     if (currentCourseId <= 0) {
         QMessageBox::information(this, tr("Reset Scores"), tr("Please select a course before resetting scores for this day."));
@@ -332,6 +286,8 @@ void ScoreEntryDialog::clearData()
                                   QMessageBox::Yes | QMessageBox::No);
 
     if (reply == QMessageBox::Yes) {
+        currentModel->flushPendingScores();
+
         QSqlDatabase db = database();
         if (!db.isValid() || !db.isOpen()) {
             qDebug() << "ScoreEntryDialog::resetScores: ERROR: Invalid or closed database connection.";
@@ -340,7 +296,7 @@ void ScoreEntryDialog::clearData()
         }
 
         QSqlQuery query(db);
-        query.prepare("DELETE FROM scores WHERE day_num = :dnum AND course_id = :cid;");
+        query.prepare("DELETE FROM scores WHERE event_id = (SELECT id FROM current_event) AND day_num = :dnum AND course_id = :cid;");
         query.bindValue(":dnum", currentDayNum);
         query.bindValue(":cid", currentCourseId);
 
@@ -15,7 +15,10 @@
 #include <QHBoxLayout>
 #include <QLabel>
 
+#include <array>
+
 #include "ScoreTableModel.h"
+#include "ScoreRoster.h"
 
 /**
  * @class ScoreEntryDialog
@@ -24,6 +27,9 @@
  * This dialog provides a tabbed interface for entering scores for Day 1, Day 2,
  * and Day 3. Each tab contains a table view for score entry and a combo box
  * to select the course for that day.
+ *
+ * The active players and courses are read once into a ScoreRoster shared by
+ * every day. A day's tab is built, and its scores loaded, when it is first shown.
  */
 class ScoreEntryDialog : public QDialog
 {
@@ -42,38 +48,49 @@ public:
      */
     ~ScoreEntryDialog();
 
+    /**
+     * @brief Writes pending scores before the dialog closes.
+     * @param result The dialog result.
+     */
+    void done(int result) override;
+
+signals:
+    /**
+     * @brief Emitted after any day's score table saves a score.
+     * @see ScoreTableModel::scoreSaved
+     */
+    void scoreSaved(int playerId, int courseId, int dayNum, int holeNum, int score);
+
 private slots:
-    void onDay1CourseSelected(int index);
-    void onDay2CourseSelected(int index);
-    void onDay3CourseSelected(int index);
+    void onTabChanged(int index);
     void clearData();
+    void importScores();
+    void flushPendingScores();
+    void showScoresNotSaved(const QStringList &cells, const QString &error);
 
 private:
-    QString m_connectionName; ///< The name of the database connection.
-
-    QTabWidget *tabWidget; ///< The main tab widget for days.
+    static constexpr int DayCount = 3; ///< The number of tournament days.
 
-    // Day 1 Tab Widgets
-    QWidget *day1Tab;
-    QComboBox *day1CourseComboBox;
-    QTableView *day1TableView;
-    ScoreTableModel *day1ScoreModel;
+    /**
+     * @struct DayTab
+     * @brief One day's tab. Only the page exists until the tab is first shown.
+     */
+    struct DayTab {
+        QWidget *page = nullptr;
+        QComboBox *courseComboBox = nullptr;
+        QTableView *tableView = nullptr;
+        ScoreTableModel *model = nullptr;
+    };
 
-    // Day 2 Tab Widgets
-    QWidget *day2Tab;
-    QComboBox *day2CourseComboBox;
-    QTableView *day2TableView;
-    ScoreTableModel *day2ScoreModel;
+    QString m_connectionName; ///< The name of the database connection.
+    ScoreRoster m_roster;     ///< The active players and courses, shared by every day.
 
-    // Day 3 Tab Widgets
-    QWidget *day3Tab;
-    QComboBox *day3CourseComboBox;
-    QTableView *day3TableView;
-    ScoreTableModel *day3ScoreModel;
+    QTabWidget *tabWidget;                  ///< The main tab widget for days.
+    std::array<DayTab, DayCount> m_days;    ///< The tabs of day 1 to DayCount.
 
-    void populateCourseComboBoxes();
     QSqlDatabase database() const;
-    void loadSavedCourseSelections();
+    DayTab &ensureDayTab(int dayNum);
+    void onCourseSelected(int dayNum, int index);
     void saveCourseSelection(int dayNum, int courseId);
     int getSavedCourseSelection(int dayNum);
 };
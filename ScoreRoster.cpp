@@ -0,0 +1,72 @@
+/**
+ * @file ScoreRoster.cpp
+ * @brief Implements the ScoreRoster class.
+ */
+
+#include "ScoreRoster.h"
+#include <QSharedData>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+/**
+ * @class ScoreRosterData
+ * @brief The shared payload behind a ScoreRoster.
+ */
+class ScoreRosterData : public QSharedData
+{
+public:
+    QVector<PlayerInfo> players;
+    QVector<ScoreRoster::Course> courses;
+};
+
+ScoreRoster::ScoreRoster()
+    : d(new ScoreRosterData)
+{
+}
+
+ScoreRoster::ScoreRoster(const ScoreRoster &other) = default;
+
+ScoreRoster &ScoreRoster::operator=(const ScoreRoster &other) = default;
+
+ScoreRoster::~ScoreRoster() = default;
+
+ScoreRoster ScoreRoster::load(const QString &connectionName)
+{
+    ScoreRoster roster;
+    QSqlDatabase db = QSqlDatabase::database(connectionName);
+    if (!db.isValid() || !db.isOpen()) {
+        qDebug() << "ScoreRoster::load: ERROR: Invalid or closed database connection.";
+        return roster;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (query.exec("SELECT id, name, handicap FROM players WHERE active = 1 ORDER BY name")) {
+        while (query.next()) {
+            roster.d->players.append({ query.value(0).toInt(), query.value(1).toString(), query.value(2).toInt() });
+        }
+    } else {
+        qDebug() << "ScoreRoster::load: ERROR reading players:" << query.lastError().text();
+    }
+
+    if (query.exec("SELECT id, name FROM courses ORDER BY name")) {
+        while (query.next()) {
+            roster.d->courses.append({ query.value(0).toInt(), query.value(1).toString() });
+        }
+    } else {
+        qDebug() << "ScoreRoster::load: ERROR reading courses:" << query.lastError().text();
+    }
+    return roster;
+}
+
+const QVector<PlayerInfo> &ScoreRoster::players() const
+{
+    return d->players;
+}
+
+const QVector<ScoreRoster::Course> &ScoreRoster::courses() const
+{
+    return d->courses;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file ScoreRoster.h
+ * @brief Contains the declaration of the ScoreRoster class.
+ */
+
+#ifndef SCOREROSTER_H
+#define SCOREROSTER_H
+
+#include <QSharedDataPointer>
+#include <QString>
+#include <QVector>
+
+#include "CommonStructs.h"
+
+class ScoreRosterData;
+
+/**
+ * @class ScoreRoster
+ * @brief The active players and courses offered for score entry.
+ *
+ * The roster is read once and implicitly shared, so every day's
+ * ScoreTableModel and course selector in a ScoreEntryDialog use the same
+ * lists instead of each querying them.
+ */
+class ScoreRoster
+{
+public:
+    /**
+     * @struct Course
+     * @brief The identifier and name of a course.
+     */
+    struct Course {
+        int id;         ///< The unique identifier for the course.
+        QString name;   ///< The name of the course.
+    };
+
+    /**
+     * @brief Constructs an empty roster.
+     */
+    ScoreRoster();
+    ScoreRoster(const ScoreRoster &other);
+    ScoreRoster &operator=(const ScoreRoster &other);
+    ~ScoreRoster();
+
+    /**
+     * @brief Reads the active players and the courses.
+     * @param connectionName The name of the database connection to use.
+     * @return The roster; empty lists are logged if a query fails.
+     */
+    static ScoreRoster load(const QString &connectionName);
+
+    /** @brief The active players, ordered by name. */
+    const QVector<PlayerInfo> &players() const;
+
+    /** @brief The courses, ordered by name. */
+    const QVector<Course> &courses() const;
+
+private:
+    QSharedDataPointer<ScoreRosterData> d;
+};
+
+#endif // SCOREROSTER_H
@@ -4,19 +4,34 @@
  */
 
 #include "ScoreTableModel.h"
+#include "TournamentRepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QSqlRecord>
 #include <QSqlField>
+#include <memory>
 
-ScoreTableModel::ScoreTableModel(const QString &connectionName, int dayNum, QObject *parent)
+namespace {
+/// The tables a score grid is read from.
+constexpr ChangeTracker::Tables grid_dependencies = ChangeTracker::Scores | ChangeTracker::Holes |
+                                                    ChangeTracker::Players | ChangeTracker::Events;
+}
+
+ScoreTableModel::ScoreTableModel(const QString &connectionName, int dayNum, const ScoreRoster &roster, QObject *parent)
     : QAbstractTableModel(parent), m_connectionName(connectionName), m_dayNum(dayNum), m_currentCourseId(-1)
+    , m_activePlayers(roster.players())
+    , m_writeQueue(new ScoreWriteQueue(connectionName, this))
+    , m_courseCache(MaxCachedCourses)
+    , m_changeTracker(connectionName)
 {
-    loadActivePlayers();
+    connect(m_writeQueue, &ScoreWriteQueue::aboutToWrite, this, &ScoreTableModel::onAboutToWrite);
+    connect(m_writeQueue, &ScoreWriteQueue::scoresSaved, this, &ScoreTableModel::onScoresSaved);
+    connect(m_writeQueue, &ScoreWriteQueue::scoresNotSaved, this, &ScoreTableModel::onScoresNotSaved);
 }
 
 ScoreTableModel::~ScoreTableModel()
 {
+    m_writeQueue->flush();
 }
 
 QSqlDatabase ScoreTableModel::database() const
@@ -136,20 +151,20 @@ bool ScoreTableModel::setData(const QModelIndex &index, const QVariant &value, i
         return true;
     }
 
-    bool saveSuccess = saveScore(player->id, holeNum, newScore);
-    if (!saveSuccess) {
-        m_scores[player->id][holeNum] = oldScore;
-        emit dataChanged(index, index, {role});
-        qDebug() << "ScoreTableModel::setData: ERROR: Database save failed for Player" << player->id << "Hole" << holeNum;
-        return false;
-    }
-
+    m_writeQueue->enqueue(player->id, m_currentCourseId, m_dayNum, holeNum, newScore);
     emit dataChanged(index, index, {role});
     return true;
 }
 
 void ScoreTableModel::setCourseId(int courseId)
 {
+    flushPendingScores();
+
+    // The shown grid is cached only if nothing else wrote since it was loaded.
+    if (validateCache() && m_currentCourseId > 0 && m_currentCourseId != courseId) {
+        m_courseCache.insert(m_currentCourseId, new CourseGrid{ m_holeDetails, m_scores });
+    }
+
     if (m_currentCourseId == courseId || courseId <= 0) {
         if (m_currentCourseId > 0) {
             beginResetModel();
@@ -165,37 +180,32 @@ void ScoreTableModel::setCourseId(int courseId)
 
     m_currentCourseId = courseId;
     beginResetModel();
-    m_holeDetails.clear();
-    m_scores.clear();
-    loadHoleDetails(m_currentCourseId);
-    loadScores(m_currentCourseId);
+    std::unique_ptr<CourseGrid> cached(m_courseCache.take(courseId));
+    if (cached) {
+        m_holeDetails = std::move(cached->holeDetails);
+        m_scores = std::move(cached->scores);
+    } else {
+        m_holeDetails.clear();
+        m_scores.clear();
+        loadHoleDetails(m_currentCourseId);
+        loadScores(m_currentCourseId);
+    }
     endResetModel();
 }
 
 /**
- * @brief Loads the list of active players from the database.
+ * @brief Drops the cached grids if the database was written by anyone else since they were read.
+ * @return True if the cache, and the shown grid, still match the database.
  */
-void ScoreTableModel::loadActivePlayers()
+bool ScoreTableModel::validateCache()
 {
-    m_activePlayers.clear();
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "ScoreTableModel::loadActivePlayers: ERROR: Invalid or closed database connection.";
-        return;
-    }
-
-    QSqlQuery query(db);
-    if (query.exec("SELECT id, name, handicap FROM players WHERE active = 1 ORDER BY name")) {
-        while (query.next()) {
-            PlayerInfo player;
-            player.id = query.value("id").toInt();
-            player.name = query.value("name").toString();
-            player.handicap = query.value("handicap").toInt();
-            m_activePlayers.append(player);
-        }
-    } else {
-        qDebug() << "ScoreTableModel::loadActivePlayers: ERROR executing query:" << query.lastError().text();
+    const ChangeTracker::Stamp stamp = m_changeTracker.current();
+    if (!(ChangeTracker::changedBetween(m_cacheStamp, stamp) & grid_dependencies)) {
+        return true;
     }
+    m_courseCache.clear();
+    m_cacheStamp = stamp;
+    return false;
 }
 
 /**
@@ -240,31 +250,16 @@ void ScoreTableModel::loadScores(int courseId)
         return;
     }
 
-    QStringList activePlayerIds;
-    for (const auto &player : m_activePlayers) {
-        activePlayerIds << QString::number(player.id);
-    }
-
-    if (activePlayerIds.isEmpty()) {
+    if (m_activePlayers.isEmpty()) {
         qDebug() << "ScoreTableModel::loadScores: No active players to load scores for.";
         return;
     }
 
-    QSqlQuery query(db);
-    QString queryString = QString("SELECT player_id, hole_num, score FROM scores WHERE day_num = %1 AND course_id = %2 AND player_id IN (%3);")
-                              .arg(m_dayNum)
-                              .arg(courseId)
-                              .arg(activePlayerIds.join(","));
-
-    if (query.exec(queryString)) {
-        while (query.next()) {
-            int playerId = query.value("player_id").toInt();
-            int holeNum = query.value("hole_num").toInt();
-            int score = query.value("score").toInt();
-            m_scores[playerId][holeNum] = score;
-        }
-    } else {
-        qDebug() << "ScoreTableModel::loadScores: ERROR executing query:" << query.lastError().text();
+    TournamentRepository &repository = TournamentRepository::forConnection(m_connectionName);
+    bool ok = false;
+    m_scores = repository.roundScores(m_dayNum, courseId, &ok);
+    if (!ok) {
+        qDebug() << "ScoreTableModel::loadScores: ERROR executing query:" << repository.lastError();
     }
 }
 
@@ -292,34 +287,62 @@ int ScoreTableModel::getHoleForColumn(int column) const
     return -1;
 }
 
+bool ScoreTableModel::flushPendingScores()
+{
+    return m_writeQueue->flush();
+}
+
 /**
- * @brief Saves a single score to the database.
- * @param playerId The ID of the player.
- * @param holeNum The hole number.
- * @param score The score to save.
- * @return True if the score was saved successfully, false otherwise.
+ * @brief Checks the cache before the write queue changes the database.
+ *
+ * The queue only writes scores of the shown course, which are already in the
+ * model, so its writes are taken into the stamp once they are committed.
  */
-bool ScoreTableModel::saveScore(int playerId, int holeNum, int score)
+void ScoreTableModel::onAboutToWrite()
 {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "ScoreTableModel::saveScore: ERROR: Invalid or closed database connection.";
-        return false;
+    if (!validateCache()) {
+        // Something else wrote first; the shown grid may be stale too.
+        m_cacheStamp = ChangeTracker::Stamp();
     }
+}
 
-    QSqlQuery query(db);
-    query.prepare("INSERT OR REPLACE INTO scores (player_id, course_id, hole_num, day_num, score) "
-                  "VALUES (:pid, :cid, :hnum, :dnum, :score);");
-    query.bindValue(":pid", playerId);
-    query.bindValue(":cid", m_currentCourseId);
-    query.bindValue(":hnum", holeNum);
-    query.bindValue(":dnum", m_dayNum);
-    query.bindValue(":score", score);
+/**
+ * @brief Reports each score of a committed batch as saved.
+ * @param scores The scores that were written.
+ */
+void ScoreTableModel::onScoresSaved(const QVector<PendingScore> &scores)
+{
+    if (m_cacheStamp.isValid()) {
+        m_cacheStamp = m_changeTracker.current();
+    }
+    for (const PendingScore &pending : scores) {
+        emit scoreSaved(pending.playerId, pending.courseId, pending.dayNum, pending.holeNum, pending.score);
+    }
+}
 
-    if (query.exec()) {
-        return true;
-    } else {
-        qDebug() << "ScoreTableModel::saveScore: ERROR executing query:" << query.lastError().text();
-        return false;
+/**
+ * @brief Reverts the cells of a rolled back batch to the scores in the database.
+ * @param scores The scores that were not written.
+ * @param error The database error.
+ */
+void ScoreTableModel::onScoresNotSaved(const QVector<PendingScore> &scores, const QString &error)
+{
+    QStringList cells;
+    for (const PendingScore &pending : scores) {
+        QString playerName = QString::number(pending.playerId);
+        for (const auto &player : m_activePlayers) {
+            if (player.id == pending.playerId) {
+                playerName = player.name;
+                break;
+            }
+        }
+        cells << tr("%1, Day %2, Hole %3: %4").arg(playerName).arg(pending.dayNum).arg(pending.holeNum).arg(pending.score);
+    }
+    qDebug() << "ScoreTableModel::onScoresNotSaved: ERROR:" << scores.size() << "scores were not saved:" << error << cells;
+
+    if (m_currentCourseId > 0 && rowCount() > 0) {
+        loadScores(m_currentCourseId);
+        emit dataChanged(index(0, 1), index(rowCount() - 1, 18), {Qt::DisplayRole, Qt::EditRole});
     }
+    emit scoresNotSaved(cells, error);
 }
@@ -11,32 +11,46 @@
 #include <QVector>
 #include <QVariant>
 #include <QString>
+#include <QStringList>
 #include <QMap>
 #include <QPair>
+#include <QCache>
 #include <QDebug>
 
 #include "CommonStructs.h"
+#include "ScoreWriteQueue.h"
+#include "ChangeTracker.h"
+#include "ScoreRoster.h"
 
 /**
  * @class ScoreTableModel
  * @brief A model for entering and displaying scores for a single day.
  *
  * This model provides a table view with players as rows and holes as columns
- * for score entry. It fetches data from the database and handles saving
- * scores as they are entered.
+ * for score entry. It fetches data from the database and saves scores as
+ * they are entered. Edits show immediately and are written in batches by a
+ * ScoreWriteQueue.
+ *
+ * The grids of the last few courses shown are kept in an LRU cache, so
+ * switching back to one does not query the database. The cache is dropped
+ * whenever a ChangeTracker reports that scores, holes, players or events were
+ * written by anything other than this model's own write queue.
  */
 class ScoreTableModel : public QAbstractTableModel
 {
     Q_OBJECT
 
 public:
+    static constexpr int MaxCachedCourses = 8; ///< The course grids kept besides the one shown.
+
     /**
      * @brief Constructs a ScoreTableModel object.
      * @param connectionName The name of the database connection to use.
      * @param dayNum The day number (1, 2, or 3) this model represents.
+     * @param roster The active players shown as rows, shared with the other days.
      * @param parent The parent object.
      */
-    explicit ScoreTableModel(const QString &connectionName, int dayNum, QObject *parent = nullptr);
+    ScoreTableModel(const QString &connectionName, int dayNum, const ScoreRoster &roster, QObject *parent = nullptr);
 
     /**
      * @brief Destroys the ScoreTableModel object.
@@ -54,13 +68,55 @@ public:
     /**
      * @brief Sets the course ID to load data for.
      *
-     * This method triggers loading players, hole details, and scores for the given course.
+     * This method triggers loading hole details and scores for the given course,
+     * unless an unchanged copy of them is cached.
      *
      * @param courseId The ID of the course to load.
      */
     void setCourseId(int courseId);
 
+    /**
+     * @brief Writes any scores that are still waiting in the write queue.
+     * @return True if nothing was pending or every score was saved.
+     */
+    bool flushPendingScores();
+
+signals:
+    /**
+     * @brief Emitted after a score has been written to the database.
+     * @param playerId The ID of the player.
+     * @param courseId The ID of the course.
+     * @param dayNum The day number.
+     * @param holeNum The hole number.
+     * @param score The saved score.
+     */
+    void scoreSaved(int playerId, int courseId, int dayNum, int holeNum, int score);
+
+    /**
+     * @brief Emitted when a batch of scores could not be written to the database.
+     *
+     * The affected cells have been reverted to the scores stored in the database.
+     *
+     * @param cells A description of each cell that was not saved.
+     * @param error The database error.
+     */
+    void scoresNotSaved(const QStringList &cells, const QString &error);
+
+private slots:
+    void onAboutToWrite();
+    void onScoresSaved(const QVector<PendingScore> &scores);
+    void onScoresNotSaved(const QVector<PendingScore> &scores, const QString &error);
+
 private:
+    /**
+     * @struct CourseGrid
+     * @brief The hole details and scores of one course on this model's day.
+     */
+    struct CourseGrid {
+        QMap<int, QPair<int, int>> holeDetails;
+        QMap<int, QMap<int, int>> scores;
+    };
+
     QString m_connectionName; ///< The name of the database connection.
     int m_dayNum;             ///< The tournament day number (1, 2, or 3).
     int m_currentCourseId;    ///< The ID of the currently selected course.
@@ -68,15 +124,19 @@ private:
     QVector<PlayerInfo> m_activePlayers; ///< The list of active players (rows).
     QMap<int, QPair<int, int>> m_holeDetails; ///< Map of HoleNum to <Par, Handicap>.
     QMap<int, QMap<int, int>> m_scores; ///< Map of PlayerId to a map of <HoleNum, Score>.
+    ScoreWriteQueue *m_writeQueue;      ///< Batches score writes.
+
+    QCache<int, CourseGrid> m_courseCache;  ///< Grids of recently shown courses, by course ID.
+    ChangeTracker m_changeTracker;          ///< Detects writes made outside this model.
+    ChangeTracker::Stamp m_cacheStamp;      ///< The database state the cache and the shown grid match.
 
     QSqlDatabase database() const;
-    void loadActivePlayers();
     void loadHoleDetails(int courseId);
     void loadScores(int courseId);
+    bool validateCache();
     const PlayerInfo* getPlayerInfo(int row) const;
     int getColumnForHole(int holeNum) const;
     int getHoleForColumn(int column) const;
-    bool saveScore(int playerId, int holeNum, int score);
 };
 
 #endif // SCORETABLEMODEL_H
\ No newline at end of file
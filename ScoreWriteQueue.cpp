@@ -0,0 +1,87 @@
+/**
+ * @file ScoreWriteQueue.cpp
+ * @brief Implements the ScoreWriteQueue class.
+ */
+
+#include "ScoreWriteQueue.h"
+#include "TournamentRepository.h"
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QDebug>
+
+ScoreWriteQueue::ScoreWriteQueue(const QString &connectionName, QObject *parent)
+    : QObject(parent), m_connectionName(connectionName)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(DefaultFlushDelay);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ScoreWriteQueue::flush);
+}
+
+ScoreWriteQueue::~ScoreWriteQueue()
+{
+    flush();
+}
+
+void ScoreWriteQueue::setFlushDelay(int msec)
+{
+    m_flushTimer.setInterval(msec);
+}
+
+void ScoreWriteQueue::enqueue(int playerId, int courseId, int dayNum, int holeNum, int score)
+{
+    m_pending.insert(CellKey(playerId, courseId, dayNum, holeNum), PendingScore{playerId, courseId, dayNum, holeNum, score});
+    // Not restarted by later edits, so a fast scorer still sees scores written regularly.
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+bool ScoreWriteQueue::flush()
+{
+    m_flushTimer.stop();
+    if (m_pending.isEmpty()) {
+        return true;
+    }
+
+    const QVector<PendingScore> scores(m_pending.cbegin(), m_pending.cend());
+    m_pending.clear();
+
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    if (!db.isValid() || !db.isOpen()) {
+        QString error = tr("Invalid or closed database connection.");
+        qDebug() << "ScoreWriteQueue::flush: ERROR:" << error;
+        emit scoresNotSaved(scores, error);
+        return false;
+    }
+
+    if (!db.transaction()) {
+        QString error = db.lastError().text();
+        qDebug() << "ScoreWriteQueue::flush: ERROR starting transaction:" << error;
+        emit scoresNotSaved(scores, error);
+        return false;
+    }
+    emit aboutToWrite(scores);
+
+    TournamentRepository &repository = TournamentRepository::forConnection(m_connectionName);
+    for (const PendingScore &pending : scores) {
+        if (!repository.saveScore(pending.playerId, pending.courseId, pending.holeNum, pending.dayNum, pending.score)) {
+            QString error = repository.lastError();
+            qDebug() << "ScoreWriteQueue::flush: ERROR saving score for Player" << pending.playerId
+                     << "Day" << pending.dayNum << "Hole" << pending.holeNum << ":" << error;
+            db.rollback();
+            emit scoresNotSaved(scores, error);
+            return false;
+        }
+    }
+
+    if (!db.commit()) {
+        QString error = db.lastError().text();
+        qDebug() << "ScoreWriteQueue::flush: ERROR committing" << scores.size() << "scores:" << error;
+        db.rollback();
+        emit scoresNotSaved(scores, error);
+        return false;
+    }
+
+    emit scoresSaved(scores);
+    return true;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file ScoreWriteQueue.h
+ * @brief Contains the declaration of the ScoreWriteQueue class.
+ */
+
+#ifndef SCOREWRITEQUEUE_H
+#define SCOREWRITEQUEUE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <tuple>
+
+/**
+ * @struct PendingScore
+ * @brief A score waiting to be written to the database.
+ */
+struct PendingScore {
+    int playerId;   ///< The ID of the player.
+    int courseId;   ///< The ID of the course.
+    int dayNum;     ///< The day number.
+    int holeNum;    ///< The hole number.
+    int score;      ///< The gross score.
+};
+
+/**
+ * @class ScoreWriteQueue
+ * @brief Collects score edits and writes them to the database in batches.
+ *
+ * Enqueued scores are coalesced per player, course, day and hole, so only the
+ * last edit of a cell is written. The queue flushes on its own shortly after
+ * the first pending edit, and can be flushed explicitly at any time. Each flush
+ * writes every pending score in a single transaction; if any write fails the
+ * whole transaction is rolled back and every score in it is reported as not
+ * saved.
+ */
+class ScoreWriteQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultFlushDelay = 500; ///< Milliseconds between the first pending edit and the flush.
+
+    /**
+     * @brief Constructs a ScoreWriteQueue object.
+     * @param connectionName The name of the database connection to write to.
+     * @param parent The parent object.
+     */
+    explicit ScoreWriteQueue(const QString &connectionName, QObject *parent = nullptr);
+
+    /**
+     * @brief Destroys the queue, flushing any pending scores first.
+     */
+    ~ScoreWriteQueue();
+
+    /**
+     * @brief Sets how long after the first pending edit the queue flushes.
+     * @param msec The delay in milliseconds.
+     */
+    void setFlushDelay(int msec);
+
+    /**
+     * @brief Queues a score, replacing any pending score for the same cell.
+     */
+    void enqueue(int playerId, int courseId, int dayNum, int holeNum, int score);
+
+    /**
+     * @brief Checks whether any scores are waiting to be written.
+     */
+    bool hasPending() const { return !m_pending.isEmpty(); }
+
+public slots:
+    /**
+     * @brief Writes all pending scores in a single transaction.
+     * @return True if nothing was pending or every score was committed.
+     */
+    bool flush();
+
+signals:
+    /**
+     * @brief Emitted when a flush has started its transaction, before the scores are written.
+     * @param scores The scores about to be written.
+     */
+    void aboutToWrite(const QVector<PendingScore> &scores);
+
+    /**
+     * @brief Emitted after a flush has committed.
+     * @param scores The scores that were written.
+     */
+    void scoresSaved(const QVector<PendingScore> &scores);
+
+    /**
+     * @brief Emitted when a flush was rolled back.
+     * @param scores The scores that were not written.
+     * @param error The database error that caused the rollback.
+     */
+    void scoresNotSaved(const QVector<PendingScore> &scores, const QString &error);
+
+private:
+    using CellKey = std::tuple<int, int, int, int>; ///< Player, course, day and hole.
+
+    QString m_connectionName;
+    QTimer m_flushTimer;
+    QMap<CellKey, PendingScore> m_pending;
+};
+
+#endif // SCOREWRITEQUEUE_H
@@ -0,0 +1,143 @@
+/**
+ * @file SqliteFunctions.cpp
+ * @brief Implements the SQL scoring functions.
+ */
+
+#include "SqliteFunctions.h"
+#include "utils.h"
+
+#include <QSqlDriver>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+#include <QDebug>
+
+#ifdef MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+#include <sqlite3.h>
+#include <atomic>
+#endif
+
+namespace SqliteFunctions {
+
+#ifdef MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+
+namespace {
+
+void stablefordFunction(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+    Q_UNUSED(argc);
+    if (sqlite3_value_type(argv[0]) == SQLITE_NULL || sqlite3_value_type(argv[1]) == SQLITE_NULL) {
+        sqlite3_result_null(context);
+        return;
+    }
+    const int gross = sqlite3_value_int(argv[0]);
+    const int par = sqlite3_value_int(argv[1]);
+    if (gross <= 0 || par <= 0) {
+        sqlite3_result_null(context);
+        return;
+    }
+    sqlite3_result_int(context, stablefordPoints(gross - par));
+}
+
+void strokesReceivedFunction(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+    Q_UNUSED(argc);
+    if (sqlite3_value_type(argv[0]) == SQLITE_NULL || sqlite3_value_type(argv[1]) == SQLITE_NULL) {
+        sqlite3_result_null(context);
+        return;
+    }
+    sqlite3_result_int(context, strokesReceived(sqlite3_value_int(argv[0]), sqlite3_value_int(argv[1])));
+}
+
+/**
+ * @brief Checks, once per process, that a connection runs on the linked SQLite build.
+ *
+ * The check goes through Qt's plugin rather than the handle, so it is safe
+ * whichever library the plugin uses.
+ */
+bool sameSqliteBuild(const QSqlDatabase &db)
+{
+    enum { Unknown, Same, Different };
+    static std::atomic<int> result { Unknown };
+    if (result.load(std::memory_order_relaxed) == Unknown) {
+        QSqlQuery query(db);
+        if (!query.exec("SELECT sqlite_source_id()") || !query.next()) {
+            return false;
+        }
+        const QString pluginSource = query.value(0).toString();
+        const bool same = pluginSource == QLatin1String(sqlite3_sourceid());
+        if (!same) {
+            qDebug() << "SqliteFunctions: Qt's SQLite plugin uses" << pluginSource << "but the application links"
+                     << sqlite3_sourceid() << "- native functions and statistics are disabled.";
+        }
+        result.store(same ? Same : Different, std::memory_order_relaxed);
+    }
+    return result.load(std::memory_order_relaxed) == Same;
+}
+
+} // namespace
+
+sqlite3 *nativeHandle(const QSqlDatabase &db)
+{
+    if (!db.isOpen() || !db.driver()) {
+        return nullptr;
+    }
+    QVariant handleVariant = db.driver()->handle();
+    if (!handleVariant.isValid() || qstrcmp(handleVariant.typeName(), "sqlite3*") != 0) {
+        return nullptr;
+    }
+    if (!sameSqliteBuild(db)) {
+        return nullptr;
+    }
+    return *static_cast<sqlite3 *const *>(handleVariant.constData());
+}
+
+bool registerScoringFunctions(const QSqlDatabase &db)
+{
+    sqlite3 *handle = nativeHandle(db);
+    if (!handle) {
+        return false;
+    }
+
+    int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC;
+#ifdef SQLITE_INNOCUOUS
+    flags |= SQLITE_INNOCUOUS;
+#endif
+
+    if (sqlite3_create_function_v2(handle, "stableford", 2, flags, nullptr, &stablefordFunction, nullptr, nullptr, nullptr) != SQLITE_OK ||
+        sqlite3_create_function_v2(handle, "strokes_received", 2, flags, nullptr, &strokesReceivedFunction, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        qDebug() << "SqliteFunctions::registerScoringFunctions: ERROR registering functions:" << sqlite3_errmsg(handle);
+        return false;
+    }
+    return true;
+}
+
+#else
+
+bool registerScoringFunctions(const QSqlDatabase &db)
+{
+    Q_UNUSED(db);
+    return false;
+}
+
+#endif // MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+
+QString stablefordExpression(const QString &gross, const QString &par, bool useNativeFunctions)
+{
+    if (useNativeFunctions) {
+        return QString("stableford(%1, %2)").arg(gross, par);
+    }
+
+    // CASE without ELSE yields NULL, matching the native function.
+    QStringList whens;
+    for (int diff = stableford_min_diff; diff <= stableford_max_diff; ++diff) {
+        whens << QString("WHEN %1 THEN %2").arg(diff).arg(stablefordPoints(diff));
+    }
+    return QString("(CASE WHEN %1 > 0 AND %2 > 0 THEN CASE MAX(%3, MIN(%4, %1 - %2)) %5 END END)")
+        .arg(gross, par)
+        .arg(stableford_min_diff)
+        .arg(stableford_max_diff)
+        .arg(whens.join(' '));
+}
+
+} // namespace SqliteFunctions
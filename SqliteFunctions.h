@@ -0,0 +1,75 @@
+/**
+ * @file SqliteFunctions.h
+ * @brief Contains the declarations of the SQL scoring functions.
+ */
+
+#ifndef SQLITEFUNCTIONS_H
+#define SQLITEFUNCTIONS_H
+
+#include <QSqlDatabase>
+#include <QString>
+
+#ifdef MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+struct sqlite3;
+#endif
+
+/**
+ * @namespace SqliteFunctions
+ * @brief Stableford scoring inside SQLite queries.
+ *
+ * When the application is built with MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS, two
+ * deterministic functions are registered directly on the SQLite handle:
+ *
+ * - stableford(gross, par): the Stableford points of a hole, or NULL when the
+ *   gross score or par is missing or not positive.
+ * - strokes_received(handicap, hole_index): the strokes a player receives on a hole.
+ *
+ * The handle belongs to the SQLite library inside Qt's QSQLITE plugin, which
+ * is usually a private copy rather than the library the application links.
+ * Functions are therefore only registered when both report the same SQLite
+ * build; see nativeHandle().
+ *
+ * Without native functions, stablefordExpression() produces an equivalent
+ * plain SQL expression so queries work either way. Triggers always use the
+ * expression, since they also run on connections that never registered it.
+ */
+namespace SqliteFunctions {
+
+/**
+ * @brief Registers the native scoring functions on a connection.
+ *
+ * Registering again is harmless, so this can be called for every connection
+ * before it is used for scoring queries.
+ *
+ * @param db An open QSQLITE connection.
+ * @return True if the native functions are available on the connection.
+ */
+bool registerScoringFunctions(const QSqlDatabase &db);
+
+#ifdef MOSLEYOPEN_NATIVE_SQLITE_FUNCTIONS
+/**
+ * @brief Gets the SQLite handle of a connection, if this application's SQLite can use it.
+ *
+ * The connection's sqlite_source_id() is compared with sqlite3_sourceid() of
+ * the linked library once per process. When Qt's plugin carries a different
+ * SQLite build, passing its handle to the linked library would be undefined,
+ * so nullptr is returned and callers fall back to plain SQL.
+ *
+ * @param db An open QSQLITE connection.
+ * @return The handle, or nullptr if it is unavailable or from another SQLite build.
+ */
+sqlite3 *nativeHandle(const QSqlDatabase &db);
+#endif
+
+/**
+ * @brief Builds an SQL expression for the Stableford points of a hole.
+ * @param gross The SQL expression of the gross score.
+ * @param par The SQL expression of the par.
+ * @param useNativeFunctions Whether stableford() is registered on the connection.
+ * @return The expression, NULL-valued where stableford() would be NULL.
+ */
+QString stablefordExpression(const QString &gross, const QString &par, bool useNativeFunctions);
+
+} // namespace SqliteFunctions
+
+#endif // SQLITEFUNCTIONS_H
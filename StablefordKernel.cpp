@@ -0,0 +1,227 @@
+/**
+ * @file StablefordKernel.cpp
+ * @brief Implements the batch Stableford scoring kernel.
+ */
+
+#include "StablefordKernel.h"
+#include "utils.h"
+
+#include <array>
+#include <atomic>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define STABLEFORD_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace StablefordKernel {
+
+namespace {
+
+/**
+ * @brief stableford_points_table padded to 16 bytes, for use as a byte shuffle.
+ */
+constexpr auto shuffle_table = [] {
+    std::array<qint8, 16> table{};
+    for (std::size_t i = 0; i < stableford_points_table.size(); ++i) {
+        table[i] = static_cast<qint8>(stableford_points_table[i]);
+    }
+    return table;
+}();
+
+void scoreHolesScalar(const qint8 *gross, const qint8 *par, const qint8 *strokes, qsizetype holeCount, qint8 *points)
+{
+    for (qsizetype i = 0; i < holeCount; ++i) {
+        if (gross[i] <= 0 || par[i] <= 0) {
+            points[i] = NotPlayed;
+        } else {
+            points[i] = static_cast<qint8>(stablefordPoints(gross[i] - (strokes ? strokes[i] : 0) - par[i]));
+        }
+    }
+}
+
+void sumRoundsScalar(const qint8 *points, qsizetype roundCount, int *totals)
+{
+    for (qsizetype round = 0; round < roundCount; ++round) {
+        const qint8 *roundPoints = points + round * HolesPerRound;
+        int total = 0;
+        for (int hole = 0; hole < HolesPerRound; ++hole) {
+            if (roundPoints[hole] != NotPlayed) {
+                total += roundPoints[hole];
+            }
+        }
+        totals[round] = total;
+    }
+}
+
+#ifdef STABLEFORD_KERNEL_X86
+
+/*
+ * Both vector versions do the same per byte:
+ *   diff   = clamp(gross - strokes - par, stableford_min_diff, stableford_max_diff)
+ *   points = shuffle_table[diff - stableford_min_diff]
+ * and replace the points of holes without a gross score or par with NotPlayed.
+ * Saturating subtraction keeps the difference in range for any byte inputs.
+ */
+
+__attribute__((target("sse4.1")))
+void scoreHolesSse41(const qint8 *gross, const qint8 *par, const qint8 *strokes, qsizetype holeCount, qint8 *points)
+{
+    const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffle_table.data()));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i minDiff = _mm_set1_epi8(stableford_min_diff);
+    const __m128i maxDiff = _mm_set1_epi8(stableford_max_diff);
+    const __m128i notPlayed = _mm_set1_epi8(NotPlayed);
+
+    qsizetype i = 0;
+    for (; i + 16 <= holeCount; i += 16) {
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i *>(gross + i));
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(par + i));
+        __m128i s = strokes ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(strokes + i)) : zero;
+
+        __m128i diff = _mm_subs_epi8(_mm_subs_epi8(g, s), p);
+        diff = _mm_min_epi8(_mm_max_epi8(diff, minDiff), maxDiff);
+        __m128i pts = _mm_shuffle_epi8(table, _mm_sub_epi8(diff, minDiff));
+
+        __m128i played = _mm_and_si128(_mm_cmpgt_epi8(g, zero), _mm_cmpgt_epi8(p, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(points + i), _mm_blendv_epi8(notPlayed, pts, played));
+    }
+    scoreHolesScalar(gross + i, par + i, strokes ? strokes + i : nullptr, holeCount - i, points + i);
+}
+
+__attribute__((target("avx2")))
+void scoreHolesAvx2(const qint8 *gross, const qint8 *par, const qint8 *strokes, qsizetype holeCount, qint8 *points)
+{
+    // vpshufb shuffles within each 128-bit lane, so both lanes get the table.
+    const __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffle_table.data())));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i minDiff = _mm256_set1_epi8(stableford_min_diff);
+    const __m256i maxDiff = _mm256_set1_epi8(stableford_max_diff);
+    const __m256i notPlayed = _mm256_set1_epi8(NotPlayed);
+
+    qsizetype i = 0;
+    for (; i + 32 <= holeCount; i += 32) {
+        __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(gross + i));
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(par + i));
+        __m256i s = strokes ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(strokes + i)) : zero;
+
+        __m256i diff = _mm256_subs_epi8(_mm256_subs_epi8(g, s), p);
+        diff = _mm256_min_epi8(_mm256_max_epi8(diff, minDiff), maxDiff);
+        __m256i pts = _mm256_shuffle_epi8(table, _mm256_sub_epi8(diff, minDiff));
+
+        __m256i played = _mm256_and_si256(_mm256_cmpgt_epi8(g, zero), _mm256_cmpgt_epi8(p, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(points + i), _mm256_blendv_epi8(notPlayed, pts, played));
+    }
+    scoreHolesScalar(gross + i, par + i, strokes ? strokes + i : nullptr, holeCount - i, points + i);
+}
+
+/*
+ * Sums the first 16 holes of a round with psadbw. Points range from -1 to 12,
+ * so unplayed holes are zeroed and every byte is biased by +1 to make it
+ * unsigned; the bias is subtracted again afterwards. The last two holes are
+ * added separately.
+ */
+__attribute__((target("sse4.1")))
+void sumRoundsSse41(const qint8 *points, qsizetype roundCount, int *totals)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i notPlayed = _mm_set1_epi8(NotPlayed);
+
+    for (qsizetype round = 0; round < roundCount; ++round) {
+        const qint8 *roundPoints = points + round * HolesPerRound;
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(roundPoints));
+        v = _mm_andnot_si128(_mm_cmpeq_epi8(v, notPlayed), v);
+        __m128i sums = _mm_sad_epu8(_mm_add_epi8(v, one), zero);
+        int total = _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4) - 16;
+
+        for (int hole = 16; hole < HolesPerRound; ++hole) {
+            if (roundPoints[hole] != NotPlayed) {
+                total += roundPoints[hole];
+            }
+        }
+        totals[round] = total;
+    }
+}
+
+#endif // STABLEFORD_KERNEL_X86
+
+Isa detectIsa()
+{
+#ifdef STABLEFORD_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return Isa::Sse41;
+    }
+#endif
+    return Isa::Scalar;
+}
+
+std::atomic<Isa> &currentIsa()
+{
+    static std::atomic<Isa> isa(detectIsa());
+    return isa;
+}
+
+} // namespace
+
+Isa activeIsa()
+{
+    return currentIsa().load(std::memory_order_relaxed);
+}
+
+bool isSupported(Isa isa)
+{
+    switch (detectIsa()) {
+    case Isa::Avx2: return true;
+    case Isa::Sse41: return isa != Isa::Avx2;
+    case Isa::Scalar: return isa == Isa::Scalar;
+    }
+    return false;
+}
+
+bool setIsa(Isa isa)
+{
+    if (!isSupported(isa)) {
+        return false;
+    }
+    currentIsa().store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+const char *isaName(Isa isa)
+{
+    switch (isa) {
+    case Isa::Scalar: return "scalar";
+    case Isa::Sse41: return "sse4.1";
+    case Isa::Avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+void scoreHoles(const qint8 *gross, const qint8 *par, const qint8 *strokes, qsizetype holeCount, qint8 *points)
+{
+    switch (activeIsa()) {
+#ifdef STABLEFORD_KERNEL_X86
+    case Isa::Avx2: scoreHolesAvx2(gross, par, strokes, holeCount, points); return;
+    case Isa::Sse41: scoreHolesSse41(gross, par, strokes, holeCount, points); return;
+#endif
+    default: scoreHolesScalar(gross, par, strokes, holeCount, points); return;
+    }
+}
+
+void sumRounds(const qint8 *points, qsizetype roundCount, int *totals)
+{
+    switch (activeIsa()) {
+#ifdef STABLEFORD_KERNEL_X86
+    case Isa::Avx2:
+    case Isa::Sse41: sumRoundsSse41(points, roundCount, totals); return;
+#endif
+    default: sumRoundsScalar(points, roundCount, totals); return;
+    }
+}
+
+} // namespace StablefordKernel
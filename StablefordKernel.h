@@ -0,0 +1,82 @@
+/**
+ * @file StablefordKernel.h
+ * @brief Contains the declaration of the batch Stableford scoring kernel.
+ */
+
+#ifndef STABLEFORDKERNEL_H
+#define STABLEFORDKERNEL_H
+
+#include <QtGlobal>
+
+/**
+ * @namespace StablefordKernel
+ * @brief Scores many holes at once from dense arrays of gross scores.
+ *
+ * All arrays hold one signed byte per hole. Rounds are stored back to back,
+ * HolesPerRound bytes each. A hole is scored when both its gross score and its
+ * par are positive; otherwise its points are NotPlayed.
+ *
+ * The fastest implementation the CPU supports (AVX2, SSE4.1 or plain C++) is
+ * picked on first use. All implementations give identical results.
+ */
+namespace StablefordKernel {
+
+constexpr int HolesPerRound = 18;   ///< The number of holes in a round.
+constexpr qint8 NotPlayed = -128;   ///< The points of a hole without a score or par.
+
+/**
+ * @enum Isa
+ * @brief The available implementations of the kernel.
+ */
+enum class Isa {
+    Scalar,     ///< Portable C++.
+    Sse41,      ///< 16 holes per step with SSE4.1.
+    Avx2        ///< 32 holes per step with AVX2.
+};
+
+/**
+ * @brief Gets the implementation currently in use.
+ */
+Isa activeIsa();
+
+/**
+ * @brief Checks whether the CPU can run an implementation.
+ */
+bool isSupported(Isa isa);
+
+/**
+ * @brief Selects an implementation, for example to compare them in benchmarks.
+ * @param isa The implementation to use.
+ * @return True if the CPU supports it and it was selected, false otherwise.
+ */
+bool setIsa(Isa isa);
+
+/**
+ * @brief Gets a printable name for an implementation.
+ */
+const char *isaName(Isa isa);
+
+/**
+ * @brief Calculates the Stableford points of every hole.
+ *
+ * Each hole scores stablefordPoints(gross - strokes - par).
+ *
+ * @param gross The gross scores, 0 where no score was entered.
+ * @param par The par of each hole, 0 where unknown.
+ * @param strokes The strokes received on each hole, or nullptr for gross points.
+ * @param holeCount The number of holes in each array.
+ * @param points Receives the points of each hole, NotPlayed where unscored.
+ */
+void scoreHoles(const qint8 *gross, const qint8 *par, const qint8 *strokes, qsizetype holeCount, qint8 *points);
+
+/**
+ * @brief Sums the points of each round, skipping unplayed holes.
+ * @param points The per-hole points from scoreHoles(), HolesPerRound per round.
+ * @param roundCount The number of rounds.
+ * @param totals Receives the total of each round.
+ */
+void sumRounds(const qint8 *points, qsizetype roundCount, int *totals);
+
+} // namespace StablefordKernel
+
+#endif // STABLEFORDKERNEL_H
@@ -0,0 +1,51 @@
+/**
+ * @file StartupTimer.cpp
+ * @brief Implements the StartupTimer class.
+ */
+
+#include "StartupTimer.h"
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace {
+
+QElapsedTimer startupTimer;
+qint64 lastMarkNsecs = 0;
+QVector<StartupTimer::Stage> completedStages;
+
+} // namespace
+
+void StartupTimer::start()
+{
+    startupTimer.start();
+    lastMarkNsecs = 0;
+    completedStages.clear();
+}
+
+void StartupTimer::mark(const QString &stage)
+{
+    if (!startupTimer.isValid()) {
+        return;
+    }
+    const qint64 now = startupTimer.nsecsElapsed();
+    Stage completed{ stage, (now - lastMarkNsecs) / 1e6, now / 1e6 };
+    lastMarkNsecs = now;
+    completedStages.append(completed);
+    qDebug().nospace() << "Startup: " << stage << " took " << completed.durationMs << " ms (" << completed.elapsedMs << " ms total)";
+}
+
+QVector<StartupTimer::Stage> StartupTimer::stages()
+{
+    return completedStages;
+}
+
+bool StartupTimer::finish(int budgetMs)
+{
+    const double totalMs = startupTimer.isValid() ? startupTimer.nsecsElapsed() / 1e6 : 0;
+    if (totalMs > budgetMs) {
+        qWarning().nospace() << "Startup: took " << totalMs << " ms, over the budget of " << budgetMs << " ms";
+        return false;
+    }
+    qDebug().nospace() << "Startup: finished in " << totalMs << " ms, within the budget of " << budgetMs << " ms";
+    return true;
+}
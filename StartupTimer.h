@@ -0,0 +1,59 @@
+/**
+ * @file StartupTimer.h
+ * @brief Contains the declaration of the StartupTimer class.
+ */
+
+#ifndef STARTUPTIMER_H
+#define STARTUPTIMER_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @class StartupTimer
+ * @brief Times the stages of application startup against a budget.
+ *
+ * main() calls start() first and mark() at the end of each stage. Every mark
+ * is logged with the time spent in the stage and since startup began;
+ * finish() checks the total against the startup budget.
+ */
+class StartupTimer
+{
+public:
+    /**
+     * @struct Stage
+     * @brief A completed startup stage.
+     */
+    struct Stage {
+        QString name;           ///< The name of the stage.
+        double durationMs;      ///< The time spent in the stage.
+        double elapsedMs;       ///< The time since start() when the stage ended.
+    };
+
+    static constexpr int DefaultBudgetMs = 1500; ///< The default startup budget.
+
+    /**
+     * @brief Starts timing. Call once, as early as possible.
+     */
+    static void start();
+
+    /**
+     * @brief Ends the current stage and logs its time.
+     * @param stage The name of the stage that just finished.
+     */
+    static void mark(const QString &stage);
+
+    /**
+     * @brief Gets the stages marked so far.
+     */
+    static QVector<Stage> stages();
+
+    /**
+     * @brief Logs the total startup time and checks it against a budget.
+     * @param budgetMs The startup budget in milliseconds.
+     * @return True if startup finished within the budget.
+     */
+    static bool finish(int budgetMs);
+};
+
+#endif // STARTUPTIMER_H
@@ -4,6 +4,7 @@
  */
 
 #include "TeamAssemblyDialog.h"
+#include "TournamentRepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
@@ -58,7 +59,7 @@ void TeamAssemblyDialog::createTeamGroupBox(int teamIndex, const QString& teamNa
  * @brief Adds a new team.
  */
 void TeamAssemblyDialog::addTeam() {
-    QSqlQuery maxIdQuery("SELECT MAX(id) FROM teams", database);
+    QSqlQuery maxIdQuery("SELECT MAX(id) FROM teams WHERE event_id = (SELECT id FROM current_event)", database);
     int maxId = 0;
     if (maxIdQuery.exec() && maxIdQuery.next()) {
         maxId = maxIdQuery.value(0).toInt();
@@ -66,7 +67,7 @@ void TeamAssemblyDialog::addTeam() {
     int newTeamId = maxId + 1;
 
     QSqlQuery insertQuery(database);
-    insertQuery.prepare("INSERT INTO teams (id, name) VALUES (:id, :name)");
+    insertQuery.prepare("INSERT INTO teams (event_id, id, name) VALUES ((SELECT id FROM current_event), :id, :name)");
     insertQuery.bindValue(":id", newTeamId);
     insertQuery.bindValue(":name", QString("Team %1").arg(newTeamId));
     if (!insertQuery.exec()) {
@@ -81,7 +82,7 @@ void TeamAssemblyDialog::addTeam() {
  * @brief Removes the last team.
  */
 void TeamAssemblyDialog::removeTeam() {
-    QSqlQuery maxIdQuery("SELECT MAX(id) FROM teams", database);
+    QSqlQuery maxIdQuery("SELECT MAX(id) FROM teams WHERE event_id = (SELECT id FROM current_event)", database);
     int maxId = 0;
     if (maxIdQuery.exec() && maxIdQuery.next()) {
         maxId = maxIdQuery.value(0).toInt();
@@ -94,7 +95,7 @@ void TeamAssemblyDialog::removeTeam() {
     
     QString teamNameToRemove = "team";
     QSqlQuery nameQuery(database);
-    nameQuery.prepare("SELECT name FROM teams WHERE id = :id");
+    nameQuery.prepare("SELECT name FROM teams WHERE event_id = (SELECT id FROM current_event) AND id = :id");
     nameQuery.bindValue(":id", maxId);
     if(nameQuery.exec() && nameQuery.next()) teamNameToRemove = nameQuery.value(0).toString();
 
@@ -106,11 +107,11 @@ void TeamAssemblyDialog::removeTeam() {
 
     database.transaction();
     QSqlQuery updatePlayersQuery(database);
-    updatePlayersQuery.prepare("UPDATE players SET team_id = NULL WHERE team_id = :id");
+    updatePlayersQuery.prepare("DELETE FROM team_members WHERE event_id = (SELECT id FROM current_event) AND team_id = :id");
     updatePlayersQuery.bindValue(":id", maxId);
     
     QSqlQuery deleteTeamQuery(database);
-    deleteTeamQuery.prepare("DELETE FROM teams WHERE id = :id");
+    deleteTeamQuery.prepare("DELETE FROM teams WHERE event_id = (SELECT id FROM current_event) AND id = :id");
     deleteTeamQuery.bindValue(":id", maxId);
 
     if (updatePlayersQuery.exec() && deleteTeamQuery.exec()) {
@@ -192,7 +193,7 @@ void TeamAssemblyDialog::loadActivePlayers() {
     }
 
     QSqlQuery teamQuery(database);
-    if (teamQuery.exec("SELECT id, name FROM teams ORDER BY id")) {
+    if (teamQuery.exec("SELECT id, name FROM teams WHERE event_id = (SELECT id FROM current_event) ORDER BY id")) {
         while (teamQuery.next()) {
             TeamData team;
             team.id = teamQuery.value("id").toInt();
@@ -220,7 +221,9 @@ void TeamAssemblyDialog::loadActivePlayers() {
     }
 
     QSqlQuery query(database);
-    if (query.exec("SELECT id, name, handicap, team_id FROM players WHERE active = 1 ORDER BY name")) {
+    if (query.exec("SELECT p.id, p.name, p.handicap, m.team_id FROM players p "
+                   "LEFT JOIN team_members m ON m.event_id = (SELECT id FROM current_event) AND m.player_id = p.id "
+                   "WHERE p.active = 1 ORDER BY p.name")) {
         while (query.next()) {
             PlayerInfo player;
             player.id = query.value("id").toInt();
@@ -355,42 +358,32 @@ void TeamAssemblyDialog::saveTeams() {
     QSqlDatabase::database().transaction();
 
     QSqlQuery clearTeamsQuery(database);
-    if (!clearTeamsQuery.exec("DELETE FROM teams")) {
+    if (!clearTeamsQuery.exec("DELETE FROM teams WHERE event_id = (SELECT id FROM current_event)")) {
         qWarning() << "Failed to clear teams table:" << clearTeamsQuery.lastError().text();
         QSqlDatabase::database().rollback();
         return;
     }
 
     bool allSuccessful = true;
+    TournamentRepository &repository = TournamentRepository::forConnection(database.connectionName());
 
     for (size_t i = 0; i < teamsData.size(); ++i) {
-        QSqlQuery teamInsertQuery(database);
-        teamInsertQuery.prepare("INSERT INTO teams (id, name) VALUES (:id, :name)");
-        teamInsertQuery.bindValue(":id", teamsData[i].id);
-        teamInsertQuery.bindValue(":name", teamNameEditLines[i]->text());
-        if (!teamInsertQuery.exec()) {
-            qWarning() << "Failed to save team name for team ID" << teamsData[i].id << ":" << teamInsertQuery.lastError().text();
+        if (!repository.insertTeam(teamsData[i].id, teamNameEditLines[i]->text())) {
+            qWarning() << "Failed to save team name for team ID" << teamsData[i].id << ":" << repository.lastError();
             allSuccessful = false;
         }
 
         for (const auto& player : teamsData[i].members) {
-            QSqlQuery query(database);
-            query.prepare("UPDATE players SET team_id = :teamId WHERE id = :playerId");
-            query.bindValue(":teamId", teamsData[i].id);
-            query.bindValue(":playerId", player.id);
-            if (!query.exec()) {
-                qWarning() << "Failed to save team for player" << player.name << "(ID:" << player.id << "):" << query.lastError().text();
+            if (!repository.setPlayerTeam(player.id, teamsData[i].id)) {
+                qWarning() << "Failed to save team for player" << player.name << "(ID:" << player.id << "):" << repository.lastError();
                 allSuccessful = false;
             }
         }
     }
 
     for (const auto& player : availablePlayersData) {
-        QSqlQuery query(database);
-        query.prepare("UPDATE players SET team_id = NULL WHERE id = :playerId");
-        query.bindValue(":playerId", player.id);
-        if (!query.exec()) {
-            qWarning() << "Failed to clear team for player" << player.name << "(ID:" << player.id << "):" << query.lastError().text();
+        if (!repository.setPlayerTeam(player.id, -1)) {
+            qWarning() << "Failed to clear team for player" << player.name << "(ID:" << player.id << "):" << repository.lastError();
             allSuccessful = false;
         }
     }
@@ -4,36 +4,19 @@
  */
 
 #include "TeamLeaderboardModel.h"
-#include "utils.h"
-#include <QSqlQuery>
-#include <QSqlError>
+#include "StablefordKernel.h"
 #include <algorithm>
-#include <cmath>
 #include <ranges>
 #include <functional>
 #include <numeric>
 
-/**
- * @brief Calculates the number of strokes a player receives on a hole.
- * @param handicapForCalc The player's handicap.
- * @param holeHcIndex The handicap index of the hole.
- * @return The number of strokes received.
- */
-int calculateStrokesReceived(int handicapForCalc, int holeHcIndex) {
-    if (handicapForCalc <= 36) {
-        int effective = 36 - handicapForCalc;
-        int strokes = 0;
-        if (effective >= holeHcIndex) strokes++;
-        if (effective >= (18 + holeHcIndex)) strokes++;
-        if (effective >= (36 + holeHcIndex)) strokes++;
-        return strokes;
-    } else {
-        int toGiveBack = static_cast<int>(std::floor((static_cast<double>(handicapForCalc) - 36.0) / 2.0));
-        if (holeHcIndex > (18 - toGiveBack)) {
-            return -1;
-        }
-    }
-    return 0;
+namespace {
+const std::array<QVariant, TeamLeaderboardModel::ColumnCount> column_headers = {
+    QStringLiteral("Rank"), QStringLiteral("Team"), QStringLiteral("Day 1 Points"),
+    QStringLiteral("Day 2 Points"), QStringLiteral("Day 3 Points"), QStringLiteral("Overall Points"),
+};
+
+const QVariant center_alignment = QVariant(Qt::AlignCenter);
 }
 
 TeamLeaderboardModel::TeamLeaderboardModel(const QString &connectionName, QObject *parent)
@@ -41,10 +24,6 @@ TeamLeaderboardModel::TeamLeaderboardModel(const QString &connectionName, QObjec
 
 TeamLeaderboardModel::~TeamLeaderboardModel() {}
 
-QSqlDatabase TeamLeaderboardModel::database() const {
-    return QSqlDatabase::database(m_connectionName);
-}
-
 int TeamLeaderboardModel::rowCount(const QModelIndex &parent) const {
     Q_UNUSED(parent);
     return m_leaderboardData.size();
@@ -52,7 +31,7 @@ int TeamLeaderboardModel::rowCount(const QModelIndex &parent) const {
 
 int TeamLeaderboardModel::columnCount(const QModelIndex &parent) const {
     Q_UNUSED(parent);
-    return 6; // Rank, Team Name, Day 1 Pts, Day 2 Pts, Day 3 Pts, Overall Pts
+    return ColumnCount;
 }
 
 QVariant TeamLeaderboardModel::data(const QModelIndex &index, int role) const {
@@ -61,207 +40,226 @@ QVariant TeamLeaderboardModel::data(const QModelIndex &index, int role) const {
         return QVariant();
     }
 
-    const TeamLeaderboardRow &teamRow = m_leaderboardData.at(index.row());
-
     if (role == Qt::DisplayRole) {
-        switch (index.column()) {
-            case 0: return teamRow.rank > 0 ? QVariant(teamRow.rank) : QVariant("-");
-            case 1: return teamRow.teamName;
-            case 2: return teamRow.dailyTeamStablefordPoints.value(1, 0);
-            case 3: return teamRow.dailyTeamStablefordPoints.value(2, 0);
-            case 4: return teamRow.dailyTeamStablefordPoints.value(3, 0);
-            case 5: return teamRow.overallTeamStablefordPoints;
-            default: return QVariant();
-        }
+        return m_displayRows.at(index.row())[index.column()];
     } else if (role == Qt::TextAlignmentRole) {
-        return QVariant(Qt::AlignCenter); 
+        return center_alignment;
     }
     return QVariant();
 }
 
 QVariant TeamLeaderboardModel::headerData(int section, Qt::Orientation orientation, int role) const {
-    if (role == Qt::DisplayRole && orientation == Qt::Horizontal) {
-        switch (section) {
-            case 0: return "Rank";
-            case 1: return "Team";
-            case 2: return "Day 1 Points";
-            case 3: return "Day 2 Points";
-            case 4: return "Day 3 Points";
-            case 5: return "Overall Points";
-            default: return QVariant();
-        }
+    if (orientation != Qt::Horizontal || section < 0 || section >= ColumnCount) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole) {
+        return column_headers[section];
     }
-    if (role == Qt::TextAlignmentRole && orientation == Qt::Horizontal) {
-        return QVariant(Qt::AlignCenter);
+    if (role == Qt::TextAlignmentRole) {
+        return center_alignment;
     }
     return QVariant();
 }
 
-void TeamLeaderboardModel::refreshData() {
-    beginResetModel();
+int TeamLeaderboardModel::sortKey(int row, int column) const {
+    const TeamLeaderboardRow &teamRow = m_leaderboardData.at(row);
+    switch (column) {
+        case 0: return row;
+        case 2: case 3: case 4: return teamRow.dailyTeamStablefordPoints.value(column - 1, 0);
+        case 5: return teamRow.overallTeamStablefordPoints;
+        default: return 0;
+    }
+}
 
-    m_allPlayers.clear();
-    m_playerTeamAssignments.clear();
-    m_allHoleDetails.clear();
-    m_allScores.clear();
-    m_daysWithScores.clear();
-    m_leaderboardData.clear();
+void TeamLeaderboardModel::refreshData() {
+    refreshData(TournamentSnapshot::load(m_connectionName));
+}
 
-    fetchAllPlayersAndAssignments();
-    fetchAllHoleDetails();
-    fetchAllScores();
-    calculateTeamLeaderboard();
+void TeamLeaderboardModel::refreshData(const TournamentSnapshot &snapshot) {
+    setResult(snapshot, calculate(snapshot));
+}
 
-    endResetModel();
+/**
+ * @brief Calculates the ranked team rows without touching any model.
+ *
+ * This is a pure function of its argument, so it can run on a worker thread.
+ *
+ * @param snapshot The tournament data.
+ * @return The ranked team rows.
+ */
+QVector<TeamLeaderboardRow> TeamLeaderboardModel::calculate(const TournamentSnapshot &snapshot) {
+    QVector<TeamLeaderboardRow> rows = assignTeamMembers(snapshot);
+    calculateTeamLeaderboard(snapshot, rows);
+    return rows;
 }
 
-QSet<int> TeamLeaderboardModel::getDaysWithScores() const {
-    return m_daysWithScores;
+void TeamLeaderboardModel::setResult(const TournamentSnapshot &snapshot, const QVector<TeamLeaderboardRow> &rows) {
+    beginResetModel();
+    m_snapshot = snapshot;
+    m_daysWithScores = m_snapshot.daysWithScores();
+    m_leaderboardData = rows;
+    m_displayRows.resize(m_leaderboardData.size());
+    std::ranges::transform(std::as_const(m_leaderboardData), m_displayRows.begin(), &TeamLeaderboardModel::displayRow);
+    endResetModel();
 }
 
 /**
- * @brief Fetches all players and their team assignments from the database.
+ * @brief Rescores the team of a player whose score changed, without resetting the model.
+ *
+ * Only the player's team is recalculated. Its row moves to its new position and
+ * the ranks of the other rows are updated in place, so the view keeps its
+ * scroll position and selection.
+ *
+ * @param snapshot The snapshot holding the changed score.
+ * @param playerId The player whose score changed.
  */
-void TeamLeaderboardModel::fetchAllPlayersAndAssignments() {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "TeamLeaderboardModel::fetchAllPlayersAndAssignments: ERROR: Invalid or closed database connection.";
+void TeamLeaderboardModel::applyScoreChange(const TournamentSnapshot &snapshot, int playerId)
+{
+    if (snapshot.players().size() != m_snapshot.players().size() || snapshot.teams().size() != m_leaderboardData.size() ||
+        !snapshot.hasHoleDetails()) {
+        refreshData(snapshot);
         return;
     }
 
-    QSqlQuery teamNameQuery(db);
-    if (teamNameQuery.exec("SELECT id, name FROM teams ORDER BY id")) {
-        while (teamNameQuery.next()) {
-            TeamLeaderboardRow teamRow;
-            teamRow.teamId = teamNameQuery.value("id").toInt();
-            teamRow.teamName = teamNameQuery.value("name").toString();
-            teamRow.overallTeamStablefordPoints = 0;
-            teamRow.rank = 0;
-            m_leaderboardData.append(teamRow);
-        }
-    } else {
-        qDebug() << "TeamLeaderboardModel::fetchAllPlayersAndAssignments: ERROR fetching team names:" << teamNameQuery.lastError().text();
-    }
+    m_snapshot = snapshot;
+    m_daysWithScores = m_snapshot.daysWithScores();
 
-    QSqlQuery query(db);
-    if (query.exec("SELECT id, name, handicap, team_id FROM players WHERE active = 1")) {
-        while (query.next()) {
-            PlayerInfo player;
-            player.id = query.value("id").toInt();
-            player.name = query.value("name").toString();
-            player.handicap = query.value("handicap").toInt();
-            m_allPlayers[player.id] = player;
-
-            QVariant teamIdVariant = query.value("team_id");
-            if (!teamIdVariant.isNull()) {
-                int teamId = teamIdVariant.toInt();
-                m_playerTeamAssignments[player.id] = teamId;
-                auto it = std::ranges::find_if(m_leaderboardData,
-                                       [teamId](const TeamLeaderboardRow& row) {
-                                           return row.teamId == teamId;
-                                       });
-                if (it != m_leaderboardData.end()) {
-                    m_leaderboardData[teamId - 1].teamMembers.append(player);
-                }
-            }
-        }
-    } else {
-        qDebug() << "TeamLeaderboardModel::fetchAllPlayersAndAssignments: ERROR executing query:" << query.lastError().text();
+    const int teamId = m_snapshot.teamIdForRow(m_snapshot.rowForPlayer(playerId));
+    auto it = std::ranges::find(m_leaderboardData, teamId, &TeamLeaderboardRow::teamId);
+    if (teamId == -1 || it == m_leaderboardData.end()) {
+        return;
     }
+    const int oldPos = static_cast<int>(it - m_leaderboardData.begin());
+    TeamLeaderboardRow row = *it;
+    scoreTeam(m_snapshot, row, scoresToTake(m_leaderboardData));
+
+    // The rows are sorted by points, so the ones ahead of the team form a prefix,
+    // whether or not it includes the team's old row.
+    const int insertPos = static_cast<int>(std::ranges::count_if(m_leaderboardData, [&row](const TeamLeaderboardRow &other) {
+        return other.overallTeamStablefordPoints > row.overallTeamStablefordPoints;
+    }));
+    const int newPos = insertPos > oldPos ? insertPos - 1 : insertPos;
+    if (newPos != oldPos) {
+        beginMoveRows(QModelIndex(), oldPos, oldPos, QModelIndex(), insertPos);
+        m_leaderboardData.move(oldPos, newPos);
+        m_displayRows.move(oldPos, newPos);
+        endMoveRows();
+    }
+    m_leaderboardData[newPos] = row;
+    m_displayRows[newPos] = displayRow(row);
+    emit dataChanged(index(newPos, 0), index(newPos, ColumnCount - 1));
+    updateRanks();
 }
 
 /**
- * @brief Fetches details for all holes from the database.
+ * @brief Recalculates the rank of every row, updating the rank cells that changed.
  */
-void TeamLeaderboardModel::fetchAllHoleDetails() {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) return;
-    QSqlQuery query(db);
-    if (query.exec("SELECT course_id, hole_num, par, handicap FROM holes")) {
-        while (query.next()) {
-            m_allHoleDetails[qMakePair(query.value("course_id").toInt(), query.value("hole_num").toInt())] =
-                qMakePair(query.value("par").toInt(), query.value("handicap").toInt());
+void TeamLeaderboardModel::updateRanks()
+{
+    int firstChanged = -1;
+    int lastChanged = -1;
+    for (int i = 0; i < m_leaderboardData.size(); ++i) {
+        int rank = i + 1;
+        if (i > 0 && m_leaderboardData.at(i).overallTeamStablefordPoints == m_leaderboardData.at(i - 1).overallTeamStablefordPoints) {
+            rank = m_leaderboardData.at(i - 1).rank;
         }
-    } else {
-        qDebug() << "TeamLeaderboardModel::fetchAllHoleDetails: ERROR:" << query.lastError().text();
+        if (rank == m_leaderboardData.at(i).rank) {
+            continue;
+        }
+        m_leaderboardData[i].rank = rank;
+        m_displayRows[i] = displayRow(m_leaderboardData.at(i));
+        if (firstChanged < 0) firstChanged = i;
+        lastChanged = i;
     }
+
+    if (firstChanged >= 0) {
+        emit dataChanged(index(firstChanged, 0), index(lastChanged, 0), {Qt::DisplayRole});
+    }
+}
+
+/**
+ * @brief Builds the displayed cells of a team row.
+ */
+TeamLeaderboardModel::DisplayRow TeamLeaderboardModel::displayRow(const TeamLeaderboardRow &row) {
+    return { row.rank > 0 ? QVariant(row.rank) : QVariant(QStringLiteral("-")), row.teamName,
+             row.dailyTeamStablefordPoints.value(1, 0), row.dailyTeamStablefordPoints.value(2, 0),
+             row.dailyTeamStablefordPoints.value(3, 0), row.overallTeamStablefordPoints };
+}
+
+QSet<int> TeamLeaderboardModel::getDaysWithScores() const {
+    return m_daysWithScores;
 }
 
 /**
- * @brief Fetches all scores from the database.
+ * @brief Builds one leaderboard row per team and places each active player on their team.
+ * @param snapshot The tournament data.
+ * @return The unranked team rows.
  */
-void TeamLeaderboardModel::fetchAllScores() {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) return;
-    QSqlQuery query(db);
-    if (query.exec("SELECT player_id, course_id, hole_num, day_num, score FROM scores")) {
-        while (query.next()) {
-            int playerId = query.value("player_id").toInt();
-            int dayNum = query.value("day_num").toInt();
-            int holeNum = query.value("hole_num").toInt();
-            int scoreVal = query.value("score").toInt();
-            int courseId = query.value("course_id").toInt();
-            m_allScores[playerId][dayNum][holeNum] = qMakePair(scoreVal, courseId);
-            m_daysWithScores.insert(dayNum);
+QVector<TeamLeaderboardRow> TeamLeaderboardModel::assignTeamMembers(const TournamentSnapshot &snapshot) {
+    QVector<TeamLeaderboardRow> rows;
+    for (const TeamInfo &team : snapshot.teams()) {
+        TeamLeaderboardRow teamRow;
+        teamRow.teamId = team.id;
+        teamRow.teamName = team.name;
+        teamRow.overallTeamStablefordPoints = 0;
+        teamRow.rank = 0;
+        rows.append(teamRow);
+    }
+
+    const QVector<PlayerInfo> &allPlayers = snapshot.players();
+    for (int playerRow = 0; playerRow < allPlayers.size(); ++playerRow) {
+        int teamId = snapshot.teamIdForRow(playerRow);
+        if (teamId == -1) {
+            continue;
+        }
+        auto it = std::ranges::find_if(rows,
+                                       [teamId](const TeamLeaderboardRow& row) {
+                                           return row.teamId == teamId;
+                                       });
+        if (it != rows.end()) {
+            it->teamMembers.append(allPlayers.at(playerRow));
+            it->memberRows.append(playerRow);
         }
-    } else {
-        qDebug() << "TeamLeaderboardModel::fetchAllScores: ERROR:" << query.lastError().text();
     }
+    return rows;
 }
 
 /**
  * @brief Gets a single player's net stableford score for a specific hole.
- * @param member The player.
+ * @param snapshot The tournament data.
+ * @param playerRow The player's snapshot row.
  * @param dayNum The day number.
  * @param holeNum The hole number.
  * @return The player's net stableford score, or an empty optional if not available.
  */
 std::optional<int> TeamLeaderboardModel::getPlayerNetStablefordForHole(
-    const PlayerInfo& member, int dayNum, int holeNum) const
+    const TournamentSnapshot &snapshot, int playerRow, int dayNum, int holeNum)
 {
-    if (!m_allScores.contains(member.id) ||
-        !m_allScores[member.id].contains(dayNum) ||
-        !m_allScores[member.id][dayNum].contains(holeNum)) {
+    if (!snapshot.hasRound(playerRow, dayNum)) {
         return std::nullopt;
     }
 
-    const auto& scoreInfo = m_allScores[member.id][dayNum][holeNum];
-    int playerScoreGross = scoreInfo.first;
-    int courseIdForScore = scoreInfo.second;
-
-    const auto& holeDetailsKey = qMakePair(courseIdForScore, holeNum);
-    if (!m_allHoleDetails.contains(holeDetailsKey)) {
-        return std::nullopt;
-    }
-
-    const auto& holeDetails = m_allHoleDetails[holeDetailsKey];
-    int par = holeDetails.first;
-    int holeHcIndex = holeDetails.second;
-
-    int strokesReceived = calculateStrokesReceived(member.handicap, holeHcIndex);
-    int netPlayerScore = playerScoreGross - strokesReceived;
-    
-    if (stableford_conversion.contains(netPlayerScore - par)) {
-        return stableford_conversion.at(netPlayerScore - par);
-    } else {
-        qDebug() << "Invalid score " << netPlayerScore << "on par " << par;
+    qint8 points = snapshot.roundNetHolePoints(playerRow, dayNum)[holeNum - 1];
+    if (points == StablefordKernel::NotPlayed) {
         return std::nullopt;
     }
+    return points;
 }
 
 /**
  * @brief Calculates the team score for a single hole.
+ * @param snapshot The tournament data.
  * @param team The team.
  * @param dayNum The day number.
  * @param holeNum The hole number.
  * @param numScoresToTake The number of top scores to take.
  * @return The team's score for the hole.
  */
-int TeamLeaderboardModel::calculateTeamScoreForHole(TeamLeaderboardRow &team, int dayNum, int holeNum, int numScoresToTake) const
+int TeamLeaderboardModel::calculateTeamScoreForHole(const TournamentSnapshot &snapshot, const TeamLeaderboardRow &team, int dayNum, int holeNum, int numScoresToTake)
 {
-    auto scores_view = team.teamMembers
-                       | std::views::transform([&](const PlayerInfo &member)
-                                               { return getPlayerNetStablefordForHole(member, dayNum, holeNum); })
+    auto scores_view = team.memberRows
+                       | std::views::transform([&](int memberRow)
+                                               { return getPlayerNetStablefordForHole(snapshot, memberRow, dayNum, holeNum); })
                        | std::views::filter([](const std::optional<int> &score)
                                             { return score.has_value(); })
                        | std::views::transform([](const std::optional<int> &score)
@@ -278,40 +276,61 @@ int TeamLeaderboardModel::calculateTeamScoreForHole(TeamLeaderboardRow &team, in
 }
 
 /**
- * @brief Calculates the team leaderboard.
+ * @brief Gets how many member scores count towards a team's score on each hole.
+ *
+ * Every team counts all but one of the largest team's members.
+ *
+ * @param rows The team rows with their members assigned.
  */
-void TeamLeaderboardModel::calculateTeamLeaderboard()
+int TeamLeaderboardModel::scoresToTake(const QVector<TeamLeaderboardRow> &rows)
 {
-    if (m_allPlayers.isEmpty() || m_allHoleDetails.isEmpty()) {
-        qDebug() << "TeamLeaderboardModel: Not enough data to calculate (players or hole details missing).";
-        return;
-    }
-
-    auto largestTeam = std::ranges::max(m_leaderboardData, [&](const TeamLeaderboardRow &a, const TeamLeaderboardRow &b)
+    auto largestTeam = std::ranges::max(rows, [&](const TeamLeaderboardRow &a, const TeamLeaderboardRow &b)
                      { return a.teamMembers.size() < b.teamMembers.size(); });
 
-    int numScoresToTake = (largestTeam.teamMembers.size() > 1) ? largestTeam.teamMembers.size() - 1 : 1;
+    return (largestTeam.teamMembers.size() > 1) ? largestTeam.teamMembers.size() - 1 : 1;
+}
 
+/**
+ * @brief Calculates a team's daily and overall points.
+ * @param snapshot The tournament data.
+ * @param teamRow The team row to score in place.
+ * @param numScoresToTake The number of top scores to take on each hole.
+ */
+void TeamLeaderboardModel::scoreTeam(const TournamentSnapshot &snapshot, TeamLeaderboardRow &teamRow, int numScoresToTake)
+{
     std::ranges::for_each(std::views::iota(1, 4), [&](int dayNum) {
-        std::ranges::for_each(m_leaderboardData, [&](TeamLeaderboardRow &teamRow) {
-            int teamDailyTotalStablefordPoints = 0;
-            std::ranges::for_each(std::views::iota(1, 19), [&](int holeNum)
-                                  { teamDailyTotalStablefordPoints += calculateTeamScoreForHole(teamRow, dayNum, holeNum, numScoresToTake); });
-            teamRow.dailyTeamStablefordPoints[dayNum] = teamDailyTotalStablefordPoints;
-        }); 
+        int teamDailyTotalStablefordPoints = 0;
+        std::ranges::for_each(std::views::iota(1, 19), [&](int holeNum)
+                              { teamDailyTotalStablefordPoints += calculateTeamScoreForHole(snapshot, teamRow, dayNum, holeNum, numScoresToTake); });
+        teamRow.dailyTeamStablefordPoints[dayNum] = teamDailyTotalStablefordPoints;
     });
 
-    std::ranges::for_each(m_leaderboardData, [](TeamLeaderboardRow &teamRow)
-                          { teamRow.overallTeamStablefordPoints = std::ranges::fold_left(teamRow.dailyTeamStablefordPoints, 0, std::plus<>{}); });
+    teamRow.overallTeamStablefordPoints = std::ranges::fold_left(teamRow.dailyTeamStablefordPoints, 0, std::plus<>{});
+}
 
-    std::ranges::sort(m_leaderboardData, [](const TeamLeaderboardRow &a, const TeamLeaderboardRow &b)
+/**
+ * @brief Calculates the team leaderboard.
+ * @param snapshot The tournament data.
+ * @param rows The team rows to score and rank in place.
+ */
+void TeamLeaderboardModel::calculateTeamLeaderboard(const TournamentSnapshot &snapshot, QVector<TeamLeaderboardRow> &rows)
+{
+    if (snapshot.players().isEmpty() || !snapshot.hasHoleDetails() || rows.isEmpty()) {
+        qDebug() << "TeamLeaderboardModel: Not enough data to calculate (players or hole details missing).";
+        return;
+    }
+
+    const int numScoresToTake = scoresToTake(rows);
+    std::ranges::for_each(rows, [&](TeamLeaderboardRow &teamRow) { scoreTeam(snapshot, teamRow, numScoresToTake); });
+
+    std::ranges::sort(rows, [](const TeamLeaderboardRow &a, const TeamLeaderboardRow &b)
                       { return a.overallTeamStablefordPoints > b.overallTeamStablefordPoints; });
 
-    for (int i = 0; i < m_leaderboardData.size(); ++i) {
-        if (i > 0 && m_leaderboardData[i].overallTeamStablefordPoints == m_leaderboardData[i - 1].overallTeamStablefordPoints) {
-            m_leaderboardData[i].rank = m_leaderboardData[i - 1].rank;
+    for (int i = 0; i < rows.size(); ++i) {
+        if (i > 0 && rows[i].overallTeamStablefordPoints == rows[i - 1].overallTeamStablefordPoints) {
+            rows[i].rank = rows[i - 1].rank;
         } else {
-            m_leaderboardData[i].rank = i + 1;
+            rows[i].rank = i + 1;
         }
     }
 }
@@ -14,7 +14,11 @@
 #include <QMap>
 #include <QSet>
 #include <QDebug>
+#include <array>
 #include "CommonStructs.h"
+#include "TournamentSnapshot.h"
+#include "ChangeTracker.h"
+#include "LeaderboardProxyModel.h"
 
 /**
  * @struct TeamLeaderboardRow
@@ -27,6 +31,7 @@ struct TeamLeaderboardRow {
     QMap<int, int> dailyTeamStablefordPoints; ///< Map of DayNum to total points for the team on that day.
     int overallTeamStablefordPoints;        ///< The overall total Stableford points for the team.
     QVector<PlayerInfo> teamMembers;        ///< The players who are members of the team.
+    QVector<int> memberRows;                ///< The snapshot rows of the team members.
 };
 
 /**
@@ -34,12 +39,15 @@ struct TeamLeaderboardRow {
  * @brief A model for calculating and displaying a team leaderboard.
  *
  * This model calculates team scores based on the individual scores of team members
- * and provides the data to a view.
+ * and provides the data to a view. The displayed cells are built when results
+ * are set, so data() only indexes into an array.
  */
-class TeamLeaderboardModel : public QAbstractTableModel {
+class TeamLeaderboardModel : public QAbstractTableModel, public LeaderboardSortKeys {
     Q_OBJECT
 
 public:
+    static constexpr int ColumnCount = 6; ///< Rank, team name, points per day and overall points.
+
     /**
      * @brief Constructs a TeamLeaderboardModel object.
      * @param connectionName The name of the database connection to use.
@@ -58,11 +66,48 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
+    // LeaderboardSortKeys overrides
+    int sortKey(int row, int column) const override;
+    const QString &rowName(int row) const override { return m_leaderboardData.at(row).teamName; }
+    int nameColumn() const override { return 1; }
+
     /**
      * @brief Refreshes the data and recalculates the leaderboard.
      */
     void refreshData();
 
+    /**
+     * @brief Recalculates the leaderboard from an already loaded snapshot.
+     * @param snapshot The tournament data shared with the other leaderboard models.
+     */
+    void refreshData(const TournamentSnapshot &snapshot);
+
+    /**
+     * @brief Rescores only the team of a player whose score changed.
+     * @param snapshot The snapshot holding the changed score.
+     * @param playerId The player whose score changed.
+     */
+    void applyScoreChange(const TournamentSnapshot &snapshot, int playerId);
+
+    /**
+     * @brief Calculates the ranked team rows without touching any model.
+     * @param snapshot The tournament data.
+     * @return The ranked team rows.
+     */
+    static QVector<TeamLeaderboardRow> calculate(const TournamentSnapshot &snapshot);
+
+    /**
+     * @brief Gets the tables whose changes affect the team leaderboard.
+     */
+    static ChangeTracker::Tables dependencies() { return ChangeTracker::Players | ChangeTracker::Courses | ChangeTracker::Holes | ChangeTracker::Scores | ChangeTracker::Teams | ChangeTracker::Events; }
+
+    /**
+     * @brief Swaps rows returned by calculate() into the model.
+     * @param snapshot The snapshot the rows were calculated from.
+     * @param rows The ranked team rows.
+     */
+    void setResult(const TournamentSnapshot &snapshot, const QVector<TeamLeaderboardRow> &rows);
+
     /**
      * @brief Gets the set of days that have scores recorded.
      * @return A QSet of day numbers.
@@ -70,22 +115,23 @@ public:
     QSet<int> getDaysWithScores() const;
 
 private:
+    using DisplayRow = std::array<QVariant, ColumnCount>; ///< The DisplayRole value of each column.
+
     QString m_connectionName;
     QVector<TeamLeaderboardRow> m_leaderboardData;
+    QVector<DisplayRow> m_displayRows;  ///< The displayed cells, parallel to m_leaderboardData.
     QSet<int> m_daysWithScores;
 
-    QMap<int, PlayerInfo> m_allPlayers;
-    QMap<int, int> m_playerTeamAssignments;
-    QMap<QPair<int, int>, QPair<int, int>> m_allHoleDetails;
-    QMap<int, QMap<int, QMap<int, QPair<int, int>>>> m_allScores;
-
-    QSqlDatabase database() const;
-    void fetchAllPlayersAndAssignments();
-    void fetchAllHoleDetails();
-    void fetchAllScores();
-    std::optional<int> getPlayerNetStablefordForHole(const PlayerInfo& member, int dayNum, int holeNum) const;
-    int calculateTeamScoreForHole(TeamLeaderboardRow & teamRow, int dayNum, int holeNum, int numScoresToTake) const;
-    void calculateTeamLeaderboard();
+    TournamentSnapshot m_snapshot;
+
+    static QVector<TeamLeaderboardRow> assignTeamMembers(const TournamentSnapshot &snapshot);
+    static std::optional<int> getPlayerNetStablefordForHole(const TournamentSnapshot &snapshot, int playerRow, int dayNum, int holeNum);
+    static int calculateTeamScoreForHole(const TournamentSnapshot &snapshot, const TeamLeaderboardRow &teamRow, int dayNum, int holeNum, int numScoresToTake);
+    static int scoresToTake(const QVector<TeamLeaderboardRow> &rows);
+    static void scoreTeam(const TournamentSnapshot &snapshot, TeamLeaderboardRow &teamRow, int numScoresToTake);
+    static void calculateTeamLeaderboard(const TournamentSnapshot &snapshot, QVector<TeamLeaderboardRow> &rows);
+    static DisplayRow displayRow(const TeamLeaderboardRow &row);
+    void updateRanks();
 };
 
 #endif // TEAMLEADERBOARDMODEL_H
@@ -14,12 +14,20 @@ TeamLeaderboardWidget::TeamLeaderboardWidget(const QString &connectionName, QWid
     : QWidget(parent),
       m_connectionName(connectionName),
       leaderboardModel(new TeamLeaderboardModel(connectionName, this)),
-      leaderboardView(new QTableView(this)) {
+      proxyModel(new LeaderboardProxyModel(this)),
+      leaderboardView(new QTableView(this)),
+      searchEdit(new QLineEdit(this)) {
 
-    leaderboardView->setModel(leaderboardModel);
+    proxyModel->setSourceModel(leaderboardModel);
+    leaderboardView->setModel(proxyModel);
     configureTableView();
 
+    searchEdit->setPlaceholderText(tr("Search teams..."));
+    searchEdit->setClearButtonEnabled(true);
+    connect(searchEdit, &QLineEdit::textChanged, proxyModel, &LeaderboardProxyModel::setNameFilter);
+
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(searchEdit);
     mainLayout->addWidget(leaderboardView);
     setLayout(mainLayout);
 }
@@ -46,6 +54,9 @@ void TeamLeaderboardWidget::configureTableView() {
     leaderboardView->horizontalHeader()->setSectionResizeMode(3, QHeaderView::ResizeToContents); // Day 2
     leaderboardView->horizontalHeader()->setSectionResizeMode(4, QHeaderView::ResizeToContents); // Day 3
     leaderboardView->horizontalHeader()->setSectionResizeMode(5, QHeaderView::ResizeToContents); // Overall
+
+    leaderboardView->setSortingEnabled(true);
+    leaderboardView->sortByColumn(LeaderboardProxyModel::RankColumn, Qt::AscendingOrder);
 }
 
 void TeamLeaderboardWidget::refreshData() {
@@ -53,6 +64,21 @@ void TeamLeaderboardWidget::refreshData() {
     updateColumnVisibility();
 }
 
+void TeamLeaderboardWidget::refreshData(const TournamentSnapshot &snapshot) {
+    leaderboardModel->refreshData(snapshot);
+    updateColumnVisibility();
+}
+
+void TeamLeaderboardWidget::applyScoreChange(const TournamentSnapshot &snapshot, int playerId) {
+    leaderboardModel->applyScoreChange(snapshot, playerId);
+    updateColumnVisibility();
+}
+
+void TeamLeaderboardWidget::setResult(const TournamentSnapshot &snapshot, const QVector<TeamLeaderboardRow> &rows) {
+    leaderboardModel->setResult(snapshot, rows);
+    updateColumnVisibility();
+}
+
 /**
  * @brief Updates the visibility of the daily score columns.
  */
@@ -63,92 +89,21 @@ void TeamLeaderboardWidget::updateColumnVisibility() {
     leaderboardView->setColumnHidden(4, !daysWithScores.contains(3));
 }
 
-QImage TeamLeaderboardWidget::exportToImage() const {
-    int rowCount = leaderboardModel->rowCount();
-    int colCount = leaderboardModel->columnCount();
-
-    if (rowCount == 0 || colCount == 0) {
-        qDebug() << "TeamLeaderboardWidget::exportToImage: No data to export.";
-        return QImage();
-    }
-
-    int titleHeight = 200;
-    int headerHeight = 120;
-    int rowHeight = 100;
-    int padding = 15;
-    QVector<int> columnWidths = {180, 550, 400, 400, 400, 440};
-
-    int totalWidth = padding * 2;
-    for(int i=0; i < colCount; ++i) {
-        if (!leaderboardView->isColumnHidden(i)) {
-            totalWidth += columnWidths.at(i);
+LeaderboardImageExporter TeamLeaderboardWidget::imageExporter() const {
+    LeaderboardImageExporter::Layout layout;
+    layout.title = "Team Leaderboard";
+    const QVector<int> columnWidths = {180, 550, 400, 400, 400, 440};
+    for (int col = 0; col < leaderboardModel->columnCount(); ++col) {
+        if (!leaderboardView->isColumnHidden(col)) {
+            layout.columns.append({ col, col < columnWidths.size() ? columnWidths.at(col) : 440 });
         }
     }
-    
-    int totalHeight = padding * 2 + titleHeight + headerHeight + (rowCount * rowHeight);
-
-    QImage image(totalWidth, totalHeight, QImage::Format_ARGB32);
-    image.fill(Qt::white);
-    QPainter painter(&image);
-    painter.setRenderHint(QPainter::Antialiasing);
-    painter.setPen(Qt::white);
-
-    painter.setFont(QFont("Arial", 64, QFont::Bold));
-    QRect titleRect(padding, padding, totalWidth - 2 * padding, titleHeight);
-    painter.fillRect(titleRect, Qt::black);
-    painter.drawText(titleRect, Qt::AlignCenter, "Team Leaderboard");
-
-    painter.setFont(QFont("Arial", 48, QFont::Bold));
-    int currentX = padding;
-    int currentY = padding + titleHeight;
-    for (int col = 0; col < colCount; ++col) {
-        if (leaderboardView->isColumnHidden(col)) continue;
-        QRect headerRect(currentX, currentY, columnWidths.at(col), headerHeight);
-        painter.fillRect(headerRect, Qt::black);
-        painter.drawText(headerRect, static_cast<Qt::AlignmentFlag>(leaderboardModel->headerData(col, Qt::Horizontal, Qt::TextAlignmentRole).toInt()),
-                         leaderboardModel->headerData(col, Qt::Horizontal, Qt::DisplayRole).toString());
-        currentX += columnWidths.at(col);
-    }
-
-    painter.setFont(QFont("Arial", 36));
-    painter.setPen(Qt::black);
-    currentY += headerHeight;
-    for (int row = 0; row < rowCount; ++row) {
-        currentX = padding;
-        QColor rowColor = (row % 2 == 0) ? Qt::white : QColor(240, 240, 240);
-        if (leaderboardModel->data(leaderboardModel->index(row, 0), Qt::DisplayRole).toInt() <= 1) {
-            rowColor = QColor(255, 165, 0, 255);
-        }
-
-        painter.fillRect(padding, currentY, totalWidth - 2 * padding, rowHeight, rowColor);
-
-        for (int col = 0; col < colCount; ++col) {
-            if (leaderboardView->isColumnHidden(col)) continue;
-            QRect dataRect(currentX, currentY, columnWidths.at(col), rowHeight);
-            painter.drawText(dataRect, static_cast<Qt::AlignmentFlag>(leaderboardModel->data(leaderboardModel->index(row, col), Qt::TextAlignmentRole).toInt()),
-                             leaderboardModel->data(leaderboardModel->index(row, col), Qt::DisplayRole).toString());
-            currentX += columnWidths.at(col);
-        }
-        currentY += rowHeight;
-    }
-
-    currentY = padding + titleHeight + headerHeight;
-    for (int row = 0; row <= rowCount; ++row) {
-         painter.drawLine(padding, currentY, totalWidth - padding, currentY);
-         currentY += rowHeight;
-    }
-
-    currentX = padding;
-    currentY = padding + titleHeight + headerHeight;
-    painter.drawLine(currentX, padding, currentX, totalHeight - padding);
-    for (int col = 0; col < colCount; ++col) {
-        if (leaderboardView->isColumnHidden(col)) continue;
-        int colWidth = (col < columnWidths.size()) ? columnWidths.at(col) : 440;
-        painter.drawLine(currentX, currentY, currentX, totalHeight - padding);
-        currentX += colWidth;
-    }
-    painter.drawLine(currentX, padding, currentX, totalHeight - padding);
-    
-    painter.end();
-    return image;
+    layout.titleHeight = 200;
+    layout.headerHeight = 120;
+    layout.rowHeight = 100;
+    layout.titleFontSize = 64;
+    layout.headerFontSize = 48;
+    layout.rowFontSize = 36;
+    layout.highlightedRanks = 1;
+    return LeaderboardImageExporter(leaderboardModel, layout);
 }
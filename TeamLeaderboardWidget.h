@@ -11,7 +11,10 @@
 #include <QTableView>
 #include <QVBoxLayout>
 #include <QHeaderView>
+#include <QLineEdit>
 #include "TeamLeaderboardModel.h"
+#include "LeaderboardProxyModel.h"
+#include "LeaderboardImageExporter.h"
 
 class QPainter;
 class QImage;
@@ -46,15 +49,37 @@ public:
     void refreshData();
 
     /**
-     * @brief Exports the leaderboard as an image.
-     * @return The leaderboard rendered as a QImage.
+     * @brief Refreshes the leaderboard from an already loaded snapshot.
+     * @param snapshot The tournament data shared with the other leaderboards.
      */
-    QImage exportToImage() const;
+    void refreshData(const TournamentSnapshot &snapshot);
+
+    /**
+     * @brief Applies a single score change without resetting the view.
+     * @param snapshot The snapshot holding the changed score.
+     * @param playerId The player whose score changed.
+     */
+    void applyScoreChange(const TournamentSnapshot &snapshot, int playerId);
+
+    /**
+     * @brief Shows team rows calculated on a worker thread.
+     * @param snapshot The snapshot the rows were calculated from.
+     * @param rows The ranked team rows.
+     */
+    void setResult(const TournamentSnapshot &snapshot, const QVector<TeamLeaderboardRow> &rows);
+
+    /**
+     * @brief Gets an exporter that renders the visible columns as fixed-size pages.
+     * @return An exporter reading this widget's model.
+     */
+    LeaderboardImageExporter imageExporter() const;
 
 private:
     QString m_connectionName;
     TeamLeaderboardModel *leaderboardModel;
+    LeaderboardProxyModel *proxyModel;
     QTableView *leaderboardView;
+    QLineEdit *searchEdit;
 
     QSqlDatabase database() const;
     void configureTableView();
@@ -0,0 +1,83 @@
+/**
+ * @file TournamentEvents.cpp
+ * @brief Implements reading and switching tournament events.
+ */
+
+#include "TournamentEvents.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+
+namespace TournamentEvents {
+
+QVector<EventInfo> list(const QSqlDatabase &db)
+{
+    QVector<EventInfo> events;
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT id, name, is_current FROM events ORDER BY id DESC")) {
+        qDebug() << "TournamentEvents::list: ERROR:" << query.lastError().text();
+        return events;
+    }
+    while (query.next()) {
+        events.append({ query.value(0).toInt(), query.value(1).toString(), query.value(2).toBool() });
+    }
+    return events;
+}
+
+int currentEventId(const QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT id FROM current_event")) {
+        qDebug() << "TournamentEvents::currentEventId: ERROR:" << query.lastError().text();
+        return -1;
+    }
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+bool setCurrentEvent(QSqlDatabase &db, int eventId)
+{
+    if (!db.transaction()) {
+        qWarning() << "TournamentEvents::setCurrentEvent: Could not start transaction:" << db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    // The partial unique index allows only one current event, so clear the old one first.
+    if (!query.exec("UPDATE events SET is_current = 0 WHERE is_current = 1") ||
+        !query.prepare("UPDATE events SET is_current = 1 WHERE id = :id")) {
+        qWarning() << "TournamentEvents::setCurrentEvent: ERROR:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+    query.bindValue(":id", eventId);
+    if (!query.exec() || query.numRowsAffected() != 1) {
+        qWarning() << "TournamentEvents::setCurrentEvent: Event" << eventId << "could not be selected:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    if (!db.commit()) {
+        qWarning() << "TournamentEvents::setCurrentEvent: Could not commit:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+    return true;
+}
+
+int createEvent(QSqlDatabase &db, const QString &name)
+{
+    QSqlQuery query(db);
+    query.prepare("INSERT INTO events (name) VALUES (:name)");
+    query.bindValue(":name", name);
+    if (!query.exec()) {
+        qWarning() << "TournamentEvents::createEvent: ERROR adding" << name << ":" << query.lastError().text();
+        return -1;
+    }
+    return query.lastInsertId().toInt();
+}
+
+} // namespace TournamentEvents
@@ -0,0 +1,65 @@
+/**
+ * @file TournamentEvents.h
+ * @brief Contains the declarations for reading and switching tournament events.
+ */
+
+#ifndef TOURNAMENTEVENTS_H
+#define TOURNAMENTEVENTS_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+/**
+ * @struct EventInfo
+ * @brief Holds the details of one tournament event.
+ */
+struct EventInfo {
+    int id;             ///< The unique identifier for the event.
+    QString name;       ///< The name of the event, e.g. "Mosley Open 2025".
+    bool isCurrent;     ///< Whether this is the current event.
+};
+
+/**
+ * @namespace TournamentEvents
+ * @brief Lists the events in the database and selects the current one.
+ *
+ * Scores, settings, teams and team assignments belong to an event. Exactly
+ * one event is current; every connection reads and writes the current event
+ * through the current_event view, so switching events takes effect for all
+ * connections at their next statement.
+ */
+namespace TournamentEvents {
+
+/**
+ * @brief Gets every event, newest first.
+ * @param db An open connection.
+ */
+QVector<EventInfo> list(const QSqlDatabase &db);
+
+/**
+ * @brief Gets the id of the current event.
+ * @param db An open connection.
+ * @return The event id, or -1 if there is no current event or the query failed.
+ */
+int currentEventId(const QSqlDatabase &db);
+
+/**
+ * @brief Makes an event the current one.
+ * @param db An open read-write connection.
+ * @param eventId The event to select.
+ * @return True if the event exists and is now current.
+ */
+bool setCurrentEvent(QSqlDatabase &db, int eventId);
+
+/**
+ * @brief Adds an event. The current event is not changed.
+ * @param db An open read-write connection.
+ * @param name The unique name of the event.
+ * @return The id of the new event, or -1 if it could not be added.
+ */
+int createEvent(QSqlDatabase &db, const QString &name);
+
+} // namespace TournamentEvents
+
+#endif // TOURNAMENTEVENTS_H
@@ -5,6 +5,9 @@
 
 #include "tournamentleaderboarddialog.h"
 #include "tournamentleaderboardmodel.h"
+#include "TournamentSnapshot.h"
+#include "TournamentRepository.h"
+#include "DatabaseManager.h"
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -17,35 +20,131 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QDir>
+#include <QFileInfo>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QAbstractTableModel>
+#include <QAtomicInteger>
+#include <QPromise>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <optional>
 
 const QString SETTING_CUT_LINE_SCORE = "cutLineScore";
 const QString SETTING_IS_CUT_APPLIED = "isCutApplied";
 const int DEFAULT_CUT_LINE_SCORE = 0;
 
+/**
+ * @brief Calculates every leaderboard from the snapshot already stored in @p results.
+ * @param results Holds the snapshot on entry and receives the leaderboards.
+ * @param cutLineScore The cut line score.
+ * @param isCutApplied Whether the cut is applied.
+ * @param promise The running refresh, checked between leaderboards for cancellation; may be null.
+ */
+static void calculateLeaderboards(LeaderboardResults &results, int cutLineScore, bool isCutApplied, QPromise<LeaderboardResults> *promise)
+{
+    auto isCanceled = [promise] { return promise && promise->isCanceled(); };
+
+    if (results.changedTables & TournamentLeaderboardModel::dependencies()) {
+        results.mosleyOpen = TournamentLeaderboardModel::calculate(results.snapshot, TournamentLeaderboardModel::MosleyOpen, cutLineScore, isCutApplied);
+        if (isCanceled()) return;
+        results.twistedCreek = TournamentLeaderboardModel::calculate(results.snapshot, TournamentLeaderboardModel::TwistedCreek, cutLineScore, isCutApplied);
+    }
+    if (results.changedTables & DailyLeaderboardModel::dependencies()) {
+        for (int dayNum = 1; dayNum <= TournamentSnapshot::MaxDays; ++dayNum) {
+            if (isCanceled()) return;
+            results.days[dayNum - 1] = DailyLeaderboardModel::calculate(results.snapshot, dayNum);
+        }
+    }
+    if (results.changedTables & TeamLeaderboardModel::dependencies()) {
+        if (isCanceled()) return;
+        results.teams = TeamLeaderboardModel::calculate(results.snapshot);
+    }
+}
+
+/**
+ * @brief Loads a snapshot and calculates every leaderboard on a worker thread.
+ *
+ * QSqlDatabase connections can only be used by the thread that opened them, so
+ * the worker opens a read-only connection under a unique name and closes it
+ * again when done. An invalid snapshot is reported if it cannot be opened.
+ *
+ * @param promise The promise receiving the results.
+ * @param connectionName The dialog's connection, used to name the worker's connection.
+ * @param cutLineScore The cut line score.
+ * @param isCutApplied Whether the cut is applied.
+ * @param changedTables The tables changed since the shown leaderboards were calculated.
+ */
+static void computeLeaderboards(QPromise<LeaderboardResults> &promise, const QString &connectionName, int cutLineScore, bool isCutApplied,
+                                ChangeTracker::Tables changedTables)
+{
+    static QAtomicInteger<quint64> workerConnectionCounter;
+    const QString workerConnectionName = QString("%1_leaderboard_worker_%2").arg(connectionName).arg(++workerConnectionCounter);
+
+    LeaderboardResults results;
+    results.changedTables = changedTables;
+    {
+        QSqlDatabase db = DatabaseManager::open(workerConnectionName, DatabaseManager::Access::ReadOnly);
+        if (db.isOpen()) {
+            results.snapshot = TournamentSnapshot::load(workerConnectionName);
+        } else {
+            qWarning() << "TournamentLeaderboardDialog: Could not open worker connection:" << db.lastError().text();
+        }
+    }
+    DatabaseManager::close(workerConnectionName);
+
+    if (promise.isCanceled()) return;
+    if (results.snapshot.isValid()) {
+        calculateLeaderboards(results, cutLineScore, isCutApplied, &promise);
+        if (promise.isCanceled()) return;
+    }
+    promise.addResult(results);
+}
+
 TournamentLeaderboardDialog::TournamentLeaderboardDialog(const QString &connectionName, QWidget *parent)
+    : TournamentLeaderboardDialog(connectionName, nullptr, {}, parent)
+{
+}
+
+TournamentLeaderboardDialog::TournamentLeaderboardDialog(const TournamentSnapshot &archive, const TournamentSnapshot::CutSettings &cut, QWidget *parent)
+    : TournamentLeaderboardDialog(QString(), &archive, cut, parent)
+{
+}
+
+TournamentLeaderboardDialog::TournamentLeaderboardDialog(const QString &connectionName, const TournamentSnapshot *archive,
+                                                         const TournamentSnapshot::CutSettings &cut, QWidget *parent)
     : QDialog(parent), m_connectionName(connectionName), tabWidget(new QTabWidget(this)),
-      mosleyOpenWidget(new TournamentLeaderboardWidget(m_connectionName, this)), twistedCreekWidget(new TournamentLeaderboardWidget(m_connectionName, this)), day1LeaderboardWidget(new DailyLeaderboardWidget(m_connectionName, 1, this)), day2LeaderboardWidget(new DailyLeaderboardWidget(m_connectionName, 2, this)), day3LeaderboardWidget(new DailyLeaderboardWidget(m_connectionName, 3, this)), teamLeaderboardWidget(new TeamLeaderboardWidget(m_connectionName, this)), cutLineLabel(new QLabel(tr("Cut Line Score (2-Day Mosley Net Stableford):"), this)), cutLineSpinBox(new QSpinBox(this)), applyCutButton(new QPushButton(tr("Apply Cut"), this)), clearCutButton(new QPushButton(tr("Clear Cut"), this)), refreshButton(new QPushButton(tr("Refresh All"), this)), closeButton(new QPushButton(tr("Close"), this)), exportImageButton(new QPushButton(tr("Export Current Tab"), this)), m_cutLineScore(DEFAULT_CUT_LINE_SCORE), m_isCutApplied(false)
+      mosleyOpenWidget(new TournamentLeaderboardWidget(m_connectionName, this)), twistedCreekWidget(new TournamentLeaderboardWidget(m_connectionName, this)), day1LeaderboardWidget(new DailyLeaderboardWidget(m_connectionName, 1, this)), day2LeaderboardWidget(new DailyLeaderboardWidget(m_connectionName, 2, this)), day3LeaderboardWidget(new DailyLeaderboardWidget(m_connectionName, 3, this)), teamLeaderboardWidget(new TeamLeaderboardWidget(m_connectionName, this)), cutLineLabel(new QLabel(tr("Cut Line Score (2-Day Mosley Net Stableford):"), this)), cutLineSpinBox(new QSpinBox(this)), applyCutButton(new QPushButton(tr("Apply Cut"), this)), clearCutButton(new QPushButton(tr("Clear Cut"), this)), refreshButton(new QPushButton(tr("Refresh All"), this)), closeButton(new QPushButton(tr("Close"), this)), exportImageButton(new QPushButton(tr("Export Current Tab"), this)), saveArchiveButton(new QPushButton(tr("Save Archive..."), this)), m_changeTracker(connectionName), m_cutLineScore(DEFAULT_CUT_LINE_SCORE), m_isCutApplied(false)
 {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "TournamentLeaderboardDialog: ERROR: Invalid or closed database connection.";
-        refreshButton->setEnabled(false);
-        exportImageButton->setEnabled(false);
-        applyCutButton->setEnabled(false);
-        clearCutButton->setEnabled(false);
-        cutLineSpinBox->setEnabled(false);
-    }
+    m_isArchive = archive != nullptr;
+    if (m_isArchive) {
+        m_cutLineScore = cut.cutLineScore;
+        m_isCutApplied = cut.isCutApplied;
+    } else {
+        QSqlDatabase db = database();
+        if (!db.isValid() || !db.isOpen()) {
+            qDebug() << "TournamentLeaderboardDialog: ERROR: Invalid or closed database connection.";
+            refreshButton->setEnabled(false);
+            exportImageButton->setEnabled(false);
+            saveArchiveButton->setEnabled(false);
+            applyCutButton->setEnabled(false);
+            clearCutButton->setEnabled(false);
+            cutLineSpinBox->setEnabled(false);
+        }
 
-    loadCutSettings();
+        loadCutSettings();
+    }
 
     cutLineSpinBox->setRange(-100, 200);
     cutLineSpinBox->setValue(m_cutLineScore);
-    applyCutButton->setEnabled(!m_isCutApplied);
-    clearCutButton->setEnabled(m_isCutApplied);
+    applyCutButton->setEnabled(!m_isArchive && !m_isCutApplied);
+    clearCutButton->setEnabled(!m_isArchive && m_isCutApplied);
+    if (m_isArchive) {
+        cutLineSpinBox->setEnabled(false);
+        refreshButton->setVisible(false);
+        saveArchiveButton->setVisible(false);
+    }
 
     tabWidget->addTab(mosleyOpenWidget, tr("Mosley Open"));
     tabWidget->addTab(twistedCreekWidget, tr("Twisted Creek"));
@@ -54,31 +153,69 @@ TournamentLeaderboardDialog::TournamentLeaderboardDialog(const QString &connecti
     tabWidget->addTab(day3LeaderboardWidget, tr("Day 3 Scores"));
     tabWidget->addTab(teamLeaderboardWidget, tr("Team Leaderboard"));
 
+    computingLabel = new QLabel(tr("Computing leaderboards..."), this);
+    computingLabel->setVisible(false);
+    m_refreshWatcher = new QFutureWatcher<LeaderboardResults>(this);
+
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     setupCutLineUI(mainLayout);
     mainLayout->addWidget(tabWidget);
 
     QHBoxLayout *bottomButtonLayout = new QHBoxLayout();
+    bottomButtonLayout->addWidget(computingLabel);
     bottomButtonLayout->addStretch();
     bottomButtonLayout->addWidget(refreshButton);
     bottomButtonLayout->addWidget(exportImageButton);
+    bottomButtonLayout->addWidget(saveArchiveButton);
     bottomButtonLayout->addWidget(closeButton);
     mainLayout->addLayout(bottomButtonLayout);
 
     setLayout(mainLayout);
-    setWindowTitle(tr("Tournament Leaderboards"));
+    setWindowTitle(m_isArchive ? tr("Tournament Leaderboards (Archive)") : tr("Tournament Leaderboards"));
     resize(950, 700);
 
     connect(refreshButton, &QPushButton::clicked, this, &TournamentLeaderboardDialog::refreshLeaderboards);
+    connect(m_refreshWatcher, &QFutureWatcher<LeaderboardResults>::finished, this, &TournamentLeaderboardDialog::onRefreshFinished);
     connect(exportImageButton, &QPushButton::clicked, this, &TournamentLeaderboardDialog::exportCurrentImage);
+    connect(saveArchiveButton, &QPushButton::clicked, this, &TournamentLeaderboardDialog::saveArchive);
     connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
     connect(applyCutButton, &QPushButton::clicked, this, &TournamentLeaderboardDialog::applyCutClicked);
     connect(clearCutButton, &QPushButton::clicked, this, &TournamentLeaderboardDialog::clearCutClicked);
 
-    refreshLeaderboards();
+    if (m_isArchive) {
+        configureLeaderboardModels();
+        LeaderboardResults results;
+        results.snapshot = *archive;
+        calculateLeaderboards(results, m_cutLineScore, m_isCutApplied, nullptr);
+        showResults(results);
+
+        // The hole scores are shown before the whole file has been read; damage
+        // is reported once the background check finishes.
+        m_verifyWatcher = new QFutureWatcher<QString>(this);
+        connect(m_verifyWatcher, &QFutureWatcher<QString>::finished, this, [this]() {
+            const QString error = m_verifyWatcher->result();
+            if (!error.isEmpty()) {
+                QMessageBox::warning(this, tr("Open Archive"), tr("The archive is damaged and its leaderboards may be wrong:\n%1").arg(error));
+            }
+        });
+        m_verifyWatcher->setFuture(QtConcurrent::run([snapshot = *archive]() {
+            QString error;
+            snapshot.verifyArchive(&error);
+            return error;
+        }));
+    } else {
+        refreshLeaderboards();
+    }
 }
 
-TournamentLeaderboardDialog::~TournamentLeaderboardDialog() {}
+TournamentLeaderboardDialog::~TournamentLeaderboardDialog()
+{
+    m_refreshWatcher->cancel();
+    m_refreshWatcher->waitForFinished();
+    if (m_verifyWatcher) {
+        m_verifyWatcher->waitForFinished();
+    }
+}
 
 /**
  * @brief Sets up the UI for the cut line controls.
@@ -112,24 +249,19 @@ void TournamentLeaderboardDialog::loadCutSettings()
         m_isCutApplied = false;
         return;
     }
-    QSqlQuery query(db);
-    query.prepare("SELECT value FROM settings WHERE key = :key");
+    TournamentRepository &repository = TournamentRepository::forConnection(m_connectionName);
 
-    query.bindValue(":key", SETTING_CUT_LINE_SCORE);
-    if (query.exec() && query.next()) {
+    QVariant value = repository.readSetting(SETTING_CUT_LINE_SCORE);
+    if (value.isValid()) {
         bool ok;
-        int score = query.value(0).toInt(&ok);
+        int score = value.toInt(&ok);
         m_cutLineScore = ok ? score : DEFAULT_CUT_LINE_SCORE;
     } else {
         m_cutLineScore = DEFAULT_CUT_LINE_SCORE;
     }
 
-    query.bindValue(":key", SETTING_IS_CUT_APPLIED);
-    if (query.exec() && query.next()) {
-        m_isCutApplied = query.value(0).toBool();
-    } else {
-        m_isCutApplied = false;
-    }
+    value = repository.readSetting(SETTING_IS_CUT_APPLIED);
+    m_isCutApplied = value.isValid() && value.toBool();
 }
 
 /**
@@ -140,19 +272,14 @@ void TournamentLeaderboardDialog::saveCutSettings()
     QSqlDatabase db = database();
     if (!db.isValid() || !db.isOpen())
         return;
-    QSqlQuery query(db);
-    query.prepare("INSERT OR REPLACE INTO settings (key, value) VALUES (:key, :value)");
+    TournamentRepository &repository = TournamentRepository::forConnection(m_connectionName);
 
-    query.bindValue(":key", SETTING_CUT_LINE_SCORE);
-    query.bindValue(":value", m_cutLineScore);
-    if (!query.exec()) {
-        qWarning() << "TournamentLeaderboardDialog::saveCutSettings: Failed to save cut_line_score:" << query.lastError().text();
+    if (!repository.writeSetting(SETTING_CUT_LINE_SCORE, m_cutLineScore)) {
+        qWarning() << "TournamentLeaderboardDialog::saveCutSettings: Failed to save cut_line_score:" << repository.lastError();
     }
 
-    query.bindValue(":key", SETTING_IS_CUT_APPLIED);
-    query.bindValue(":value", m_isCutApplied);
-    if (!query.exec()) {
-        qWarning() << "TournamentLeaderboardDialog::saveCutSettings: Failed to save is_cut_applied:" << query.lastError().text();
+    if (!repository.writeSetting(SETTING_IS_CUT_APPLIED, m_isCutApplied)) {
+        qWarning() << "TournamentLeaderboardDialog::saveCutSettings: Failed to save is_cut_applied:" << repository.lastError();
     }
 }
 
@@ -192,12 +319,65 @@ void TournamentLeaderboardDialog::cutLineScoreChanged(int value)
 }
 
 void TournamentLeaderboardDialog::refreshLeaderboards()
+{
+    if (m_isArchive) {
+        return;
+    }
+    configureLeaderboardModels();
+
+    QElapsedTimer timer;
+    timer.start();
+    const ChangeTracker::Stamp stamp = m_changeTracker.current();
+    ChangeTracker::Tables changed = ChangeTracker::changedBetween(m_shownStamp, stamp);
+    if (!m_snapshot.isValid()) {
+        changed = ChangeTracker::AllTables;
+    }
+
+    const ChangeTracker::Tables dependencies = TournamentLeaderboardModel::dependencies() |
+                                               DailyLeaderboardModel::dependencies() |
+                                               TeamLeaderboardModel::dependencies();
+    if (!m_refreshWatcher->isRunning() && !(changed & dependencies)) {
+        qDebug() << "TournamentLeaderboardDialog::refreshLeaderboards: No changes, checked in" << timer.nsecsElapsed() / 1000 << "us";
+        return;
+    }
+
+    if (m_refreshWatcher->isRunning()) {
+        m_refreshWatcher->cancel();
+    }
+    m_refreshStamp = stamp;
+    computingLabel->setVisible(true);
+    m_refreshWatcher->setFuture(QtConcurrent::run(computeLeaderboards, m_connectionName, m_cutLineScore, m_isCutApplied, changed));
+}
+
+/**
+ * @brief Shows the results of the latest refresh once the worker finishes.
+ */
+void TournamentLeaderboardDialog::onRefreshFinished()
+{
+    if (m_refreshWatcher->isCanceled() || m_refreshWatcher->future().resultCount() == 0) {
+        return;
+    }
+    computingLabel->setVisible(false);
+
+    LeaderboardResults results = m_refreshWatcher->result();
+    if (!results.snapshot.isValid()) {
+        qDebug() << "TournamentLeaderboardDialog::onRefreshFinished: Worker could not read the database, refreshing on the GUI thread.";
+        results.snapshot = TournamentSnapshot::load(m_connectionName);
+        calculateLeaderboards(results, m_cutLineScore, m_isCutApplied, nullptr);
+    }
+    showResults(results);
+    m_shownStamp = m_refreshStamp;
+}
+
+/**
+ * @brief Passes the cut line settings and contexts to the overall leaderboard models.
+ */
+void TournamentLeaderboardDialog::configureLeaderboardModels()
 {
     if (TournamentLeaderboardModel *model = qobject_cast<TournamentLeaderboardModel *>(mosleyOpenWidget->leaderboardModel)) {
         model->setTournamentContext(TournamentLeaderboardModel::MosleyOpen);
         model->setCutLineScore(m_cutLineScore);
         model->setIsCutApplied(m_isCutApplied);
-        mosleyOpenWidget->refreshData();
     } else {
         qWarning() << "Failed to cast model for Mosley Open Widget.";
     }
@@ -206,49 +386,132 @@ void TournamentLeaderboardDialog::refreshLeaderboards()
         model->setTournamentContext(TournamentLeaderboardModel::TwistedCreek);
         model->setCutLineScore(m_cutLineScore);
         model->setIsCutApplied(m_isCutApplied);
-        twistedCreekWidget->refreshData();
     } else {
         qWarning() << "Failed to cast model for Twisted Creek Widget.";
     }
+}
+
+/**
+ * @brief Swaps calculated leaderboards into their widgets.
+ *
+ * Leaderboards skipped because none of their tables changed keep their rows.
+ *
+ * @param results The leaderboards to show.
+ */
+void TournamentLeaderboardDialog::showResults(const LeaderboardResults &results)
+{
+    m_snapshot = results.snapshot;
 
-    day1LeaderboardWidget->refreshData();
-    day2LeaderboardWidget->refreshData();
-    day3LeaderboardWidget->refreshData();
-    teamLeaderboardWidget->refreshData();
+    if (results.changedTables & TournamentLeaderboardModel::dependencies()) {
+        mosleyOpenWidget->setResult(results.mosleyOpen);
+        twistedCreekWidget->setResult(results.twistedCreek);
+    }
+    if (results.changedTables & DailyLeaderboardModel::dependencies()) {
+        day1LeaderboardWidget->setResult(results.snapshot, results.days[0]);
+        day2LeaderboardWidget->setResult(results.snapshot, results.days[1]);
+        day3LeaderboardWidget->setResult(results.snapshot, results.days[2]);
+    }
+    if (results.changedTables & TeamLeaderboardModel::dependencies()) {
+        teamLeaderboardWidget->setResult(results.snapshot, results.teams);
+    }
+}
+
+void TournamentLeaderboardDialog::applyScoreChange(int playerId, int courseId, int dayNum, int holeNum, int score)
+{
+    if (m_isArchive) {
+        return;
+    }
+    if (m_refreshWatcher->isRunning()) {
+        // The running refresh may have read the database before this score was saved.
+        refreshLeaderboards();
+        return;
+    }
+    if (!m_snapshot.isValid()) {
+        return;
+    }
+
+    m_snapshot = m_snapshot.withScore(playerId, courseId, dayNum, holeNum, score, m_connectionName);
+
+    mosleyOpenWidget->applyScoreChange(m_snapshot, playerId);
+    twistedCreekWidget->applyScoreChange(m_snapshot, playerId);
+    day1LeaderboardWidget->applyScoreChange(m_snapshot, playerId, dayNum);
+    day2LeaderboardWidget->applyScoreChange(m_snapshot, playerId, dayNum);
+    day3LeaderboardWidget->applyScoreChange(m_snapshot, playerId, dayNum);
+    teamLeaderboardWidget->applyScoreChange(m_snapshot, playerId);
 }
 
 /**
- * @brief Exports the currently visible leaderboard as an image.
+ * @brief Exports the currently visible leaderboard as a series of images or a PDF.
+ *
+ * Long leaderboards are split into pages of a fixed number of rows, so the
+ * export needs the same memory however large the field is.
  */
 void TournamentLeaderboardDialog::exportCurrentImage()
 {
     QWidget *currentWidget = tabWidget->currentWidget();
-    QImage exportedImage;
+    std::optional<LeaderboardImageExporter> exporter;
 
     if (TournamentLeaderboardWidget *overallWidget = qobject_cast<TournamentLeaderboardWidget *>(currentWidget)) {
-        exportedImage = overallWidget->exportToImage();
+        exporter = overallWidget->imageExporter();
     } else if (DailyLeaderboardWidget *dailyWidget = qobject_cast<DailyLeaderboardWidget *>(currentWidget)) {
-        exportedImage = dailyWidget->exportToImage();
+        exporter = dailyWidget->imageExporter();
     } else if (TeamLeaderboardWidget *teamWidget = qobject_cast<TeamLeaderboardWidget *>(currentWidget)) {
-        exportedImage = teamWidget->exportToImage();
+        exporter = teamWidget->imageExporter();
     } else {
         QMessageBox::warning(this, tr("Export Failed"), tr("Cannot export the current tab type."));
         return;
     }
 
-    if (exportedImage.isNull()) {
-        qDebug() << "TournamentLeaderboardDialog::exportCurrentImage: ExportToImage returned null for widget:" << (currentWidget ? currentWidget->objectName() : "null");
+    const QString pdfFilter = tr("PDF Files (*.pdf)");
+    QString selectedFilter;
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Save Leaderboard Image"), QDir::homePath(),
+                                                    tr("PNG Files (*.png)") + ";;" + pdfFilter + ";;" + tr("JPEG Files (*.jpg *.jpeg);;BMP Files (*.bmp)"),
+                                                    &selectedFilter);
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    const bool isPdf = selectedFilter == pdfFilter || QFileInfo(filePath).suffix().compare("pdf", Qt::CaseInsensitive) == 0;
+    if (isPdf) {
+        if (QFileInfo(filePath).suffix().isEmpty()) {
+            filePath += ".pdf";
+        }
+        if (exporter->exportPdf(filePath, &error)) {
+            QMessageBox::information(this, tr("Export Successful"), tr("Leaderboard saved to:\n%1").arg(QDir::toNativeSeparators(filePath)));
+        } else {
+            QMessageBox::critical(this, tr("Export Failed"), tr("Could not save the leaderboard:\n%1").arg(error));
+        }
         return;
     }
 
-    QString filePath = QFileDialog::getSaveFileName(this, tr("Save Leaderboard Image"), QDir::homePath(), tr("PNG Files (*.png);;JPEG Files (*.jpg *.jpeg);;BMP Files (*.bmp)"));
+    QStringList writtenFiles;
+    if (!exporter->exportImages(filePath, &writtenFiles, &error)) {
+        QMessageBox::critical(this, tr("Export Failed"), tr("Could not save the leaderboard image:\n%1").arg(error));
+    } else if (writtenFiles.size() == 1) {
+        QMessageBox::information(this, tr("Export Successful"), tr("Leaderboard image saved to:\n%1").arg(QDir::toNativeSeparators(filePath)));
+    } else {
+        QMessageBox::information(this, tr("Export Successful"),
+                                 tr("Leaderboard saved as %1 images, from:\n%2\nto:\n%3").arg(writtenFiles.size())
+                                     .arg(QDir::toNativeSeparators(writtenFiles.first()), QDir::toNativeSeparators(writtenFiles.last())));
+    }
+}
+
+/**
+ * @brief Writes the current tournament data and cut line to an archive file.
+ */
+void TournamentLeaderboardDialog::saveArchive()
+{
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Save Tournament Archive"), QDir::homePath(), tr("Tournament Archives (*.mosnap)"));
     if (filePath.isEmpty()) {
         return;
     }
 
-    if (exportedImage.save(filePath)) {
-        QMessageBox::information(this, tr("Export Successful"), tr("Leaderboard image saved to:\n%1").arg(QDir::toNativeSeparators(filePath)));
+    TournamentSnapshot snapshot = TournamentSnapshot::load(m_connectionName);
+    QString error;
+    if (snapshot.saveArchive(filePath, { m_cutLineScore, m_isCutApplied }, &error)) {
+        QMessageBox::information(this, tr("Archive Saved"), tr("Tournament archive saved to:\n%1").arg(QDir::toNativeSeparators(filePath)));
     } else {
-        QMessageBox::critical(this, tr("Export Failed"), tr("Could not save image to:\n%1").arg(QDir::toNativeSeparators(filePath)));
+        QMessageBox::critical(this, tr("Archive Failed"), tr("Could not save the archive:\n%1").arg(error));
     }
 }
@@ -14,11 +14,26 @@
 #include <QTabWidget>
 #include <QLabel>
 #include <QSpinBox>
+#include <QFutureWatcher>
+#include <array>
 
 #include "tournamentleaderboardwidget.h"
 #include "dailyleaderboardwidget.h"
 #include "TeamLeaderboardWidget.h"
 
+/**
+ * @struct LeaderboardResults
+ * @brief Every leaderboard calculated from one snapshot, ready to be shown.
+ */
+struct LeaderboardResults {
+    TournamentSnapshot snapshot;                         ///< The data all leaderboards were calculated from.
+    TournamentLeaderboardModel::Result mosleyOpen;       ///< The Mosley Open leaderboard.
+    TournamentLeaderboardModel::Result twistedCreek;     ///< The Twisted Creek leaderboard.
+    std::array<QVector<DailyLeaderboardRow>, TournamentSnapshot::MaxDays> days; ///< The daily leaderboards.
+    QVector<TeamLeaderboardRow> teams;                   ///< The team leaderboard.
+    ChangeTracker::Tables changedTables = ChangeTracker::AllTables; ///< Only leaderboards depending on these are calculated.
+};
+
 /**
  * @class TournamentLeaderboardDialog
  * @brief A dialog for displaying various tournament leaderboards.
@@ -39,6 +54,18 @@ public:
      */
     explicit TournamentLeaderboardDialog(const QString &connectionName, QWidget *parent = nullptr);
 
+    /**
+     * @brief Constructs a read-only dialog showing an archived tournament.
+     *
+     * The leaderboards are calculated from the archived snapshot; no database
+     * is opened and refreshing, the cut controls and archiving are disabled.
+     *
+     * @param archive A snapshot opened with TournamentSnapshot::openArchive().
+     * @param cut The cut line stored in the archive.
+     * @param parent The parent widget.
+     */
+    TournamentLeaderboardDialog(const TournamentSnapshot &archive, const TournamentSnapshot::CutSettings &cut, QWidget *parent = nullptr);
+
     /**
      * @brief Destroys the TournamentLeaderboardDialog object.
      */
@@ -47,11 +74,34 @@ public:
 public slots:
     /**
      * @brief Refreshes all leaderboards.
+     *
+     * The data is read and the leaderboards are calculated on a worker thread with
+     * its own database connection; the current leaderboards stay visible until the
+     * results arrive. Starting a new refresh cancels one that is still running.
+     *
+     * Only leaderboards whose tables changed since they were last calculated are
+     * recalculated; if none did, the refresh returns at once.
      */
     void refreshLeaderboards();
 
+    /**
+     * @brief Updates the leaderboards for a single saved score.
+     *
+     * The overall and daily leaderboards update only the affected player's row;
+     * the team leaderboard is recalculated from the updated snapshot.
+     *
+     * @param playerId The player whose score was saved.
+     * @param courseId The course the score was entered on.
+     * @param dayNum The day number.
+     * @param holeNum The hole number.
+     * @param score The saved gross score.
+     */
+    void applyScoreChange(int playerId, int courseId, int dayNum, int holeNum, int score);
+
 private slots:
+    void onRefreshFinished();
     void exportCurrentImage();
+    void saveArchive();
     void applyCutClicked();
     void clearCutClicked();
     void cutLineScoreChanged(int value);
@@ -80,15 +130,33 @@ private:
     QPushButton *refreshButton; 
     QPushButton *closeButton;   
     QPushButton *exportImageButton; 
+    QPushButton *saveArchiveButton = nullptr;
+
+    QLabel *computingLabel = nullptr; ///< Shown while a refresh is running.
+    QFutureWatcher<LeaderboardResults> *m_refreshWatcher = nullptr; ///< Watches the running refresh.
+    QFutureWatcher<QString> *m_verifyWatcher = nullptr; ///< Checks an archive's hole scores in the background.
+
+    TournamentSnapshot m_snapshot; ///< The data currently shown on the leaderboards.
+
+    ChangeTracker m_changeTracker;          ///< Detects database changes between refreshes.
+    ChangeTracker::Stamp m_shownStamp;      ///< The database state the shown leaderboards were read from.
+    ChangeTracker::Stamp m_refreshStamp;    ///< The database state when the running refresh started.
 
     // State for cut
     int m_cutLineScore;
     bool m_isCutApplied;
 
+    bool m_isArchive = false; ///< Shows an archived snapshot instead of the database.
+
+    TournamentLeaderboardDialog(const QString &connectionName, const TournamentSnapshot *archive,
+                                const TournamentSnapshot::CutSettings &cut, QWidget *parent);
+
     QSqlDatabase database() const;
     void setupCutLineUI(QVBoxLayout* mainLayout);
     void loadCutSettings();
     void saveCutSettings();
+    void configureLeaderboardModels();
+    void showResults(const LeaderboardResults &results);
 };
 
 #endif // TOURNAMENTLEADERBOARDDIALOG_H
@@ -6,14 +6,26 @@
 #include "utils.h"
 #include "TournamentLeaderboardModel.h"
 
-#include <QSqlQuery>
-#include <QSqlError>
-#include <QSqlRecord>
-#include <QSqlField>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <ranges>
 
+namespace {
+QVariant rankDisplay(int rank)
+{
+    return rank > 0 ? QVariant(rank) : QVariant(QStringLiteral("-"));
+}
+
+const std::array<QVariant, TournamentLeaderboardModel::ColumnCount> column_headers = {
+    QStringLiteral("Rank"), QStringLiteral("Player"), QStringLiteral("Point Target"),
+    QStringLiteral("Day 1 Gross"), QStringLiteral("Day 1 Net"), QStringLiteral("Day 2 Gross"), QStringLiteral("Day 2 Net"),
+    QStringLiteral("Day 3 Gross"), QStringLiteral("Day 3 Net"), QStringLiteral("Overall Net"),
+};
+
+const QVariant center_alignment = QVariant(Qt::AlignCenter);
+}
+
 TournamentLeaderboardModel::TournamentLeaderboardModel(const QString &connectionName, QObject *parent)
     : QAbstractTableModel(parent), m_connectionName(connectionName),
       m_tournamentContext(TwistedCreek),
@@ -23,20 +35,6 @@ TournamentLeaderboardModel::TournamentLeaderboardModel(const QString &connection
 
 TournamentLeaderboardModel::~TournamentLeaderboardModel() {}
 
-QSqlDatabase TournamentLeaderboardModel::database() const
-{
-    QSqlDatabase db_check = QSqlDatabase::database(m_connectionName, false);
-    if (!db_check.isValid()) {
-        qWarning() << "TournamentLeaderboardModel instance" << this
-                   << "DB connection name '" << m_connectionName << "' is NOT VALID (not found in Qt's list). "
-                   << "Available connections:" << QSqlDatabase::connectionNames();
-    } else if (!db_check.isOpen()) {
-        qWarning() << "TournamentLeaderboardModel instance" << this
-                   << "DB connection '" << m_connectionName << "' is VALID but NOT OPEN. Last error:" << db_check.lastError().text();
-    }
-    return db_check;
-}
-
 void TournamentLeaderboardModel::setTournamentContext(TournamentContext context)
 {
     m_tournamentContext = context;
@@ -55,13 +53,13 @@ void TournamentLeaderboardModel::setIsCutApplied(bool applied)
 int TournamentLeaderboardModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return m_leaderboardData.size();
+    return m_displayRows.size();
 }
 
 int TournamentLeaderboardModel::columnCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return 10;
+    return ColumnCount;
 }
 
 QVariant TournamentLeaderboardModel::data(const QModelIndex &index, int role) const
@@ -71,72 +69,160 @@ QVariant TournamentLeaderboardModel::data(const QModelIndex &index, int role) co
         return QVariant();
     }
 
-    const LeaderboardRow &rowData = m_leaderboardData.at(index.row());
-
     if (role == Qt::DisplayRole) {
-        switch (index.column()) {
-        case 0: return rowData.rank > 0 ? QVariant(rowData.rank) : QVariant("-");
-        case 1: return rowData.playerName;
-        case 2: return rowData.playerActualDbHandicap;
-        case 3: return rowData.dailyGrossStablefordPoints.contains(1) ? QVariant(rowData.dailyGrossStablefordPoints.value(1)) : QVariant();
-        case 4: return rowData.dailyNetStablefordPoints.contains(1) ? QVariant(rowData.dailyNetStablefordPoints.value(1)) : QVariant();
-        case 5: return rowData.dailyGrossStablefordPoints.contains(2) ? QVariant(rowData.dailyGrossStablefordPoints.value(2)) : QVariant();
-        case 6: return rowData.dailyNetStablefordPoints.contains(2) ? QVariant(rowData.dailyNetStablefordPoints.value(2)) : QVariant();
-        case 7: return rowData.dailyGrossStablefordPoints.contains(3) ? QVariant(rowData.dailyGrossStablefordPoints.value(3)) : QVariant();
-        case 8: return rowData.dailyNetStablefordPoints.contains(3) ? QVariant(rowData.dailyNetStablefordPoints.value(3)) : QVariant();
-        case 9: return rowData.totalNetStablefordPoints;
-        default: return QVariant();
-        }
+        return m_displayRows.at(index.row())[index.column()];
     } else if (role == Qt::TextAlignmentRole) {
-        return QVariant(Qt::AlignCenter);
+        return center_alignment;
     }
     return QVariant();
 }
 
 QVariant TournamentLeaderboardModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
-    const std::unordered_map<int, QString> columnNames = {
-        {0, "Rank"}, {1, "Player"}, {2, "Point Target"}, {3, "Day 1 Gross"}, {4, "Day 1 Net"},
-        {5, "Day 2 Gross"}, {6, "Day 2 Net"}, {7, "Day 3 Gross"}, {8, "Day 3 Net"}, {9, "Overall Net"},
-    };
-
-    if (role == Qt::DisplayRole && orientation == Qt::Horizontal && columnNames.contains(section)) {
-        return columnNames.at(section);
-    } else if (role == Qt::TextAlignmentRole && orientation == Qt::Horizontal) {
-        return QVariant(Qt::AlignCenter);
+    if (orientation != Qt::Horizontal || section < 0 || section >= ColumnCount) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole) {
+        return column_headers[section];
+    } else if (role == Qt::TextAlignmentRole) {
+        return center_alignment;
     }
-    
     return QVariant();
 }
 
+bool TournamentLeaderboardModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_displayRows.size() < m_leaderboardData.size();
+}
+
+/**
+ * @brief Gets the integer a LeaderboardProxyModel sorts a column by, read from the row itself.
+ */
+int TournamentLeaderboardModel::sortKey(int row, int column) const
+{
+    const LeaderboardRow &rowData = m_leaderboardData.at(row);
+    switch (column) {
+    case 0: return row;
+    case 2: return rowData.playerActualDbHandicap;
+    case 3: case 5: case 7: return rowData.dailyGrossStablefordPoints.value((column - 1) / 2, std::numeric_limits<int>::min());
+    case 4: case 6: case 8: return rowData.dailyNetStablefordPoints.value((column - 2) / 2, std::numeric_limits<int>::min());
+    case 9: return rowData.totalNetStablefordPoints;
+    default: return 0;
+    }
+}
+
+/**
+ * @brief Hands the next FetchBatchSize ranked rows to the views.
+ */
+void TournamentLeaderboardModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    const int first = m_displayRows.size();
+    const int last = std::min(first + FetchBatchSize, static_cast<int>(m_leaderboardData.size())) - 1;
+    beginInsertRows(QModelIndex(), first, last);
+    for (int i = first; i <= last; ++i) {
+        m_displayRows.append(displayRow(m_leaderboardData.at(i)));
+    }
+    endInsertRows();
+}
+
+/**
+ * @brief Builds the displayed cells of a leaderboard row.
+ *
+ * Days the player has no round for are left empty.
+ */
+TournamentLeaderboardModel::DisplayRow TournamentLeaderboardModel::displayRow(const LeaderboardRow &row)
+{
+    DisplayRow display;
+    display[0] = rankDisplay(row.rank);
+    display[1] = row.playerName;
+    display[2] = row.playerActualDbHandicap;
+    for (auto it = row.dailyGrossStablefordPoints.cbegin(); it != row.dailyGrossStablefordPoints.cend(); ++it) {
+        if (it.key() >= 1 && it.key() <= TournamentSnapshot::MaxDays) {
+            display[2 * it.key() + 1] = it.value();
+            display[2 * it.key() + 2] = row.dailyNetStablefordPoints.value(it.key());
+        }
+    }
+    display[9] = row.totalNetStablefordPoints;
+    return display;
+}
+
 void TournamentLeaderboardModel::refreshData()
 {
-    beginResetModel();
+    refreshData(TournamentSnapshot::load(m_connectionName, TournamentSnapshot::Detail::RoundTotals));
+}
 
-    m_allPlayers.clear();
-    m_holeParAndHandicapIndex.clear();
-    m_allScores.clear();
-    m_leaderboardData.clear();
-    m_daysWithScores.clear();
-    m_playerTwoDayMosleyNetScoreForCut.clear();
+/**
+ * @brief Recalculates the leaderboard from an already loaded snapshot.
+ * @param snapshot The tournament data shared with the other leaderboard models.
+ */
+void TournamentLeaderboardModel::refreshData(const TournamentSnapshot &snapshot)
+{
+    setResult(calculate(snapshot, m_tournamentContext, m_cutLineScore, m_isCutApplied));
+}
 
-    fetchAllPlayers();
-    if (m_allPlayers.isEmpty()) {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- fetchAllPlayers resulted in empty m_allPlayers. Further calculations might be skipped or incorrect.";
+/**
+ * @brief Calculates a complete leaderboard without touching any model.
+ *
+ * This is a pure function of its arguments, so it can run on a worker thread.
+ *
+ * @param snapshot The tournament data to calculate from.
+ * @param context The tournament context to calculate for.
+ * @param cutLineScore The two-day Mosley net score needed to make the cut.
+ * @param isCutApplied Whether the cut splits the field.
+ * @return The ranked leaderboard rows.
+ */
+TournamentLeaderboardModel::Result TournamentLeaderboardModel::calculate(const TournamentSnapshot &snapshot, TournamentContext context,
+                                                                          int cutLineScore, bool isCutApplied)
+{
+    Result result;
+    result.snapshot = snapshot;
+
+    const QVector<PlayerInfo> &allPlayers = snapshot.players();
+    if (allPlayers.isEmpty()) {
+        qDebug() << "TournamentLeaderboardModel::calculate - snapshot has no active players. Leaderboard will be empty.";
+        return result;
     }
 
-    fetchAllHoleDetails();
-    fetchAllScores();
+    result.twoDayMosleyNetScores.resize(allPlayers.size());
+    for (int playerRow = 0; playerRow < allPlayers.size(); ++playerRow) {
+        int twoDayScore = calculateTwoDayMosleyNetScore(snapshot, playerRow);
+        result.twoDayMosleyNetScores[playerRow] = twoDayScore;
+        if (isPlayerIncluded(twoDayScore, context, cutLineScore, isCutApplied)) {
+            result.rows.append(buildLeaderboardRow(snapshot, playerRow, twoDayScore, context));
+        }
+    }
 
-    calculateAllPlayerTwoDayMosleyNetScores();
-    calculateLeaderboard();
+    std::ranges::sort(result.rows, &TournamentLeaderboardModel::ranksAbove);
 
-    endResetModel();
-    if (m_leaderboardData.isEmpty() && !m_allPlayers.isEmpty()) {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- WARNING: m_leaderboardData is empty but m_allPlayers is not. Check filtering logic in calculateLeaderboard.";
-    } else if (m_allPlayers.isEmpty() && (m_tournamentContext == MosleyOpen || m_tournamentContext == TwistedCreek)) {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- WARNING: m_allPlayers is empty. No players fetched. Leaderboard will be empty.";
+    for (int i = 0; i < result.rows.size(); ++i) {
+        if (i > 0 && result.rows[i].totalNetStablefordPoints == result.rows[i - 1].totalNetStablefordPoints) {
+            result.rows[i].rank = result.rows[i - 1].rank;
+        } else {
+            result.rows[i].rank = i + 1;
+        }
     }
+    return result;
+}
+
+/**
+ * @brief Swaps a calculated leaderboard into the model.
+ * @param result The leaderboard returned by calculate().
+ */
+void TournamentLeaderboardModel::setResult(const Result &result)
+{
+    beginResetModel();
+    m_snapshot = result.snapshot;
+    m_daysWithScores = m_snapshot.daysWithScores();
+    m_playerTwoDayMosleyNetScoreForCut = result.twoDayMosleyNetScores;
+    m_leaderboardData = result.rows;
+    m_displayRows.clear();
+    for (const LeaderboardRow &row : std::as_const(m_leaderboardData) | std::views::take(FetchBatchSize)) {
+        m_displayRows.append(displayRow(row));
+    }
+    endResetModel();
 }
 
 QSet<int> TournamentLeaderboardModel::getDaysWithScores() const
@@ -144,213 +230,272 @@ QSet<int> TournamentLeaderboardModel::getDaysWithScores() const
     return m_daysWithScores;
 }
 
+int TournamentLeaderboardModel::calculateNetStablefordPointsForHole(
+    int grossScore, int par) const
+{
+    if (grossScore <= 0 || par <= 0) {
+        return 0;
+    }
+
+    return stablefordPoints(grossScore - par);
+}
+
 /**
- * @brief Fetches all active players from the database.
+ * @brief Calculates a player's two-day Mosley net score, used for the cut.
+ * @param snapshot The tournament data.
+ * @param playerRow The player's snapshot row.
+ * @return The net Stableford total over days 1 and 2.
  */
-void TournamentLeaderboardModel::fetchAllPlayers()
+int TournamentLeaderboardModel::calculateTwoDayMosleyNetScore(const TournamentSnapshot &snapshot, int playerRow)
 {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- fetchAllPlayers: DB connection from database() is not valid or not open. Aborting fetch.";
-        return;
+    const PlayerInfo &playerInfo = snapshot.players().at(playerRow);
+    int twoDayTotalNetForPlayer = 0;
+    for (int dayNum = 1; dayNum <= 2; ++dayNum) {
+        if (!snapshot.hasRound(playerRow, dayNum)) {
+            continue;
+        }
+
+        twoDayTotalNetForPlayer += snapshot.roundGrossPoints(playerRow, dayNum);
+        twoDayTotalNetForPlayer -= std::max(16, playerInfo.handicap);
     }
-    QSqlQuery query(db);
-    if (query.exec("SELECT id, name, handicap FROM players WHERE active = 1")) {
-        while (query.next()) {
-            PlayerInfo player;
-            player.id = query.value("id").toInt();
-            player.name = query.value("name").toString();
-            player.handicap = query.value("handicap").toInt();
-            m_allPlayers[player.id] = player;
+    return twoDayTotalNetForPlayer;
+}
+
+/**
+ * @brief Checks whether a player belongs on a leaderboard given the context and cut line.
+ * @param twoDayMosleyScore The player's two-day Mosley net score.
+ * @param context The tournament context.
+ * @param cutLineScore The score needed to make the cut.
+ * @param isCutApplied Whether the cut splits the field.
+ */
+bool TournamentLeaderboardModel::isPlayerIncluded(int twoDayMosleyScore, TournamentContext context, int cutLineScore, bool isCutApplied)
+{
+    bool madeTheCut = isCutApplied && twoDayMosleyScore >= cutLineScore;
+    return !isCutApplied ||
+           (madeTheCut && context == MosleyOpen) ||
+           (!madeTheCut && context == TwistedCreek);
+}
+
+/**
+ * @brief Builds the unranked leaderboard row of a player.
+ * @param snapshot The tournament data.
+ * @param playerRow The player's snapshot row.
+ * @param twoDayMosleyScore The player's two-day Mosley net score.
+ * @param context The tournament context.
+ */
+LeaderboardRow TournamentLeaderboardModel::buildLeaderboardRow(const TournamentSnapshot &snapshot, int playerRow, int twoDayMosleyScore, TournamentContext context)
+{
+    const PlayerInfo &playerInfo = snapshot.players().at(playerRow);
+
+    LeaderboardRow row;
+    row.playerId = playerInfo.id;
+    row.playerName = playerInfo.name;
+    row.playerActualDbHandicap = playerInfo.handicap;
+    row.totalNetStablefordPoints = 0;
+    row.rank = 0;
+    row.twoDayMosleyNetScoreForCut = twoDayMosleyScore;
+
+    for (int dayNum = 1; dayNum <= TournamentSnapshot::MaxDays; ++dayNum) {
+        if (!snapshot.hasRound(playerRow, dayNum)) {
+            continue;
         }
-    } else {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- fetchAllPlayers: SQL ERROR:" << query.lastError().text();
+
+        int dailyGrossPts = snapshot.roundGrossPoints(playerRow, dayNum);
+        row.dailyGrossStablefordPoints[dayNum] = dailyGrossPts;
+        if (context == MosleyOpen) {
+            row.dailyNetStablefordPoints[dayNum] = dailyGrossPts - std::max(16, playerInfo.handicap);
+        } else {
+            row.dailyNetStablefordPoints[dayNum] = dailyGrossPts - playerInfo.handicap;
+        }
+        row.totalNetStablefordPoints += row.dailyNetStablefordPoints[dayNum];
     }
+    return row;
 }
 
 /**
- * @brief Fetches details for all holes from the database.
+ * @brief The leaderboard ordering: highest total first, ties broken by name then id.
+ *
+ * No two rows compare equal, so a single changed row can be placed with a binary search.
  */
-void TournamentLeaderboardModel::fetchAllHoleDetails()
+bool TournamentLeaderboardModel::ranksAbove(const LeaderboardRow &a, const LeaderboardRow &b)
 {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- fetchAllHoleDetails: DB not open. Skipping.";
-        return;
+    if (a.totalNetStablefordPoints != b.totalNetStablefordPoints) {
+        return a.totalNetStablefordPoints > b.totalNetStablefordPoints;
     }
-    QSqlQuery query(db);
-    if (query.exec("SELECT course_id, hole_num, par, handicap FROM holes")) {
-        while (query.next()) {
-            m_holeParAndHandicapIndex[qMakePair(query.value("course_id").toInt(), query.value("hole_num").toInt())] =
-                qMakePair(query.value("par").toInt(), query.value("handicap").toInt());
-        }
-    } else {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- fetchAllHoleDetails: SQL ERROR:" << query.lastError().text();
+    if (a.playerName != b.playerName) {
+        return a.playerName < b.playerName;
     }
+    return a.playerId < b.playerId;
 }
 
 /**
- * @brief Fetches all scores from the database.
+ * @brief Updates one player's row after a single score change.
+ *
+ * Only the changed player's totals are recalculated. The row is moved to its new
+ * position with beginMoveRows()/endMoveRows() (or inserted/removed when the cut
+ * moves the player on or off this leaderboard), and only the ranks that actually
+ * change are reported, so views keep their scroll position and selection.
+ *
+ * @param snapshot The snapshot with the change applied.
+ * @param playerId The player whose score changed.
  */
-void TournamentLeaderboardModel::fetchAllScores()
+void TournamentLeaderboardModel::applyScoreChange(const TournamentSnapshot &snapshot, int playerId)
 {
-    QSqlDatabase db = database();
-    if (!db.isValid() || !db.isOpen()) {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- fetchAllScores: DB not open. Skipping.";
+    if (snapshot.players().size() != m_playerTwoDayMosleyNetScoreForCut.size()) {
+        refreshData(snapshot);
         return;
     }
-    QSqlQuery query(db);
-    if (query.exec("SELECT player_id, course_id, hole_num, day_num, score FROM scores")) {
-        while (query.next()) {
-            int playerId = query.value("player_id").toInt();
-            int dayNum = query.value("day_num").toInt();
-            int holeNum = query.value("hole_num").toInt();
-            int scoreVal = query.value("score").toInt();
-            int courseId = query.value("course_id").toInt();
-            m_allScores[playerId][dayNum][holeNum] = qMakePair(scoreVal, courseId);
-            m_daysWithScores.insert(dayNum);
+
+    const int oldPos = findLeaderboardRow(playerId);
+
+    m_snapshot = snapshot;
+    m_daysWithScores = m_snapshot.daysWithScores();
+
+    int playerRow = m_snapshot.rowForPlayer(playerId);
+    if (playerRow < 0) {
+        return;
+    }
+    int twoDayScore = calculateTwoDayMosleyNetScore(m_snapshot, playerRow);
+    m_playerTwoDayMosleyNetScoreForCut[playerRow] = twoDayScore;
+
+    if (!isPlayerIncluded(twoDayScore, m_tournamentContext, m_cutLineScore, m_isCutApplied)) {
+        if (oldPos >= 0) {
+            removeLeaderboardRow(oldPos);
+            updateRanks(oldPos, m_leaderboardData.size() - 1);
         }
+        return;
+    }
+
+    LeaderboardRow row = buildLeaderboardRow(m_snapshot, playerRow, twoDayScore, m_tournamentContext);
+    // The vector is still sorted, so it is partitioned with respect to the new row
+    // even while it holds the player's old row.
+    int insertPos = static_cast<int>(std::ranges::lower_bound(m_leaderboardData, row, &TournamentLeaderboardModel::ranksAbove) - m_leaderboardData.begin());
+
+    if (oldPos < 0) {
+        insertLeaderboardRow(insertPos, row);
+        updateRanks(insertPos, m_leaderboardData.size() - 1);
+        return;
+    }
+
+    row.rank = m_leaderboardData.at(oldPos).rank;
+    int newPos = insertPos > oldPos ? insertPos - 1 : insertPos;
+    const int fetchedRows = m_displayRows.size();
+    if (newPos != oldPos && (oldPos >= fetchedRows || newPos >= fetchedRows)) {
+        // The row enters or leaves the fetched rows, or moves among unfetched ones.
+        removeLeaderboardRow(oldPos);
+        insertLeaderboardRow(newPos, row);
     } else {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- fetchAllScores: SQL ERROR:" << query.lastError().text();
+        if (newPos != oldPos) {
+            beginMoveRows(QModelIndex(), oldPos, oldPos, QModelIndex(), insertPos);
+            m_leaderboardData.move(oldPos, newPos);
+            m_displayRows.move(oldPos, newPos);
+            endMoveRows();
+        }
+        m_leaderboardData[newPos] = row;
+        if (newPos < fetchedRows) {
+            m_displayRows[newPos] = displayRow(row);
+            emit dataChanged(index(newPos, 0), index(newPos, columnCount() - 1));
+        }
     }
+    updateRanks(std::min(oldPos, newPos), std::max(oldPos, newPos));
 }
 
-int TournamentLeaderboardModel::calculateNetStablefordPointsForHole(
-    int grossScore, int par) const
+/**
+ * @brief Finds a player's current row with a binary search.
+ *
+ * The rows were ranked from m_snapshot, so rebuilding the player's row from
+ * it gives the key the row is sorted by, and the row is found in O(log n).
+ *
+ * @param playerId The player to find.
+ * @return The player's position, or -1 if the player is not on this leaderboard.
+ */
+int TournamentLeaderboardModel::findLeaderboardRow(int playerId) const
 {
-    if (grossScore <= 0 || par <= 0) {
-        return 0;
+    const int playerRow = m_snapshot.rowForPlayer(playerId);
+    if (playerRow < 0 || playerRow >= m_playerTwoDayMosleyNetScoreForCut.size()) {
+        return -1;
     }
-        
-    int diff = grossScore - par;
-
-    return stableford_conversion.at(diff);
+    const LeaderboardRow key = buildLeaderboardRow(m_snapshot, playerRow, m_playerTwoDayMosleyNetScoreForCut.at(playerRow), m_tournamentContext);
+    auto it = std::ranges::lower_bound(m_leaderboardData, key, &TournamentLeaderboardModel::ranksAbove);
+    return it != m_leaderboardData.end() && it->playerId == playerId ? static_cast<int>(it - m_leaderboardData.begin()) : -1;
 }
 
 /**
- * @brief Calculates the two-day Mosley net scores for all players, used for the cut.
+ * @brief Inserts a ranked row, showing it only if it falls among the fetched rows.
+ * @param pos The position in the full ranking.
+ * @param row The row to insert.
  */
-void TournamentLeaderboardModel::calculateAllPlayerTwoDayMosleyNetScores()
+void TournamentLeaderboardModel::insertLeaderboardRow(int pos, const LeaderboardRow &row)
 {
-    m_playerTwoDayMosleyNetScoreForCut.clear();
-    if (m_allPlayers.isEmpty()) {
-        qDebug() << "TournamentLeaderboardModel instance" << this << "- calculateAllPlayerTwoDayMosleyNetScores: m_allPlayers is empty. Skipping.";
-        return;
+    if (pos < m_displayRows.size() || !canFetchMore(QModelIndex())) {
+        beginInsertRows(QModelIndex(), pos, pos);
+        m_leaderboardData.insert(pos, row);
+        m_displayRows.insert(pos, displayRow(row));
+        endInsertRows();
+    } else {
+        m_leaderboardData.insert(pos, row);
     }
+}
 
-    for (auto const &[playerId, playerInfo] : m_allPlayers.asKeyValueRange()) {
-        int twoDayTotalNetForPlayer = 0;
-        for (int dayNum = 1; dayNum <= 2; ++dayNum) {
-            if (!m_allScores.contains(playerId) || !m_allScores[playerId].contains(dayNum)) {
-                continue;
-            }
-
-            for (auto const &[holeNum, scoreAndCourse] : m_allScores[playerId][dayNum].asKeyValueRange()) {
-                int grossScore = scoreAndCourse.first;
-                int courseIdForScore = scoreAndCourse.second;
-                QPair<int, int> holeDetailsKey = qMakePair(courseIdForScore, holeNum);
-                if (!m_holeParAndHandicapIndex.contains(holeDetailsKey)) {
-                    continue;
-                }
-                
-                int par = m_holeParAndHandicapIndex[holeDetailsKey].first;
-                if (stableford_conversion.contains(grossScore - par)) {
-                    twoDayTotalNetForPlayer += stableford_conversion.at(grossScore - par);
-                } else {
-                    qDebug() << "Invalid score " << grossScore << "on par " << par << "for " << playerInfo.name;
-                }
-            }
-            twoDayTotalNetForPlayer -= std::max(16, playerInfo.handicap);
-        }
-        m_playerTwoDayMosleyNetScoreForCut[playerId] = twoDayTotalNetForPlayer;
+/**
+ * @brief Removes a ranked row, and from the views if it was fetched.
+ * @param pos The position in the full ranking.
+ */
+void TournamentLeaderboardModel::removeLeaderboardRow(int pos)
+{
+    if (pos < m_displayRows.size()) {
+        beginRemoveRows(QModelIndex(), pos, pos);
+        m_leaderboardData.removeAt(pos);
+        m_displayRows.removeAt(pos);
+        endRemoveRows();
+    } else {
+        m_leaderboardData.removeAt(pos);
     }
 }
 
 /**
- * @brief Calculates the leaderboard based on the current context and cut line.
+ * @brief Recalculates ranks after rows between two positions changed.
+ *
+ * Ranks are recalculated from @p first and stop at the first unchanged rank
+ * past @p last. That is only safe when no row after @p last changed position,
+ * as after a move; an insert or remove shifts every later row, so it must pass
+ * the last row.
+ *
+ * @param first The first position whose row changed or moved.
+ * @param last The last position whose row changed or moved.
  */
-void TournamentLeaderboardModel::calculateLeaderboard()
+void TournamentLeaderboardModel::updateRanks(int first, int last)
 {
-    m_leaderboardData.clear();
-
-    for (auto const &[playerId, playerInfo] : m_allPlayers.asKeyValueRange()) {
-        int playerTwoDayMosleyScore = m_playerTwoDayMosleyNetScoreForCut.value(playerId, 0);
-
-        bool madeTheCut = m_isCutApplied && playerTwoDayMosleyScore >= m_cutLineScore;
-        bool includePlayer = !m_isCutApplied ||
-                             (madeTheCut && m_tournamentContext == MosleyOpen) ||
-                             (!madeTheCut && m_tournamentContext == TwistedCreek);
-
-        if (!includePlayer) continue;
-
-        LeaderboardRow row;
-        row.playerId = playerId;
-        row.playerName = playerInfo.name;
-        row.playerActualDbHandicap = playerInfo.handicap;
-        row.totalNetStablefordPoints = 0;
-        row.twoDayMosleyNetScoreForCut = playerTwoDayMosleyScore;
-
-        for (int dayNum = 1; dayNum <= 3; ++dayNum) {
-            int dailyGrossPts = 0;
-
-            if (!m_allScores.contains(playerId) || !m_allScores[playerId].contains(dayNum)) {
-                continue;
-            }
-
-            int total_score = 0;
-            for (auto const &[holeNum, scoreAndCourse] : m_allScores[playerId][dayNum].asKeyValueRange()) {
-                int grossScore = scoreAndCourse.first;
-                total_score += grossScore;
-                int courseIdForScore = scoreAndCourse.second;
-                QPair<int, int> holeDetailsKey = qMakePair(courseIdForScore, holeNum);
-                if (m_holeParAndHandicapIndex.contains(holeDetailsKey)) {
-                    int par = m_holeParAndHandicapIndex[holeDetailsKey].first;
-                    if (stableford_conversion.contains(grossScore - par)) {
-                        dailyGrossPts += stableford_conversion.at(grossScore - par);
-                    } else {
-                        qDebug() << "Invalid score " << grossScore << "on par " << par << "for " << playerInfo.name;
-                    }
-                }
-            }
-
-            qDebug() << playerInfo.name << " shot " << total_score << " on day " << dayNum;
-
-            row.dailyGrossStablefordPoints[dayNum] = dailyGrossPts;
-            if (m_tournamentContext == MosleyOpen) {
-                row.dailyNetStablefordPoints[dayNum] = dailyGrossPts - std::max(16, playerInfo.handicap);
-            } else {
-                row.dailyNetStablefordPoints[dayNum] = dailyGrossPts - playerInfo.handicap;
-            }
-            row.totalNetStablefordPoints += row.dailyNetStablefordPoints[dayNum];
+    int firstChanged = -1;
+    int lastChanged = -1;
+    for (int i = std::max(first, 0); i < m_leaderboardData.size(); ++i) {
+        int rank = i + 1;
+        if (i > 0 && m_leaderboardData.at(i).totalNetStablefordPoints == m_leaderboardData.at(i - 1).totalNetStablefordPoints) {
+            rank = m_leaderboardData.at(i - 1).rank;
+        }
+        if (rank == m_leaderboardData.at(i).rank) {
+            if (i > last) break;
+            continue;
+        }
+        m_leaderboardData[i].rank = rank;
+        if (i < m_displayRows.size()) {
+            m_displayRows[i][0] = rankDisplay(rank);
+            if (firstChanged < 0) firstChanged = i;
+            lastChanged = i;
         }
-        m_leaderboardData.append(row);
     }
 
-    std::ranges::sort(m_leaderboardData,
-                      [](const auto &a, const auto &b) {
-                          return a.totalNetStablefordPoints > b.totalNetStablefordPoints;
-                      });
-
-    if (m_leaderboardData.isEmpty()) return;
-    
-    m_leaderboardData[0].rank = 1;
-    for (int i = 1; i < m_leaderboardData.size(); ++i) {
-        if (m_leaderboardData[i].totalNetStablefordPoints == m_leaderboardData[i - 1].totalNetStablefordPoints) {
-            m_leaderboardData[i].rank = m_leaderboardData[i - 1].rank;
-        } else {
-            m_leaderboardData[i].rank = i + 1;
-        }
+    if (firstChanged >= 0) {
+        emit dataChanged(index(firstChanged, 0), index(lastChanged, 0), {Qt::DisplayRole});
     }
 }
 
 int TournamentLeaderboardModel::getColumnForDailyGrossPoints(int dayNum) const
 {
-    const std::unordered_map<int, int> columnMap = {{1, 3}, {2, 5}, {3, 7}};
-    return columnMap.contains(dayNum) ? columnMap.at(dayNum) : -1;
+    return dayNum >= 1 && dayNum <= TournamentSnapshot::MaxDays ? 2 * dayNum + 1 : -1;
 }
 
 int TournamentLeaderboardModel::getColumnForDailyNetPoints(int dayNum) const
 {
-    const std::unordered_map<int, int> columnMap = {{1, 4}, {2, 6}, {3, 8}};
-    return columnMap.contains(dayNum) ? columnMap.at(dayNum) : -1;
+    return dayNum >= 1 && dayNum <= TournamentSnapshot::MaxDays ? 2 * dayNum + 2 : -1;
 }
@@ -15,8 +15,12 @@
 #include <QPair>
 #include <QDebug>
 #include <QSet>
+#include <array>
 
 #include "CommonStructs.h"
+#include "TournamentSnapshot.h"
+#include "ChangeTracker.h"
+#include "LeaderboardProxyModel.h"
 
 /**
  * @struct LeaderboardRow
@@ -39,12 +43,20 @@ struct LeaderboardRow {
  *
  * This model can calculate leaderboards for different tournament contexts,
  * such as the Mosley Open or Twisted Creek, and can apply a cut line.
+ *
+ * The ranked rows are kept in full, but they are handed to views in batches
+ * through canFetchMore() and fetchMore(), so a very large field is laid out
+ * only as far as it is scrolled. The displayed value of every fetched cell is
+ * built when its row is fetched or changes, so data() only indexes into an array.
  */
-class TournamentLeaderboardModel : public QAbstractTableModel
+class TournamentLeaderboardModel : public QAbstractTableModel, public LeaderboardSortKeys
 {
     Q_OBJECT
 
 public:
+    static constexpr int ColumnCount = 10; ///< Rank, player, target, gross and net per day, overall.
+    static constexpr int FetchBatchSize = 256; ///< Rows handed to views per fetchMore().
+
     /**
      * @enum TournamentContext
      * @brief Defines the context for leaderboard calculations.
@@ -54,6 +66,16 @@ public:
         TwistedCreek
     };
 
+    /**
+     * @struct Result
+     * @brief A calculated leaderboard, ready to be swapped into the model.
+     */
+    struct Result {
+        TournamentSnapshot snapshot;          ///< The data the leaderboard was calculated from.
+        QVector<int> twoDayMosleyNetScores;   ///< Two-day Mosley net score per snapshot row.
+        QVector<LeaderboardRow> rows;         ///< The ranked leaderboard rows.
+    };
+
     explicit TournamentLeaderboardModel(const QString &connectionName, QObject *parent = nullptr);
     ~TournamentLeaderboardModel();
 
@@ -61,8 +83,19 @@ public:
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    int sortKey(int row, int column) const override;
+    const QString &rowName(int row) const override { return m_leaderboardData.at(row).playerName; }
+    int nameColumn() const override { return 1; }
 
     void refreshData();
+    void refreshData(const TournamentSnapshot &snapshot);
+    void applyScoreChange(const TournamentSnapshot &snapshot, int playerId);
+    static Result calculate(const TournamentSnapshot &snapshot, TournamentContext context, int cutLineScore, bool isCutApplied);
+    /** @brief The tables whose changes affect this leaderboard; the cut line is stored in settings. */
+    static ChangeTracker::Tables dependencies() { return ChangeTracker::Players | ChangeTracker::Courses | ChangeTracker::Holes | ChangeTracker::Scores | ChangeTracker::Settings | ChangeTracker::Events; }
+    void setResult(const Result &result);
     QSet<int> getDaysWithScores() const;
 
     void setTournamentContext(TournamentContext context);
@@ -74,26 +107,29 @@ public:
     int getColumnForDailyNetPoints(int dayNum) const;
 
 private:
+    using DisplayRow = std::array<QVariant, ColumnCount>; ///< The DisplayRole value of each column.
+
     QString m_connectionName;
-    QVector<LeaderboardRow> m_leaderboardData;
+    QVector<LeaderboardRow> m_leaderboardData; ///< Every ranked row, fetched or not.
+    QVector<DisplayRow> m_displayRows;  ///< The displayed cells of the fetched rows, the first of m_leaderboardData.
     QSet<int> m_daysWithScores;
 
     TournamentContext m_tournamentContext;
     int m_cutLineScore;
     bool m_isCutApplied;
 
-    QMap<int, PlayerInfo> m_allPlayers;
-    QMap<QPair<int, int>, QPair<int, int>> m_holeParAndHandicapIndex;
-    QMap<int, QMap<int, QMap<int, QPair<int, int>>>> m_allScores;
-    QMap<int, int> m_playerTwoDayMosleyNetScoreForCut;
-
-    QSqlDatabase database() const;
-
-    void fetchAllPlayers();
-    void fetchAllHoleDetails();
-    void fetchAllScores();
-    void calculateAllPlayerTwoDayMosleyNetScores();
-    void calculateLeaderboard();
+    TournamentSnapshot m_snapshot;
+    QVector<int> m_playerTwoDayMosleyNetScoreForCut;
+
+    static int calculateTwoDayMosleyNetScore(const TournamentSnapshot &snapshot, int playerRow);
+    static bool isPlayerIncluded(int twoDayMosleyScore, TournamentContext context, int cutLineScore, bool isCutApplied);
+    static LeaderboardRow buildLeaderboardRow(const TournamentSnapshot &snapshot, int playerRow, int twoDayMosleyScore, TournamentContext context);
+    static bool ranksAbove(const LeaderboardRow &a, const LeaderboardRow &b);
+    static DisplayRow displayRow(const LeaderboardRow &row);
+    int findLeaderboardRow(int playerId) const;
+    void updateRanks(int first, int last);
+    void insertLeaderboardRow(int pos, const LeaderboardRow &row);
+    void removeLeaderboardRow(int pos);
 
     int calculateNetStablefordPointsForHole(int grossScore, int par) const;
 };
@@ -19,17 +19,26 @@ TournamentLeaderboardWidget::TournamentLeaderboardWidget(const QString &connecti
     : QWidget(parent),
       m_connectionName(connectionName),
       leaderboardModel(nullptr),
-      leaderboardView(nullptr) {
+      proxyModel(nullptr),
+      leaderboardView(nullptr),
+      searchEdit(nullptr) {
 
     QString nameToPassToModel = this->m_connectionName;
     this->leaderboardModel = new TournamentLeaderboardModel(nameToPassToModel, this); 
 
+    this->proxyModel = new LeaderboardProxyModel(this);
+    proxyModel->setSourceModel(leaderboardModel);
     this->leaderboardView = new QTableView(this);
+    this->searchEdit = new QLineEdit(this);
+    searchEdit->setPlaceholderText(tr("Search players..."));
+    searchEdit->setClearButtonEnabled(true);
+    connect(searchEdit, &QLineEdit::textChanged, proxyModel, &LeaderboardProxyModel::setNameFilter);
 
-    leaderboardView->setModel(leaderboardModel);
+    leaderboardView->setModel(proxyModel);
     configureTableView();
 
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(searchEdit);
     mainLayout->addWidget(leaderboardView);
     setLayout(mainLayout);
 }
@@ -52,6 +61,9 @@ QSqlDatabase TournamentLeaderboardWidget::database() const {
 void TournamentLeaderboardWidget::configureTableView() {
     if (!leaderboardView) return;
     leaderboardView->verticalHeader()->setVisible(false);
+    // Every row has the same height, so the view never has to measure the rows it fetches.
+    leaderboardView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    leaderboardView->verticalHeader()->setDefaultSectionSize(leaderboardView->fontMetrics().height() + 8);
     leaderboardView->setSelectionBehavior(QAbstractItemView::SelectRows);
     leaderboardView->setSelectionMode(QAbstractItemView::NoSelection);
     leaderboardView->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -67,6 +79,9 @@ void TournamentLeaderboardWidget::configureTableView() {
     leaderboardView->horizontalHeader()->setSectionResizeMode(7, QHeaderView::ResizeToContents); 
     leaderboardView->horizontalHeader()->setSectionResizeMode(8, QHeaderView::ResizeToContents); 
     leaderboardView->horizontalHeader()->setSectionResizeMode(9, QHeaderView::ResizeToContents); 
+
+    leaderboardView->setSortingEnabled(true);
+    leaderboardView->sortByColumn(LeaderboardProxyModel::RankColumn, Qt::AscendingOrder);
 }
 
 void TournamentLeaderboardWidget::refreshData() {
@@ -78,6 +93,33 @@ void TournamentLeaderboardWidget::refreshData() {
     updateColumnVisibility(); 
 }
 
+void TournamentLeaderboardWidget::refreshData(const TournamentSnapshot &snapshot) {
+    if (leaderboardModel) {
+        leaderboardModel->refreshData(snapshot);
+    } else {
+        qWarning() << "TournamentLeaderboardWidget instance" << this << ": leaderboardModel is null in refreshData()!";
+    }
+    updateColumnVisibility();
+}
+
+/**
+ * @brief Applies a single score change without resetting the view.
+ */
+void TournamentLeaderboardWidget::applyScoreChange(const TournamentSnapshot &snapshot, int playerId) {
+    if (!leaderboardModel) return;
+    leaderboardModel->applyScoreChange(snapshot, playerId);
+    updateColumnVisibility();
+}
+
+/**
+ * @brief Shows a leaderboard calculated on a worker thread.
+ */
+void TournamentLeaderboardWidget::setResult(const TournamentLeaderboardModel::Result &result) {
+    if (!leaderboardModel) return;
+    leaderboardModel->setResult(result);
+    updateColumnVisibility();
+}
+
 /**
  * @brief Updates the visibility of the daily score columns.
  */
@@ -97,110 +139,23 @@ void TournamentLeaderboardWidget::updateColumnVisibility() {
     leaderboardView->setColumnHidden(8, !day3HasScores);
 }
 
-QImage TournamentLeaderboardWidget::exportToImage() const {
-    if (!leaderboardModel || !leaderboardView) return QImage();
-
-    int rowCount = leaderboardModel->rowCount();
-    int colCount = leaderboardModel->columnCount();
-
-    if (rowCount == 0 || colCount == 0) {
-        qDebug() << "TournamentLeaderboardWidget::exportToImage: No data to export.";
-        return QImage();
-    }
-
-    int titleHeight = 100;
-    int headerHeight = 60;
-    int rowHeight = 50;
-    int padding = 15;
-    QVector<int> columnWidths = {100, 220, 220, 220, 220, 220, 220, 220, 220, 200}; 
-
-    int totalWidth = padding * 2;
-    for(int i=0; i < colCount; ++i) {
-        if (!leaderboardView->isColumnHidden(i)) {
-            if (i < columnWidths.size()) totalWidth += columnWidths.at(i);
-            else totalWidth += 220; 
-        }
-    }
-    
-    int totalHeight = padding * 2 + titleHeight + headerHeight + (rowCount * rowHeight);
-
-    QImage image(totalWidth, totalHeight, QImage::Format_ARGB32);
-    image.fill(Qt::white);
-    QPainter painter(&image);
-    painter.setPen(Qt::white);
-    painter.setRenderHint(QPainter::Antialiasing);
-
-    QString leaderboardTitle = "Leaderboard";
+LeaderboardImageExporter TournamentLeaderboardWidget::imageExporter() const {
+    LeaderboardImageExporter::Layout layout;
     if (!this->windowTitle().isEmpty() && this->windowTitle() != "QWidget") {
-        leaderboardTitle = this->windowTitle();
+        layout.title = this->windowTitle();
     } else if (leaderboardModel->getTournamentContext() == TournamentLeaderboardModel::MosleyOpen) {
-        leaderboardTitle = "Mosley Open";
+        layout.title = "Mosley Open";
     } else if (leaderboardModel->getTournamentContext() == TournamentLeaderboardModel::TwistedCreek) {
-        leaderboardTitle = "Twisted Creek";
-    }
-
-    painter.setFont(QFont("Arial", 32, QFont::Bold));
-    QRect titleRect(padding, padding, totalWidth - 2 * padding, titleHeight);
-    painter.fillRect(titleRect, Qt::black);
-    painter.drawText(titleRect, Qt::AlignCenter, leaderboardTitle);
-
-    painter.setFont(QFont("Arial", 24, QFont::Bold));
-    int currentX = padding;
-    int currentY = padding + titleHeight;
-    for (int col = 0; col < colCount; ++col) {
-        if (leaderboardView->isColumnHidden(col)) continue;
-        int colWidth = (col < columnWidths.size()) ? columnWidths.at(col) : 80;
-        QRect headerRect(currentX, currentY, colWidth, headerHeight);
-        painter.fillRect(headerRect, Qt::black);
-        painter.drawText(headerRect, 
-                         static_cast<Qt::AlignmentFlag>(leaderboardModel->headerData(col, Qt::Horizontal, Qt::TextAlignmentRole).toInt()),
-                         leaderboardModel->headerData(col, Qt::Horizontal, Qt::DisplayRole).toString());
-        currentX += colWidth;
+        layout.title = "Twisted Creek";
+    } else {
+        layout.title = "Leaderboard";
     }
 
-    painter.setFont(QFont("Arial", 18));
-    painter.setPen(Qt::black);
-    painter.drawLine(padding, padding, totalWidth - padding, padding);
-    currentY += headerHeight;
-    for (int row = 0; row < rowCount; ++row) {
-        currentX = padding;
-        QColor rowColor = (row % 2 == 0) ? Qt::white : QColor(240, 240, 240);
-        if (leaderboardModel->data(leaderboardModel->index(row, 0), Qt::DisplayRole).toInt() <= 3) {
-            rowColor = QColor(255, 165, 0, 255);
-        }
-        
-        int visibleRowWidth = 0;
-        for(int col_idx = 0; col_idx < colCount; ++col_idx) {
-            if(!leaderboardView->isColumnHidden(col_idx)) {
-                 visibleRowWidth += (col_idx < columnWidths.size()) ? columnWidths.at(col_idx) : 220;
-            }
+    const QVector<int> columnWidths = {100, 220, 220, 220, 220, 220, 220, 220, 220, 200};
+    for (int col = 0; col < leaderboardModel->columnCount(); ++col) {
+        if (!leaderboardView->isColumnHidden(col)) {
+            layout.columns.append({ col, col < columnWidths.size() ? columnWidths.at(col) : 220 });
         }
-        painter.fillRect(padding, currentY, visibleRowWidth, rowHeight, rowColor);
-        painter.drawLine(currentX, currentY + rowHeight, totalWidth - padding, currentY + rowHeight);
-
-        for (int col = 0; col < colCount; ++col) {
-            if (leaderboardView->isColumnHidden(col)) continue;
-            int colWidth = (col < columnWidths.size()) ? columnWidths.at(col) : 220;
-            QRect dataRect(currentX, currentY, colWidth, rowHeight);
-            painter.drawText(dataRect, 
-                             static_cast<Qt::AlignmentFlag>(leaderboardModel->data(leaderboardModel->index(row, col), Qt::TextAlignmentRole).toInt()),
-                             leaderboardModel->data(leaderboardModel->index(row, col), Qt::DisplayRole).toString());
-            currentX += colWidth;
-        }
-        currentY += rowHeight;
-    }
-
-    currentX = padding;
-    currentY = padding + titleHeight + headerHeight;
-    painter.drawLine(currentX, padding, currentX, totalHeight - padding);
-    for (int col = 0; col < colCount; ++col) {
-        if (leaderboardView->isColumnHidden(col)) continue;
-        int colWidth = (col < columnWidths.size()) ? columnWidths.at(col) : 220;
-        painter.drawLine(currentX, currentY, currentX, totalHeight - padding);
-        currentX += colWidth;
     }
-    painter.drawLine(currentX, padding, currentX, totalHeight - padding);
-    
-    painter.end();
-    return image;
+    return LeaderboardImageExporter(leaderboardModel, layout);
 }
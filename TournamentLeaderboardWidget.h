@@ -11,6 +11,7 @@
 #include <QTableView>
 #include <QVBoxLayout>
 #include <QHeaderView>
+#include <QLineEdit>
 #include <QSet>
 #include <QPainter>
 #include <QPixmap>
@@ -20,6 +21,8 @@
 #include <QDir>
 
 #include "tournamentleaderboardmodel.h"
+#include "LeaderboardProxyModel.h"
+#include "LeaderboardImageExporter.h"
 
 /**
  * @class TournamentLeaderboardWidget
@@ -38,12 +41,17 @@ public:
     ~TournamentLeaderboardWidget();
 
     void refreshData();
-    QImage exportToImage() const;
+    void refreshData(const TournamentSnapshot &snapshot);
+    void applyScoreChange(const TournamentSnapshot &snapshot, int playerId);
+    void setResult(const TournamentLeaderboardModel::Result &result);
+    LeaderboardImageExporter imageExporter() const;
     TournamentLeaderboardModel *leaderboardModel;
 
 private:
     QString m_connectionName;
+    LeaderboardProxyModel *proxyModel;
     QTableView *leaderboardView;
+    QLineEdit *searchEdit;
 
     QSqlDatabase database() const;
     void configureTableView();
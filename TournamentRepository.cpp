@@ -0,0 +1,286 @@
+/**
+ * @file TournamentRepository.cpp
+ * @brief Implements the TournamentRepository class.
+ */
+
+#include "TournamentRepository.h"
+#include <QSqlError>
+#include <QHash>
+#include <QMutex>
+#include <QDebug>
+#include <iterator>
+
+namespace {
+
+struct StatementDefinition {
+    const char *name;
+    const char *sql;
+};
+
+// Indexed by TournamentRepository::Statement. Scores, settings and teams
+// belong to the current event, selected through the current_event view.
+constexpr StatementDefinition statement_definitions[] = {
+    { "saveScore",
+      "INSERT OR REPLACE INTO scores (event_id, player_id, course_id, hole_num, day_num, score) "
+      "VALUES ((SELECT id FROM current_event), :pid, :cid, :hnum, :dnum, :score)" },
+    { "updateHole",
+      "UPDATE holes SET par = :par, handicap = :hc WHERE course_id = :cid AND hole_num = :hnum" },
+    { "readSetting",
+      "SELECT value FROM settings WHERE event_id = (SELECT id FROM current_event) AND key = :key" },
+    { "writeSetting",
+      "INSERT OR REPLACE INTO settings (event_id, key, value) VALUES ((SELECT id FROM current_event), :key, :value)" },
+    { "insertTeam",
+      "INSERT INTO teams (event_id, id, name) VALUES ((SELECT id FROM current_event), :id, :name)" },
+    { "setPlayerTeam",
+      "INSERT OR REPLACE INTO team_members (event_id, player_id, team_id) "
+      "VALUES ((SELECT id FROM current_event), :playerId, :teamId)" },
+    { "clearPlayerTeam",
+      "DELETE FROM team_members WHERE event_id = (SELECT id FROM current_event) AND player_id = :playerId" },
+    { "roundScores",
+      "SELECT s.player_id, s.hole_num, s.score FROM scores s "
+      "JOIN players p ON p.id = s.player_id AND p.active = 1 "
+      "WHERE s.event_id = (SELECT id FROM current_event) AND s.day_num = :dnum AND s.course_id = :cid" },
+};
+
+QMutex registryMutex;
+
+QHash<QString, TournamentRepository *> &registry()
+{
+    static QHash<QString, TournamentRepository *> repositories;
+    return repositories;
+}
+
+} // namespace
+
+TournamentRepository &TournamentRepository::forConnection(const QString &connectionName)
+{
+    QMutexLocker locker(&registryMutex);
+    TournamentRepository *&repository = registry()[connectionName];
+    if (!repository) {
+        repository = new TournamentRepository(connectionName);
+    }
+    return *repository;
+}
+
+void TournamentRepository::release(const QString &connectionName)
+{
+    QMutexLocker locker(&registryMutex);
+    delete registry().take(connectionName);
+}
+
+void TournamentRepository::releaseAll()
+{
+    QMutexLocker locker(&registryMutex);
+    qDeleteAll(registry());
+    registry().clear();
+}
+
+TournamentRepository::TournamentRepository(const QString &connectionName)
+    : m_connectionName(connectionName)
+{
+    static_assert(std::size(statement_definitions) == StatementCount);
+    for (int i = 0; i < StatementCount; ++i) {
+        m_statements[i].stats.name = QString::fromLatin1(statement_definitions[i].name);
+    }
+}
+
+TournamentRepository::~TournamentRepository()
+{
+    logStatistics();
+    for (PreparedStatement &statement : m_statements) {
+        if (statement.query) {
+            statement.query->finish();
+        }
+    }
+}
+
+/**
+ * @brief Gets a prepared statement, preparing it if this is its first use.
+ * @param id The statement.
+ * @return The statement, or nullptr if the connection is closed or preparing failed.
+ */
+QSqlQuery *TournamentRepository::statement(Statement id)
+{
+    PreparedStatement &statement = m_statements[id];
+    if (statement.query) {
+        return statement.query.get();
+    }
+
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    if (!db.isValid() || !db.isOpen()) {
+        m_lastError = QStringLiteral("Invalid or closed database connection.");
+        qDebug() << "TournamentRepository::statement: ERROR:" << m_lastError;
+        return nullptr;
+    }
+
+    auto query = std::make_unique<QSqlQuery>(db);
+    query->setForwardOnly(true);
+    if (!query->prepare(QString::fromLatin1(statement_definitions[id].sql))) {
+        m_lastError = query->lastError().text();
+        qDebug() << "TournamentRepository::statement: ERROR preparing" << statement.stats.name << ":" << m_lastError;
+        return nullptr;
+    }
+    statement.query = std::move(query);
+    return statement.query.get();
+}
+
+/**
+ * @brief Executes a bound statement and records its statistics.
+ * @param id The statement.
+ * @param query The statement's query, or nullptr if it could not be prepared.
+ * @param timer Started before the statement was fetched, so preparing is included.
+ * @return True if the statement executed successfully.
+ */
+bool TournamentRepository::execute(Statement id, QSqlQuery *query, const QElapsedTimer &timer)
+{
+    StatementStats &stats = m_statements[id].stats;
+    bool ok = query && query->exec();
+    if (query && !ok) {
+        m_lastError = query->lastError().text();
+    }
+    ++stats.executions;
+    if (!ok) {
+        ++stats.failures;
+    }
+    stats.totalNsecs += timer.nsecsElapsed();
+    return ok;
+}
+
+bool TournamentRepository::saveScore(int playerId, int courseId, int holeNum, int dayNum, int score)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QSqlQuery *query = statement(SaveScore);
+    if (query) {
+        query->bindValue(":pid", playerId);
+        query->bindValue(":cid", courseId);
+        query->bindValue(":hnum", holeNum);
+        query->bindValue(":dnum", dayNum);
+        query->bindValue(":score", score);
+    }
+    return execute(SaveScore, query, timer);
+}
+
+bool TournamentRepository::updateHole(int courseId, int holeNum, int par, int handicap)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QSqlQuery *query = statement(UpdateHole);
+    if (query) {
+        query->bindValue(":par", par);
+        query->bindValue(":hc", handicap);
+        query->bindValue(":cid", courseId);
+        query->bindValue(":hnum", holeNum);
+    }
+    return execute(UpdateHole, query, timer);
+}
+
+QVariant TournamentRepository::readSetting(const QString &key)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QSqlQuery *query = statement(ReadSetting);
+    if (query) {
+        query->bindValue(":key", key);
+    }
+    if (!execute(ReadSetting, query, timer)) {
+        return QVariant();
+    }
+
+    QVariant value;
+    if (query->next()) {
+        value = query->value(0);
+    }
+    // Finishing releases SQLite's read lock; the statement stays prepared.
+    query->finish();
+    return value;
+}
+
+bool TournamentRepository::writeSetting(const QString &key, const QVariant &value)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QSqlQuery *query = statement(WriteSetting);
+    if (query) {
+        query->bindValue(":key", key);
+        query->bindValue(":value", value);
+    }
+    return execute(WriteSetting, query, timer);
+}
+
+bool TournamentRepository::insertTeam(int teamId, const QString &name)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QSqlQuery *query = statement(InsertTeam);
+    if (query) {
+        query->bindValue(":id", teamId);
+        query->bindValue(":name", name);
+    }
+    return execute(InsertTeam, query, timer);
+}
+
+bool TournamentRepository::setPlayerTeam(int playerId, int teamId)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const Statement id = teamId >= 0 ? SetPlayerTeam : ClearPlayerTeam;
+    QSqlQuery *query = statement(id);
+    if (query) {
+        if (teamId >= 0) {
+            query->bindValue(":teamId", teamId);
+        }
+        query->bindValue(":playerId", playerId);
+    }
+    return execute(id, query, timer);
+}
+
+QMap<int, QMap<int, int>> TournamentRepository::roundScores(int dayNum, int courseId, bool *ok)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QSqlQuery *query = statement(RoundScores);
+    if (query) {
+        query->bindValue(":dnum", dayNum);
+        query->bindValue(":cid", courseId);
+    }
+    const bool executed = execute(RoundScores, query, timer);
+    if (ok) {
+        *ok = executed;
+    }
+
+    QMap<int, QMap<int, int>> scores;
+    if (!executed) {
+        return scores;
+    }
+    while (query->next()) {
+        scores[query->value(0).toInt()][query->value(1).toInt()] = query->value(2).toInt();
+    }
+    query->finish();
+    return scores;
+}
+
+QList<TournamentRepository::StatementStats> TournamentRepository::statistics() const
+{
+    QList<StatementStats> result;
+    result.reserve(StatementCount);
+    for (const PreparedStatement &statement : m_statements) {
+        result.append(statement.stats);
+    }
+    return result;
+}
+
+void TournamentRepository::logStatistics() const
+{
+    for (const PreparedStatement &statement : m_statements) {
+        const StatementStats &stats = statement.stats;
+        if (stats.executions == 0) {
+            continue;
+        }
+        qDebug() << "TournamentRepository:" << m_connectionName << stats.name
+                 << "executions:" << stats.executions
+                 << "failures:" << stats.failures
+                 << "total ms:" << stats.totalNsecs / 1e6
+                 << "avg us:" << stats.totalNsecs / 1e3 / stats.executions;
+    }
+}
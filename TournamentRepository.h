@@ -0,0 +1,163 @@
+/**
+ * @file TournamentRepository.h
+ * @brief Contains the declaration of the TournamentRepository class.
+ */
+
+#ifndef TOURNAMENTREPOSITORY_H
+#define TOURNAMENTREPOSITORY_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QVariant>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <array>
+#include <memory>
+
+/**
+ * @class TournamentRepository
+ * @brief Runs the frequently executed statements of one database connection.
+ *
+ * Scores, settings and teams are read and written for the current event.
+ *
+ * Each statement is prepared once, the first time it is used, and the
+ * forward-only QSqlQuery is kept for the lifetime of the repository, so edits
+ * only bind values and execute. The number of executions and the time spent in
+ * each statement are recorded.
+ *
+ * A repository belongs to the thread that uses its connection. Call release()
+ * before the connection is closed or removed.
+ */
+class TournamentRepository
+{
+public:
+    /**
+     * @struct StatementStats
+     * @brief Execution statistics of one statement.
+     */
+    struct StatementStats {
+        QString name;           ///< The name of the statement.
+        qint64 executions = 0;  ///< The number of times it was executed.
+        qint64 failures = 0;    ///< The number of executions that failed.
+        qint64 totalNsecs = 0;  ///< The total time spent preparing and executing it.
+    };
+
+    /**
+     * @brief Gets the repository of a connection, creating it on first use.
+     * @param connectionName The name of the database connection.
+     */
+    static TournamentRepository &forConnection(const QString &connectionName);
+
+    /**
+     * @brief Finishes the statements of a connection and destroys its repository.
+     * @param connectionName The name of the database connection.
+     */
+    static void release(const QString &connectionName);
+
+    /**
+     * @brief Releases the repositories of all connections.
+     */
+    static void releaseAll();
+
+    TournamentRepository(const TournamentRepository &) = delete;
+    TournamentRepository &operator=(const TournamentRepository &) = delete;
+    ~TournamentRepository();
+
+    /**
+     * @brief Inserts or replaces the score of a hole.
+     * @return True if the score was saved.
+     */
+    bool saveScore(int playerId, int courseId, int holeNum, int dayNum, int score);
+
+    /**
+     * @brief Updates the par and handicap index of a hole.
+     * @return True if the hole was updated.
+     */
+    bool updateHole(int courseId, int holeNum, int par, int handicap);
+
+    /**
+     * @brief Reads a value from the settings table.
+     * @param key The setting key.
+     * @return The value, or an invalid QVariant if the key is not set or the query failed.
+     */
+    QVariant readSetting(const QString &key);
+
+    /**
+     * @brief Inserts or replaces a value in the settings table.
+     * @return True if the setting was saved.
+     */
+    bool writeSetting(const QString &key, const QVariant &value);
+
+    /**
+     * @brief Inserts a team.
+     * @return True if the team was inserted.
+     */
+    bool insertTeam(int teamId, const QString &name);
+
+    /**
+     * @brief Assigns a player to a team for the current event.
+     * @param playerId The player.
+     * @param teamId The team, or -1 to remove the player from any team.
+     * @return True if the player was updated.
+     */
+    bool setPlayerTeam(int playerId, int teamId);
+
+    /**
+     * @brief Reads the scores of the active players for one round.
+     *
+     * Active players are selected by a join, so the statement text does not
+     * depend on the field and is prepared only once.
+     *
+     * @param dayNum The tournament day.
+     * @param courseId The course played on that day.
+     * @param ok If not null, set to false when the query failed.
+     * @return A map of player ID to a map of hole number to score.
+     */
+    QMap<int, QMap<int, int>> roundScores(int dayNum, int courseId, bool *ok = nullptr);
+
+    /**
+     * @brief Gets the error of the last statement that failed.
+     */
+    QString lastError() const { return m_lastError; }
+
+    /**
+     * @brief Gets the execution statistics of every statement.
+     */
+    QList<StatementStats> statistics() const;
+
+    /**
+     * @brief Writes the execution statistics to the debug output.
+     */
+    void logStatistics() const;
+
+private:
+    enum Statement {
+        SaveScore,
+        UpdateHole,
+        ReadSetting,
+        WriteSetting,
+        InsertTeam,
+        SetPlayerTeam,
+        ClearPlayerTeam,
+        RoundScores,
+        StatementCount
+    };
+
+    struct PreparedStatement {
+        std::unique_ptr<QSqlQuery> query;
+        StatementStats stats;
+    };
+
+    explicit TournamentRepository(const QString &connectionName);
+
+    QSqlQuery *statement(Statement id);
+    bool execute(Statement id, QSqlQuery *query, const QElapsedTimer &timer);
+
+    QString m_connectionName;
+    std::array<PreparedStatement, StatementCount> m_statements;
+    QString m_lastError;
+};
+
+#endif // TOURNAMENTREPOSITORY_H
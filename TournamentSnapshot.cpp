@@ -0,0 +1,934 @@
+/**
+ * @file TournamentSnapshot.cpp
+ * @brief Implements the TournamentSnapshot class.
+ */
+
+#include "TournamentSnapshot.h"
+#include "StablefordKernel.h"
+#include "utils.h"
+
+#include <QSharedData>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QByteArray>
+#include <QHash>
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+/**
+ * @class TournamentSnapshotData
+ * @brief The shared payload behind a TournamentSnapshot.
+ */
+class TournamentSnapshotData : public QSharedData
+{
+public:
+    static constexpr int PlayersPerBlock = 64;  ///< Player rows per RoundBlock.
+    static constexpr qsizetype RoundsPerBlock = PlayersPerBlock * TournamentSnapshot::MaxDays;
+
+    /**
+     * @struct RoundBlock
+     * @brief The rounds of PlayersPerBlock consecutive player rows.
+     *
+     * Each block is shared on its own, so changing one score copies a single
+     * block rather than the rounds of every player.
+     */
+    struct RoundBlock {
+        QByteArray grossScores;         ///< rounds x HolesPerRound signed bytes.
+        QVector<int> courseIds;         ///< Course id per round, -1 when no round.
+        QByteArray netHolePoints;       ///< Net Stableford points per hole, StablefordKernel::NotPlayed when unscored.
+        QVector<int> grossPoints;       ///< Gross Stableford points per round.
+    };
+
+    bool valid = false;
+    bool hasHoleScores = true;
+    QVector<PlayerInfo> players;        ///< Active players ordered by id.
+    QVector<int> playerTeamIds;         ///< Team id per player row, -1 when unassigned.
+    QVector<TeamInfo> teams;            ///< All teams ordered by id.
+    QVector<CourseHoles> courses;       ///< Hole details per course, ordered by course id.
+    QVector<RoundBlock> roundBlocks;    ///< MaxDays rounds per player row, PlayersPerBlock rows per block.
+    QSet<int> daysWithScores;
+    std::shared_ptr<QFile> archiveFile; ///< Keeps the archive mapped while block scores and points point into it.
+
+    /** @brief A mapped archive section that openArchive() did not check. */
+    struct UncheckedSection {
+        const uchar *data = nullptr;
+        qint64 size = 0;
+        quint32 checksum = 0;   ///< The CRC-32 stored for the section.
+    };
+    QVector<UncheckedSection> uncheckedSections; ///< The archived hole scores and points, checked by verifyArchive().
+
+    /** @brief The number of rounds held by block @p block of @p rounds rounds. */
+    static qsizetype roundsInBlock(qsizetype rounds, qsizetype block)
+    {
+        return std::min(RoundsPerBlock, rounds - block * RoundsPerBlock);
+    }
+
+    const RoundBlock &blockForRow(int row) const
+    {
+        return roundBlocks.at(row / PlayersPerBlock);
+    }
+
+    RoundBlock &blockForRow(int row)
+    {
+        return roundBlocks[row / PlayersPerBlock];
+    }
+
+    /** @brief The index of a player's round within the player's block. */
+    static int roundIndex(int row, int dayNum)
+    {
+        return (row % PlayersPerBlock) * TournamentSnapshot::MaxDays + (dayNum - 1);
+    }
+
+    const CourseHoles *findCourse(int courseId) const
+    {
+        auto it = std::ranges::lower_bound(courses, courseId, {}, &CourseHoles::courseId);
+        if (it == courses.cend() || it->courseId != courseId) {
+            return nullptr;
+        }
+        return &*it;
+    }
+
+    void allocateRounds();
+    void scoreRounds(int block, qsizetype firstRound, qsizetype roundCount);
+};
+
+/**
+ * @brief Sizes the round blocks for every player, with no rounds played.
+ */
+void TournamentSnapshotData::allocateRounds()
+{
+    constexpr int HolesPerRound = TournamentSnapshot::HolesPerRound;
+    const qsizetype rounds = players.size() * TournamentSnapshot::MaxDays;
+    roundBlocks.resize((rounds + RoundsPerBlock - 1) / RoundsPerBlock);
+    for (qsizetype i = 0; i < roundBlocks.size(); ++i) {
+        const qsizetype count = roundsInBlock(rounds, i);
+        RoundBlock &block = roundBlocks[i];
+        block.grossScores.fill('\0', count * HolesPerRound);
+        block.courseIds.fill(-1, count);
+        block.netHolePoints.fill(char(StablefordKernel::NotPlayed), count * HolesPerRound);
+        block.grossPoints.fill(0, count);
+    }
+}
+
+/**
+ * @brief Calculates the gross and net Stableford points of a range of rounds.
+ *
+ * The par and strokes received of every hole are laid out next to the gross
+ * scores so the whole range is scored in one batch by StablefordKernel.
+ *
+ * @param block The index of the block holding the rounds.
+ * @param firstRound The index of the first round to score within the block.
+ * @param roundCount The number of rounds to score.
+ */
+void TournamentSnapshotData::scoreRounds(int block, qsizetype firstRound, qsizetype roundCount)
+{
+    constexpr int HolesPerRound = TournamentSnapshot::HolesPerRound;
+    const qsizetype holeCount = roundCount * HolesPerRound;
+    if (holeCount <= 0) {
+        return;
+    }
+
+    QByteArray pars(holeCount, '\0');
+    QByteArray strokes(holeCount, '\0');
+    QByteArray grossHolePoints(holeCount, Qt::Uninitialized);
+    qint8 *roundPars = reinterpret_cast<qint8 *>(pars.data());
+    qint8 *roundStrokes = reinterpret_cast<qint8 *>(strokes.data());
+    RoundBlock &roundBlock = roundBlocks[block];
+    const qint8 *gross = reinterpret_cast<const qint8 *>(roundBlock.grossScores.constData()) + firstRound * HolesPerRound;
+    const qsizetype firstRow = qsizetype(block) * PlayersPerBlock;
+
+    int holesWithoutDetails = 0;
+    for (qsizetype i = 0; i < roundCount; ++i) {
+        const qsizetype round = firstRound + i;
+        const CourseHoles *course = findCourse(roundBlock.courseIds.at(round));
+        if (!course) {
+            continue;
+        }
+        const int handicap = players.at(firstRow + round / TournamentSnapshot::MaxDays).handicap;
+        for (int hole = 0; hole < HolesPerRound; ++hole) {
+            const qsizetype h = i * HolesPerRound + hole;
+            roundPars[h] = course->par[hole];
+            roundStrokes[h] = static_cast<qint8>(strokesReceived(handicap, course->handicapIndex[hole]));
+            if (gross[h] > 0 && course->par[hole] <= 0) {
+                ++holesWithoutDetails;
+            }
+        }
+    }
+    if (holesWithoutDetails > 0) {
+        qDebug() << "TournamentSnapshot: Warning:" << holesWithoutDetails << "scored holes have no hole details and were not counted.";
+    }
+
+    StablefordKernel::scoreHoles(gross, roundPars, nullptr, holeCount, reinterpret_cast<qint8 *>(grossHolePoints.data()));
+    StablefordKernel::sumRounds(reinterpret_cast<const qint8 *>(grossHolePoints.constData()), roundCount, roundBlock.grossPoints.data() + firstRound);
+    StablefordKernel::scoreHoles(gross, roundPars, roundStrokes, holeCount,
+                                 reinterpret_cast<qint8 *>(roundBlock.netHolePoints.data()) + firstRound * HolesPerRound);
+}
+
+namespace {
+
+// Archive layout: SnapshotHeader, then each section below in order, every
+// section starting on an 8-byte boundary. All integers are little-endian.
+//   PlayerRecord[playerCount]        ordered by player id
+//   TeamRecord[teamCount]            ordered by team id
+//   CourseRecord[courseCount]        ordered by course id
+//   qint32[playerCount * MaxDays]    course id of each round, -1 when unplayed
+//   qint32[playerCount * MaxDays]    gross Stableford points of each round
+//   qint8[rounds * HolesPerRound]    gross scores
+//   qint8[rounds * HolesPerRound]    net Stableford points per hole
+//   char16_t[stringLength]           UTF-16 player and team names
+// The header holds a CRC-32 of itself and of every section.
+
+constexpr char archive_magic[8] = { 'M', 'O', 'S', 'N', 'A', 'P', '\r', '\n' };
+constexpr quint32 archive_version = 2;
+constexpr quint32 archive_max_records = 1u << 20;
+
+enum ArchiveFlag : quint32 {
+    ArchiveHasHoleScores = 0x1,
+    ArchiveCutApplied = 0x2
+};
+
+enum ArchiveSection {
+    PlayersSection,
+    TeamsSection,
+    CoursesSection,
+    RoundCourseIdsSection,
+    GrossRoundPointsSection,
+    GrossScoresSection,
+    NetHolePointsSection,
+    StringsSection,
+    ArchiveSectionCount
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    quint32_le version;
+    quint32_le headerSize;
+    quint32_le flags;
+    quint32_le maxDays;
+    quint32_le holesPerRound;
+    quint32_le playerCount;
+    quint32_le teamCount;
+    quint32_le courseCount;
+    quint32_le stringLength;    ///< UTF-16 code units in the string pool.
+    quint32_le daysWithScores;  ///< Bit d - 1 is set when day d has scores.
+    qint32_le cutLineScore;
+    quint32_le sectionChecksums[ArchiveSectionCount]; ///< CRC-32 of each section, in ArchiveSection order.
+    quint32_le headerChecksum;  ///< CRC-32 of the header fields above.
+};
+
+struct PlayerRecord {
+    qint32_le id;
+    qint32_le handicap;
+    qint32_le teamId;
+    quint32_le nameOffset;
+    quint32_le nameLength;
+};
+
+struct TeamRecord {
+    qint32_le id;
+    quint32_le nameOffset;
+    quint32_le nameLength;
+};
+
+struct CourseRecord {
+    qint32_le courseId;
+    qint8 par[TournamentSnapshot::HolesPerRound];
+    qint8 handicapIndex[TournamentSnapshot::HolesPerRound];
+};
+
+static_assert(sizeof(SnapshotHeader) == 88);
+static_assert(sizeof(PlayerRecord) == 20);
+static_assert(sizeof(TeamRecord) == 12);
+static_assert(sizeof(CourseRecord) == 40);
+
+/**
+ * @struct ArchiveLayout
+ * @brief The byte offset and size of every section of an archive.
+ */
+struct ArchiveLayout {
+    struct Span {
+        qint64 offset = 0;
+        qint64 size = 0;
+    };
+
+    qint64 players = 0;
+    qint64 teams = 0;
+    qint64 courses = 0;
+    qint64 roundCourseIds = 0;
+    qint64 grossRoundPoints = 0;
+    qint64 grossScores = 0;
+    qint64 netHolePoints = 0;
+    qint64 strings = 0;
+    qint64 size = 0;
+    std::array<Span, ArchiveSectionCount> sections;
+
+    ArchiveLayout(qint64 playerCount, qint64 teamCount, qint64 courseCount, qint64 stringLength)
+    {
+        const qint64 rounds = playerCount * TournamentSnapshot::MaxDays;
+        const qint64 holes = rounds * TournamentSnapshot::HolesPerRound;
+        qint64 offset = sizeof(SnapshotHeader);
+        auto section = [this, &offset](ArchiveSection id, qint64 bytes) {
+            const qint64 start = (offset + 7) & ~qint64(7);
+            offset = start + bytes;
+            sections[id] = { start, bytes };
+            return start;
+        };
+        players = section(PlayersSection, playerCount * qint64(sizeof(PlayerRecord)));
+        teams = section(TeamsSection, teamCount * qint64(sizeof(TeamRecord)));
+        courses = section(CoursesSection, courseCount * qint64(sizeof(CourseRecord)));
+        roundCourseIds = section(RoundCourseIdsSection, rounds * 4);
+        grossRoundPoints = section(GrossRoundPointsSection, rounds * 4);
+        grossScores = section(GrossScoresSection, holes);
+        netHolePoints = section(NetHolePointsSection, holes);
+        strings = section(StringsSection, stringLength * 2);
+        size = offset;
+    }
+};
+
+constexpr std::array<quint32, 256> crc32_table = [] {
+    std::array<quint32, 256> table {};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0u);
+        }
+        table[i] = crc;
+    }
+    return table;
+}();
+
+/**
+ * @brief Calculates the CRC-32 of a byte range, as zlib's crc32() does.
+ */
+quint32 crc32(const uchar *data, qint64 size)
+{
+    quint32 crc = 0xFFFFFFFFu;
+    for (qint64 i = 0; i < size; ++i) {
+        crc = crc32_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+quint32 headerChecksum(const SnapshotHeader *header)
+{
+    return crc32(reinterpret_cast<const uchar *>(header), offsetof(SnapshotHeader, headerChecksum));
+}
+
+quint32 sectionChecksum(const uchar *base, const ArchiveLayout &layout, ArchiveSection section)
+{
+    return crc32(base + layout.sections[section].offset, layout.sections[section].size);
+}
+
+/**
+ * @brief Copies a name out of the archive's string pool.
+ *
+ * Names are deep copies, since they outlive the snapshot in leaderboard rows
+ * and exports, while the mapping is released with the last snapshot copy.
+ */
+QString archiveString(const uchar *strings, quint32 offset, quint32 length)
+{
+    const char16_t *utf16 = reinterpret_cast<const char16_t *>(strings) + offset;
+    QString name(length, Qt::Uninitialized);
+    qFromLittleEndian<char16_t>(utf16, length, name.data());
+    return name;
+}
+
+} // namespace
+
+TournamentSnapshot::TournamentSnapshot()
+    : d(new TournamentSnapshotData)
+{
+}
+
+TournamentSnapshot::TournamentSnapshot(const TournamentSnapshot &other) = default;
+
+TournamentSnapshot &TournamentSnapshot::operator=(const TournamentSnapshot &other) = default;
+
+TournamentSnapshot::~TournamentSnapshot() = default;
+
+bool TournamentSnapshot::isValid() const
+{
+    return d->valid;
+}
+
+const QVector<PlayerInfo> &TournamentSnapshot::players() const
+{
+    return d->players;
+}
+
+int TournamentSnapshot::rowForPlayer(int playerId) const
+{
+    auto it = std::ranges::lower_bound(d->players, playerId, {}, &PlayerInfo::id);
+    if (it == d->players.cend() || it->id != playerId) {
+        return -1;
+    }
+    return static_cast<int>(it - d->players.cbegin());
+}
+
+int TournamentSnapshot::teamIdForRow(int row) const
+{
+    return d->playerTeamIds.value(row, -1);
+}
+
+const QVector<TeamInfo> &TournamentSnapshot::teams() const
+{
+    return d->teams;
+}
+
+const CourseHoles *TournamentSnapshot::courseHoles(int courseId) const
+{
+    return d->findCourse(courseId);
+}
+
+bool TournamentSnapshot::hasHoleScores() const
+{
+    return d->hasHoleScores;
+}
+
+bool TournamentSnapshot::hasHoleDetails() const
+{
+    return !d->courses.isEmpty();
+}
+
+bool TournamentSnapshot::hasRound(int row, int dayNum) const
+{
+    return roundCourseId(row, dayNum) != -1;
+}
+
+int TournamentSnapshot::roundCourseId(int row, int dayNum) const
+{
+    if (row < 0 || row >= d->players.size() || dayNum < 1 || dayNum > MaxDays) {
+        return -1;
+    }
+    return d->blockForRow(row).courseIds.at(d->roundIndex(row, dayNum));
+}
+
+const qint8 *TournamentSnapshot::roundScores(int row, int dayNum) const
+{
+    return reinterpret_cast<const qint8 *>(d->blockForRow(row).grossScores.constData()) + d->roundIndex(row, dayNum) * HolesPerRound;
+}
+
+int TournamentSnapshot::roundGrossPoints(int row, int dayNum) const
+{
+    if (!hasRound(row, dayNum)) {
+        return 0;
+    }
+    return d->blockForRow(row).grossPoints.at(d->roundIndex(row, dayNum));
+}
+
+const qint8 *TournamentSnapshot::roundNetHolePoints(int row, int dayNum) const
+{
+    return reinterpret_cast<const qint8 *>(d->blockForRow(row).netHolePoints.constData()) + d->roundIndex(row, dayNum) * HolesPerRound;
+}
+
+const QSet<int> &TournamentSnapshot::daysWithScores() const
+{
+    return d->daysWithScores;
+}
+
+/**
+ * @brief Loads one gross Stableford total per player-round from round_summaries.
+ *
+ * Instead of transferring 18 hole rows per round, the pre-aggregated summary of
+ * each round is read. When a player has scores on more than one course for a
+ * day, the course with the most recently entered score wins, as in the
+ * hole-by-hole load.
+ */
+void TournamentSnapshot::loadRoundTotals(QSqlQuery &query, TournamentSnapshotData *data, const QHash<int, int> &rowByPlayerId)
+{
+    if (query.exec("SELECT DISTINCT day_num FROM round_summaries WHERE event_id = (SELECT id FROM current_event)")) {
+        while (query.next()) {
+            data->daysWithScores.insert(query.value(0).toInt());
+        }
+    } else {
+        qDebug() << "TournamentSnapshot::loadRoundTotals: ERROR fetching score days:" << query.lastError().text();
+    }
+
+    // One row per round; see RoundSummaries for how the table is kept current.
+    const QString sql = QString("SELECT r.player_id, r.day_num, r.course_id, r.gross_stableford "
+                                "FROM round_summaries r "
+                                "JOIN players p ON p.id = r.player_id AND p.active = 1 "
+                                "WHERE r.event_id = (SELECT id FROM current_event) AND r.day_num BETWEEN 1 AND %1 "
+                                "ORDER BY r.last_score_id")
+                            .arg(MaxDays);
+
+    if (!query.exec(sql)) {
+        qDebug() << "TournamentSnapshot::loadRoundTotals: ERROR fetching round totals:" << query.lastError().text();
+        return;
+    }
+
+    while (query.next()) {
+        auto rowIt = rowByPlayerId.constFind(query.value(0).toInt());
+        if (rowIt == rowByPlayerId.cend()) {
+            continue;
+        }
+        int dayNum = query.value(1).toInt();
+        int courseId = query.value(2).toInt();
+        TournamentSnapshotData::RoundBlock &block = data->blockForRow(*rowIt);
+        int round = data->roundIndex(*rowIt, dayNum);
+        if (block.courseIds.at(round) != -1) {
+            qDebug() << "TournamentSnapshot::loadRoundTotals: Player" << data->players.at(*rowIt).name << "has day" << dayNum
+                     << "scores on courses" << block.courseIds.at(round) << "and" << courseId << "- keeping the most recently entered course.";
+        }
+        block.courseIds[round] = courseId;
+        block.grossPoints[round] = query.value(3).toInt();
+    }
+}
+
+/**
+ * @brief Loads players, teams, hole details and scores inside one read transaction.
+ */
+TournamentSnapshot TournamentSnapshot::load(const QString &connectionName, Detail detail)
+{
+    TournamentSnapshot snapshot;
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    if (!db.isValid() || !db.isOpen()) {
+        qWarning() << "TournamentSnapshot::load: DB connection '" << connectionName << "' is not valid or not open.";
+        return snapshot;
+    }
+
+    TournamentSnapshotData *data = snapshot.d.data();
+    const bool inTransaction = db.transaction();
+    if (!inTransaction) {
+        qDebug() << "TournamentSnapshot::load: Could not begin read transaction, reading without one:" << db.lastError().text();
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    if (query.exec("SELECT id, name FROM teams WHERE event_id = (SELECT id FROM current_event) ORDER BY id")) {
+        while (query.next()) {
+            data->teams.append({query.value(0).toInt(), query.value(1).toString()});
+        }
+    } else {
+        qDebug() << "TournamentSnapshot::load: ERROR fetching teams:" << query.lastError().text();
+    }
+
+    QHash<int, int> rowByPlayerId;
+    if (query.exec("SELECT p.id, p.name, p.handicap, m.team_id FROM players p "
+                   "LEFT JOIN team_members m ON m.event_id = (SELECT id FROM current_event) AND m.player_id = p.id "
+                   "WHERE p.active = 1 ORDER BY p.id")) {
+        while (query.next()) {
+            PlayerInfo player;
+            player.id = query.value(0).toInt();
+            player.name = query.value(1).toString();
+            player.handicap = query.value(2).toInt();
+            QVariant teamIdVariant = query.value(3);
+
+            rowByPlayerId.insert(player.id, data->players.size());
+            data->players.append(player);
+            data->playerTeamIds.append(teamIdVariant.isNull() ? -1 : teamIdVariant.toInt());
+        }
+    } else {
+        qDebug() << "TournamentSnapshot::load: ERROR fetching players:" << query.lastError().text();
+    }
+
+    if (query.exec("SELECT course_id, hole_num, par, handicap FROM holes ORDER BY course_id, hole_num")) {
+        while (query.next()) {
+            int courseId = query.value(0).toInt();
+            int holeNum = query.value(1).toInt();
+            if (holeNum < 1 || holeNum > HolesPerRound) {
+                continue;
+            }
+            if (data->courses.isEmpty() || data->courses.last().courseId != courseId) {
+                data->courses.append({courseId, {}, {}});
+            }
+            CourseHoles &course = data->courses.last();
+            course.par[holeNum - 1] = static_cast<qint8>(query.value(2).toInt());
+            course.handicapIndex[holeNum - 1] = static_cast<qint8>(query.value(3).toInt());
+        }
+    } else {
+        qDebug() << "TournamentSnapshot::load: ERROR fetching hole details:" << query.lastError().text();
+    }
+
+    data->allocateRounds();
+
+    if (detail == Detail::RoundTotals) {
+        data->hasHoleScores = false;
+        loadRoundTotals(query, data, rowByPlayerId);
+    } else if (query.exec("SELECT s.player_id, s.course_id, s.hole_num, s.day_num, s.score FROM scores s "
+                          // A round is on the course entered most recently, as in round_summaries; bare
+                          // columns next to MAX() come from the row holding the maximum.
+                          "JOIN (SELECT player_id, day_num, course_id, MAX(id) FROM scores "
+                          "      WHERE event_id = (SELECT id FROM current_event) GROUP BY player_id, day_num) k "
+                          "  ON k.player_id = s.player_id AND k.day_num = s.day_num AND k.course_id = s.course_id "
+                          "WHERE s.event_id = (SELECT id FROM current_event)")) {
+        while (query.next()) {
+            int dayNum = query.value(3).toInt();
+            data->daysWithScores.insert(dayNum);
+
+            auto rowIt = rowByPlayerId.constFind(query.value(0).toInt());
+            int holeNum = query.value(2).toInt();
+            if (rowIt == rowByPlayerId.cend() || dayNum < 1 || dayNum > MaxDays || holeNum < 1 || holeNum > HolesPerRound) {
+                continue;
+            }
+
+            TournamentSnapshotData::RoundBlock &block = data->blockForRow(*rowIt);
+            int round = data->roundIndex(*rowIt, dayNum);
+            block.courseIds[round] = query.value(1).toInt();
+            block.grossScores[round * HolesPerRound + holeNum - 1] = static_cast<char>(std::clamp(query.value(4).toInt(), 0, 127));
+        }
+    } else {
+        qDebug() << "TournamentSnapshot::load: ERROR fetching scores:" << query.lastError().text();
+    }
+
+    query.finish();
+    if (inTransaction) {
+        db.commit();
+    }
+
+    if (data->hasHoleScores) {
+        for (int i = 0; i < data->roundBlocks.size(); ++i) {
+            data->scoreRounds(i, 0, data->roundBlocks.at(i).courseIds.size());
+        }
+    }
+
+    data->valid = true;
+    return snapshot;
+}
+
+/**
+ * @brief Re-reads one player's round for a day from the database.
+ *
+ * Uses the same rule as load(): the round is on the course with the most
+ * recently entered score, and holds every score on that course.
+ *
+ * @return True if the round was read; the round is left as it was otherwise.
+ */
+bool TournamentSnapshot::loadRound(const QString &connectionName, TournamentSnapshotData *data, int row, int dayNum)
+{
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    if (!db.isValid() || !db.isOpen()) {
+        qWarning() << "TournamentSnapshot::loadRound: DB connection '" << connectionName << "' is not valid or not open.";
+        return false;
+    }
+
+    const int playerId = data->players.at(row).id;
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT course_id, hole_num, score FROM scores "
+                  "WHERE event_id = (SELECT id FROM current_event) AND player_id = ? AND day_num = ? "
+                  "  AND course_id = (SELECT course_id FROM scores "
+                  "                   WHERE event_id = (SELECT id FROM current_event) AND player_id = ? AND day_num = ? "
+                  "                   ORDER BY id DESC LIMIT 1)");
+    query.addBindValue(playerId);
+    query.addBindValue(dayNum);
+    query.addBindValue(playerId);
+    query.addBindValue(dayNum);
+    if (!query.exec()) {
+        qDebug() << "TournamentSnapshot::loadRound: ERROR fetching scores:" << query.lastError().text();
+        return false;
+    }
+
+    TournamentSnapshotData::RoundBlock &block = data->blockForRow(row);
+    const int round = data->roundIndex(row, dayNum);
+    qint8 *roundScores = reinterpret_cast<qint8 *>(block.grossScores.data()) + round * HolesPerRound;
+    std::fill_n(roundScores, HolesPerRound, qint8(0));
+    block.courseIds[round] = -1;
+    while (query.next()) {
+        int holeNum = query.value(1).toInt();
+        if (holeNum < 1 || holeNum > HolesPerRound) {
+            continue;
+        }
+        block.courseIds[round] = query.value(0).toInt();
+        roundScores[holeNum - 1] = static_cast<qint8>(std::clamp(query.value(2).toInt(), 0, 127));
+    }
+    return true;
+}
+
+TournamentSnapshot TournamentSnapshot::withScore(int playerId, int courseId, int dayNum, int holeNum, int score,
+                                                 const QString &connectionName) const
+{
+    TournamentSnapshot snapshot(*this);
+    if (dayNum < 1 || dayNum > MaxDays || holeNum < 1 || holeNum > HolesPerRound) {
+        return snapshot;
+    }
+    if (!d->hasHoleScores) {
+        qDebug() << "TournamentSnapshot::withScore: Snapshot only holds round totals, ignoring the change.";
+        return snapshot;
+    }
+
+    TournamentSnapshotData *data = snapshot.d.data();
+    if (score > 0) {
+        data->daysWithScores.insert(dayNum);
+    }
+
+    int row = snapshot.rowForPlayer(playerId);
+    if (row < 0) {
+        return snapshot;
+    }
+
+    // Only the block holding the player's rounds is copied; the others stay shared.
+    TournamentSnapshotData::RoundBlock &block = data->blockForRow(row);
+    int round = data->roundIndex(row, dayNum);
+    qint8 *roundScores = reinterpret_cast<qint8 *>(block.grossScores.data()) + round * HolesPerRound;
+    int &roundCourseId = block.courseIds[round];
+    if (roundCourseId != courseId) {
+        // The round may already hold scores on the new course, entered before the
+        // player switched away from it.
+        if (connectionName.isEmpty() || !loadRound(connectionName, data, row, dayNum)) {
+            std::fill_n(roundScores, HolesPerRound, qint8(0));
+            roundCourseId = courseId;
+            roundScores[holeNum - 1] = static_cast<qint8>(std::clamp(score, 0, 127));
+        }
+    } else {
+        roundScores[holeNum - 1] = static_cast<qint8>(std::clamp(score, 0, 127));
+    }
+    data->scoreRounds(row / TournamentSnapshotData::PlayersPerBlock, round, 1);
+    return snapshot;
+}
+
+bool TournamentSnapshot::saveArchive(const QString &filePath, const CutSettings &cut, QString *error) const
+{
+    auto fail = [error](const QString &message) {
+        qWarning() << "TournamentSnapshot::saveArchive:" << message;
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+    if (!d->valid) {
+        return fail(QStringLiteral("The snapshot was not loaded."));
+    }
+
+    QString strings;
+    for (const PlayerInfo &player : d->players) {
+        strings += player.name;
+    }
+    for (const TeamInfo &team : d->teams) {
+        strings += team.name;
+    }
+
+    const qint64 playerCount = d->players.size();
+    const ArchiveLayout layout(playerCount, d->teams.size(), d->courses.size(), strings.size());
+    QByteArray bytes(layout.size, '\0');
+    uchar *base = reinterpret_cast<uchar *>(bytes.data());
+
+    quint32 stringOffset = 0;
+    auto *playerRecords = reinterpret_cast<PlayerRecord *>(base + layout.players);
+    for (qsizetype row = 0; row < playerCount; ++row) {
+        const PlayerInfo &player = d->players.at(row);
+        PlayerRecord &record = playerRecords[row];
+        record.id = player.id;
+        record.handicap = player.handicap;
+        record.teamId = d->playerTeamIds.value(row, -1);
+        record.nameOffset = stringOffset;
+        record.nameLength = quint32(player.name.size());
+        stringOffset += record.nameLength;
+    }
+    auto *teamRecords = reinterpret_cast<TeamRecord *>(base + layout.teams);
+    for (qsizetype i = 0; i < d->teams.size(); ++i) {
+        const TeamInfo &team = d->teams.at(i);
+        TeamRecord &record = teamRecords[i];
+        record.id = team.id;
+        record.nameOffset = stringOffset;
+        record.nameLength = quint32(team.name.size());
+        stringOffset += record.nameLength;
+    }
+    auto *courseRecords = reinterpret_cast<CourseRecord *>(base + layout.courses);
+    for (qsizetype i = 0; i < d->courses.size(); ++i) {
+        const CourseHoles &course = d->courses.at(i);
+        courseRecords[i].courseId = course.courseId;
+        std::memcpy(courseRecords[i].par, course.par.data(), HolesPerRound);
+        std::memcpy(courseRecords[i].handicapIndex, course.handicapIndex.data(), HolesPerRound);
+    }
+    qsizetype firstRound = 0;
+    for (const TournamentSnapshotData::RoundBlock &block : d->roundBlocks) {
+        const qsizetype count = block.courseIds.size();
+        qToLittleEndian<qint32>(block.courseIds.constData(), count, base + layout.roundCourseIds + firstRound * 4);
+        qToLittleEndian<qint32>(block.grossPoints.constData(), count, base + layout.grossRoundPoints + firstRound * 4);
+        std::memcpy(base + layout.grossScores + firstRound * HolesPerRound, block.grossScores.constData(), count * HolesPerRound);
+        std::memcpy(base + layout.netHolePoints + firstRound * HolesPerRound, block.netHolePoints.constData(), count * HolesPerRound);
+        firstRound += count;
+    }
+    qToLittleEndian<char16_t>(strings.utf16(), strings.size(), base + layout.strings);
+
+    quint32 days = 0;
+    for (int dayNum : d->daysWithScores) {
+        if (dayNum >= 1 && dayNum <= 32) {
+            days |= 1u << (dayNum - 1);
+        }
+    }
+
+    auto *header = reinterpret_cast<SnapshotHeader *>(base);
+    std::memcpy(header->magic, archive_magic, sizeof(archive_magic));
+    header->version = archive_version;
+    header->headerSize = sizeof(SnapshotHeader);
+    header->flags = (d->hasHoleScores ? ArchiveHasHoleScores : 0) | (cut.isCutApplied ? ArchiveCutApplied : 0);
+    header->maxDays = MaxDays;
+    header->holesPerRound = HolesPerRound;
+    header->playerCount = quint32(playerCount);
+    header->teamCount = quint32(d->teams.size());
+    header->courseCount = quint32(d->courses.size());
+    header->stringLength = quint32(strings.size());
+    header->daysWithScores = days;
+    header->cutLineScore = cut.cutLineScore;
+    for (int section = 0; section < ArchiveSectionCount; ++section) {
+        header->sectionChecksums[section] = sectionChecksum(base, layout, ArchiveSection(section));
+    }
+    header->headerChecksum = headerChecksum(header);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !file.commit()) {
+        return fail(QStringLiteral("Could not write %1: %2").arg(filePath, file.errorString()));
+    }
+    return true;
+}
+
+bool TournamentSnapshot::verifyArchive(QString *error) const
+{
+    for (const TournamentSnapshotData::UncheckedSection &section : d->uncheckedSections) {
+        if (crc32(section.data, section.size) != section.checksum) {
+            const QString message = QStringLiteral("The archived hole scores are damaged.");
+            qWarning() << "TournamentSnapshot::verifyArchive:" << message;
+            if (error) {
+                *error = message;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+TournamentSnapshot TournamentSnapshot::openArchive(const QString &filePath, CutSettings *cut, QString *error)
+{
+    auto fail = [error, &filePath](const QString &message) {
+        qWarning() << "TournamentSnapshot::openArchive:" << filePath << message;
+        if (error) {
+            *error = message;
+        }
+        return TournamentSnapshot();
+    };
+
+    auto file = std::make_shared<QFile>(filePath);
+    if (!file->open(QIODevice::ReadOnly)) {
+        return fail(file->errorString());
+    }
+    const qint64 size = file->size();
+    if (size < qint64(sizeof(SnapshotHeader))) {
+        return fail(QStringLiteral("The file is not a tournament archive."));
+    }
+    const uchar *base = file->map(0, size);
+    if (!base) {
+        return fail(QStringLiteral("Could not map the file: %1").arg(file->errorString()));
+    }
+
+    const auto *header = reinterpret_cast<const SnapshotHeader *>(base);
+    if (std::memcmp(header->magic, archive_magic, sizeof(archive_magic)) != 0) {
+        return fail(QStringLiteral("The file is not a tournament archive."));
+    }
+    // Checked before the header checksum, which older versions keep elsewhere.
+    if (header->version != archive_version || header->headerSize != sizeof(SnapshotHeader)) {
+        return fail(QStringLiteral("The archive uses format version %1, which is not supported.").arg(quint32(header->version)));
+    }
+    if (header->headerChecksum != headerChecksum(header)) {
+        return fail(QStringLiteral("The archive is damaged."));
+    }
+    if (header->maxDays != quint32(MaxDays) || header->holesPerRound != quint32(HolesPerRound)) {
+        return fail(QStringLiteral("The archive uses format version %1, which is not supported.").arg(quint32(header->version)));
+    }
+    const quint32 playerCount = header->playerCount;
+    const quint32 teamCount = header->teamCount;
+    const quint32 courseCount = header->courseCount;
+    const quint32 stringLength = header->stringLength;
+    if (playerCount > archive_max_records || teamCount > archive_max_records ||
+        courseCount > archive_max_records || stringLength > archive_max_records * 64) {
+        return fail(QStringLiteral("The archive is damaged."));
+    }
+    const ArchiveLayout layout(playerCount, teamCount, courseCount, stringLength);
+    if (layout.size != size) {
+        return fail(QStringLiteral("The archive is damaged."));
+    }
+    // Everything that is copied out is checked now. The hole scores and points
+    // are used in place and make up most of the file, so they are only read
+    // when verifyArchive() is called.
+    for (ArchiveSection section : { PlayersSection, TeamsSection, CoursesSection, RoundCourseIdsSection,
+                                    GrossRoundPointsSection, StringsSection }) {
+        if (header->sectionChecksums[section] != sectionChecksum(base, layout, section)) {
+            return fail(QStringLiteral("The archive is damaged."));
+        }
+    }
+
+    TournamentSnapshot snapshot;
+    TournamentSnapshotData *data = snapshot.d.data();
+    const uchar *strings = base + layout.strings;
+    auto nameInPool = [stringLength](quint32 offset, quint32 length) {
+        return offset <= stringLength && length <= stringLength - offset;
+    };
+
+    const auto *playerRecords = reinterpret_cast<const PlayerRecord *>(base + layout.players);
+    data->players.reserve(playerCount);
+    data->playerTeamIds.reserve(playerCount);
+    for (quint32 row = 0; row < playerCount; ++row) {
+        const PlayerRecord &record = playerRecords[row];
+        if (!nameInPool(record.nameOffset, record.nameLength) || (row > 0 && record.id <= playerRecords[row - 1].id)) {
+            return fail(QStringLiteral("The archive is damaged."));
+        }
+        data->players.append({ record.id, archiveString(strings, record.nameOffset, record.nameLength), record.handicap });
+        data->playerTeamIds.append(record.teamId);
+    }
+
+    const auto *teamRecords = reinterpret_cast<const TeamRecord *>(base + layout.teams);
+    data->teams.reserve(teamCount);
+    for (quint32 i = 0; i < teamCount; ++i) {
+        const TeamRecord &record = teamRecords[i];
+        if (!nameInPool(record.nameOffset, record.nameLength)) {
+            return fail(QStringLiteral("The archive is damaged."));
+        }
+        data->teams.append({ record.id, archiveString(strings, record.nameOffset, record.nameLength) });
+    }
+
+    const auto *courseRecords = reinterpret_cast<const CourseRecord *>(base + layout.courses);
+    data->courses.resize(courseCount);
+    for (quint32 i = 0; i < courseCount; ++i) {
+        if (i > 0 && courseRecords[i].courseId <= courseRecords[i - 1].courseId) {
+            return fail(QStringLiteral("The archive is damaged."));
+        }
+        CourseHoles &course = data->courses[i];
+        course.courseId = courseRecords[i].courseId;
+        std::memcpy(course.par.data(), courseRecords[i].par, HolesPerRound);
+        std::memcpy(course.handicapIndex.data(), courseRecords[i].handicapIndex, HolesPerRound);
+    }
+
+    const qsizetype rounds = qsizetype(playerCount) * MaxDays;
+    data->roundBlocks.resize((rounds + TournamentSnapshotData::RoundsPerBlock - 1) / TournamentSnapshotData::RoundsPerBlock);
+    for (qsizetype i = 0; i < data->roundBlocks.size(); ++i) {
+        const qsizetype firstRound = i * TournamentSnapshotData::RoundsPerBlock;
+        const qsizetype count = TournamentSnapshotData::roundsInBlock(rounds, i);
+        TournamentSnapshotData::RoundBlock &block = data->roundBlocks[i];
+        block.courseIds.resize(count);
+        block.grossPoints.resize(count);
+        qFromLittleEndian<qint32>(base + layout.roundCourseIds + firstRound * 4, count, block.courseIds.data());
+        qFromLittleEndian<qint32>(base + layout.grossRoundPoints + firstRound * 4, count, block.grossPoints.data());
+        block.grossScores = QByteArray::fromRawData(reinterpret_cast<const char *>(base + layout.grossScores + firstRound * HolesPerRound),
+                                                    count * HolesPerRound);
+        block.netHolePoints = QByteArray::fromRawData(reinterpret_cast<const char *>(base + layout.netHolePoints + firstRound * HolesPerRound),
+                                                      count * HolesPerRound);
+    }
+
+    for (int dayNum = 1; dayNum <= 32; ++dayNum) {
+        if (header->daysWithScores & (1u << (dayNum - 1))) {
+            data->daysWithScores.insert(dayNum);
+        }
+    }
+    data->hasHoleScores = header->flags & ArchiveHasHoleScores;
+    for (ArchiveSection section : { GrossScoresSection, NetHolePointsSection }) {
+        data->uncheckedSections.append({ base + layout.sections[section].offset, layout.sections[section].size,
+                                         header->sectionChecksums[section] });
+    }
+    if (cut) {
+        cut->cutLineScore = header->cutLineScore;
+        cut->isCutApplied = header->flags & ArchiveCutApplied;
+    }
+
+    data->archiveFile = std::move(file);
+    data->valid = true;
+    return snapshot;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file TournamentSnapshot.h
+ * @brief Contains the declaration of the TournamentSnapshot class.
+ */
+
+#ifndef TOURNAMENTSNAPSHOT_H
+#define TOURNAMENTSNAPSHOT_H
+
+#include <QSharedDataPointer>
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include <array>
+
+#include "CommonStructs.h"
+
+/**
+ * @struct TeamInfo
+ * @brief Holds the identifier and name of a team.
+ */
+struct TeamInfo {
+    int id;         ///< The unique identifier for the team.
+    QString name;   ///< The name of the team.
+};
+
+/**
+ * @struct CourseHoles
+ * @brief Holds the par and handicap index of every hole on a course.
+ *
+ * Holes are indexed from 0 (hole 1) to 17 (hole 18). A par of 0 means the
+ * hole has no details in the database.
+ */
+struct CourseHoles {
+    int courseId;                       ///< The unique identifier for the course.
+    std::array<qint8, 18> par;          ///< The par of each hole.
+    std::array<qint8, 18> handicapIndex; ///< The handicap index of each hole.
+};
+
+class TournamentSnapshotData;
+class QSqlDatabase;
+class QSqlQuery;
+
+/**
+ * @class TournamentSnapshot
+ * @brief An immutable, implicitly shared view of the tournament data.
+ *
+ * A snapshot holds the active players, hole details and the current event's
+ * teams and scores, read from the database inside a single read transaction.
+ * Copies are cheap and share the same data, so one snapshot can feed every
+ * leaderboard model and all of them see a consistent view of the tournament.
+ *
+ * Scores are stored densely: players are addressed by row (ordered by player id)
+ * and each player has MaxDays rounds of HolesPerRound gross scores, one signed
+ * byte per hole with 0 meaning "no score". Each round also records the course it
+ * was played on. Gross round totals and net per-hole points are calculated for
+ * all rounds in batches when the snapshot is loaded. Rounds are kept in blocks
+ * of consecutive player rows that are shared separately, so withScore() copies
+ * only the block of the player whose score changed.
+ */
+class TournamentSnapshot
+{
+public:
+    static constexpr int MaxDays = 3;           ///< The number of tournament days.
+    static constexpr int HolesPerRound = 18;    ///< The number of holes in a round.
+
+    /**
+     * @enum Detail
+     * @brief How much score data load() reads.
+     */
+    enum class Detail {
+        HoleScores,     ///< Every hole score; needed for team scoring and withScore().
+        RoundTotals     ///< Only gross Stableford totals per round, read from round_summaries.
+    };
+
+    /**
+     * @struct CutSettings
+     * @brief The cut line stored with an archived snapshot.
+     */
+    struct CutSettings {
+        int cutLineScore = 0;       ///< The cut line score.
+        bool isCutApplied = false;  ///< Whether the cut is applied.
+    };
+
+    /**
+     * @brief Constructs an empty snapshot.
+     */
+    TournamentSnapshot();
+    TournamentSnapshot(const TournamentSnapshot &other);
+    TournamentSnapshot &operator=(const TournamentSnapshot &other);
+    ~TournamentSnapshot();
+
+    /**
+     * @brief Loads a snapshot from the database.
+     *
+     * When a player has scores on more than one course for a day, the round is
+     * the course entered most recently, with every score on it, at either detail.
+     *
+     * @param connectionName The name of the database connection to read from.
+     * @param detail How much score data to read.
+     * @return The loaded snapshot, or an empty snapshot if the connection is unusable.
+     */
+    static TournamentSnapshot load(const QString &connectionName, Detail detail = Detail::HoleScores);
+
+    /**
+     * @brief Opens a snapshot archived with saveArchive().
+     *
+     * The file is memory-mapped and stays mapped while any copy of the snapshot
+     * exists. The hole scores and net hole points are used in place; only the
+     * player, team and course tables and the round totals are copied out, and
+     * those are checked against their checksums here. The hole score sections
+     * are checked by verifyArchive(). No database is involved.
+     *
+     * @param filePath The archive to open.
+     * @param cut If not null, receives the cut line stored in the archive.
+     * @param error If not null, receives a description of why the archive could not be opened.
+     * @return The snapshot, or an invalid snapshot if the file is missing, damaged or of another version.
+     */
+    static TournamentSnapshot openArchive(const QString &filePath, CutSettings *cut = nullptr, QString *error = nullptr);
+
+    /**
+     * @brief Writes the snapshot to a binary archive.
+     *
+     * The archive is a versioned, little-endian, fixed-layout file holding the
+     * players, teams, course hole details and the dense score arrays, with a
+     * CRC-32 of the header and of each section.
+     *
+     * @param filePath The file to write; it is replaced atomically.
+     * @param cut The cut line to store with the snapshot.
+     * @param error If not null, receives a description of why the archive could not be written.
+     * @return True if the archive was written.
+     */
+    bool saveArchive(const QString &filePath, const CutSettings &cut, QString *error = nullptr) const;
+
+    /**
+     * @brief Checks the hole scores and net hole points of an opened archive.
+     *
+     * Reads every page of the sections openArchive() left unchecked, so it can
+     * be slow for a large archive and may run on a worker thread. Snapshots
+     * loaded from a database always pass.
+     *
+     * @param error If not null, receives a description of the damage.
+     * @return True if the sections match their checksums.
+     */
+    bool verifyArchive(QString *error = nullptr) const;
+
+    /**
+     * @brief Returns a copy of the snapshot with one hole score changed.
+     *
+     * Mirrors load(): entering a score on a different course for a day moves
+     * the player's round to that course. The round's other scores on the new
+     * course are only in the database, so the round is re-read from
+     * @p connectionName, which must already hold the score; without a
+     * connection the round restarts with only this score. The original
+     * snapshot is left untouched. Requires a snapshot loaded with
+     * Detail::HoleScores.
+     *
+     * @param playerId The unique identifier of the player.
+     * @param courseId The course the score was entered on.
+     * @param dayNum The day number (1 to MaxDays).
+     * @param holeNum The hole number (1 to HolesPerRound).
+     * @param score The gross score, or 0 to clear the hole.
+     * @param connectionName The database to re-read a round from when its course changes.
+     * @return The updated snapshot.
+     */
+    TournamentSnapshot withScore(int playerId, int courseId, int dayNum, int holeNum, int score,
+                                 const QString &connectionName = QString()) const;
+
+    /**
+     * @brief Checks whether the snapshot was loaded from an open database.
+     * @return True if the snapshot holds loaded data, false otherwise.
+     */
+    bool isValid() const;
+
+    /** @brief All active players, ordered by id. A player's index is their row. */
+    const QVector<PlayerInfo> &players() const;
+
+    /**
+     * @brief Finds the row of a player.
+     * @param playerId The unique identifier of the player.
+     * @return The player's row, or -1 if the player is not active.
+     */
+    int rowForPlayer(int playerId) const;
+
+    /**
+     * @brief Gets the team a player is assigned to.
+     * @param row The player's row.
+     * @return The team id, or -1 if the player is not on a team.
+     */
+    int teamIdForRow(int row) const;
+
+    /** @brief All teams, ordered by id. */
+    const QVector<TeamInfo> &teams() const;
+
+    /**
+     * @brief Gets the hole details of a course.
+     * @param courseId The unique identifier of the course.
+     * @return The course's holes, or nullptr if the course has no hole details.
+     */
+    const CourseHoles *courseHoles(int courseId) const;
+
+    /**
+     * @brief Checks whether the snapshot holds hole-by-hole scores.
+     *
+     * Snapshots loaded with Detail::RoundTotals only provide roundCourseId() and
+     * roundGrossPoints(); their hole scores and net hole points are all unset.
+     */
+    bool hasHoleScores() const;
+
+    /** @brief Checks whether any course has hole details. */
+    bool hasHoleDetails() const;
+
+    /**
+     * @brief Checks whether a player has at least one score recorded for a day.
+     * @param row The player's row.
+     * @param dayNum The day number (1 to MaxDays).
+     */
+    bool hasRound(int row, int dayNum) const;
+
+    /**
+     * @brief Gets the course a player's round was played on.
+     * @param row The player's row.
+     * @param dayNum The day number (1 to MaxDays).
+     * @return The course id, or -1 if the player has no scores for that day.
+     */
+    int roundCourseId(int row, int dayNum) const;
+
+    /**
+     * @brief Gets the gross scores of a player's round.
+     * @param row The player's row.
+     * @param dayNum The day number (1 to MaxDays).
+     * @return A pointer to HolesPerRound gross scores, 0 where no score was entered.
+     */
+    const qint8 *roundScores(int row, int dayNum) const;
+
+    /**
+     * @brief Gets the gross Stableford points of a player's round.
+     * @param row The player's row.
+     * @param dayNum The day number (1 to MaxDays).
+     * @return The points, or 0 if the player has no scores for that day.
+     */
+    int roundGrossPoints(int row, int dayNum) const;
+
+    /**
+     * @brief Gets the net Stableford points of each hole of a player's round.
+     * @param row The player's row.
+     * @param dayNum The day number (1 to MaxDays).
+     * @return A pointer to HolesPerRound points, StablefordKernel::NotPlayed where
+     *         the hole has no score or no hole details.
+     */
+    const qint8 *roundNetHolePoints(int row, int dayNum) const;
+
+    /** @brief The set of days that have at least one score recorded. */
+    const QSet<int> &daysWithScores() const;
+
+private:
+    QSharedDataPointer<TournamentSnapshotData> d;
+
+    static void loadRoundTotals(QSqlQuery &query, TournamentSnapshotData *data, const QHash<int, int> &rowByPlayerId);
+    static bool loadRound(const QString &connectionName, TournamentSnapshotData *data, int row, int dayNum);
+};
+
+#endif // TOURNAMENTSNAPSHOT_H
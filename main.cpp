@@ -10,7 +10,17 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <QFile>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QElapsedTimer>
 #include "MainWindow.h"
+#include "TournamentRepository.h"
+#include "DatabaseManager.h"
+#include "DatabaseBenchmark.h"
+#include "SchemaMigrator.h"
+#include "RoundSummaries.h"
+#include "BulkImporter.h"
+#include "StartupTimer.h"
 
 /**
  * @brief The main function of the application.
@@ -18,16 +28,57 @@
  * This function initializes the application, sets up the database connection,
  * creates the main window, and starts the event loop.
  *
+ * Command-line options:
+ * - --db-profile <name>: the SQLite performance profile (safe, balanced or fast).
+ * - --db-benchmark: compares the profiles on a copy of tournament.db and exits.
+ * - --rebuild-round-summaries: recalculates the round_summaries table and exits.
+ * - --import <file>: imports a players, courses, holes or scores CSV file and exits; may be repeated.
+ * - --startup-budget <ms>: the startup time to warn about exceeding.
+ * - --exit-after-startup: exits after the first paint, with status 2 if over budget.
+ *
  * @param argc The number of command-line arguments.
  * @param argv The command-line arguments.
  * @return The exit code of the application.
  */
 int main(int argc, char *argv[]) {
+    StartupTimer::start();
     QApplication app(argc, argv);
 
     QCoreApplication::setOrganizationName("Sammos");
     QCoreApplication::setApplicationName("MosleyOpen");
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption profileOption("db-profile",
+                                     QObject::tr("SQLite performance profile: %1.").arg(DatabaseManager::profileNames().join(", ")),
+                                     QObject::tr("profile"),
+                                     DatabaseManager::profileName(DatabaseManager::Profile::Balanced));
+    QCommandLineOption benchmarkOption("db-benchmark", QObject::tr("Benchmark each database profile on tournament.db and exit."));
+    QCommandLineOption budgetOption("startup-budget", QObject::tr("Startup time budget in milliseconds."),
+                                    QObject::tr("ms"), QString::number(StartupTimer::DefaultBudgetMs));
+    QCommandLineOption exitAfterStartupOption("exit-after-startup", QObject::tr("Exit after the main window is first painted."));
+    parser.addOption(profileOption);
+    parser.addOption(benchmarkOption);
+    QCommandLineOption rebuildSummariesOption("rebuild-round-summaries", QObject::tr("Recalculate the round summaries from the scores and exit."));
+    parser.addOption(rebuildSummariesOption);
+    QCommandLineOption importOption("import", QObject::tr("Import a players, courses, holes or scores CSV file and exit."), QObject::tr("file"));
+    parser.addOption(importOption);
+    parser.addOption(budgetOption);
+    parser.addOption(exitAfterStartupOption);
+    parser.process(app);
+
+    bool budgetOk = false;
+    int startupBudget = parser.value(budgetOption).toInt(&budgetOk);
+    if (!budgetOk || startupBudget <= 0) {
+        startupBudget = StartupTimer::DefaultBudgetMs;
+    }
+    StartupTimer::mark("application");
+
+    DatabaseManager::Profile profile = DatabaseManager::Profile::Balanced;
+    if (!DatabaseManager::profileFromName(parser.value(profileOption), &profile)) {
+        qWarning() << "main.cpp - Unknown database profile" << parser.value(profileOption) << ", using balanced.";
+    }
+
     QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     qDebug() << "Writable path: " << dataPath;
     QDir dataDir(dataPath);
@@ -50,78 +101,64 @@ int main(int argc, char *argv[]) {
 
     QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath());
     QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() + "/sqldrivers");
-    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
-    db.setDatabaseName(dbPath);
 
-    if (!db.open()) {
+    if (parser.isSet(benchmarkOption)) {
+        QTextStream out(stdout);
+        return DatabaseBenchmark::run(dbPath, out);
+    }
+
+    DatabaseManager::setDatabasePath(dbPath);
+    DatabaseManager::setProfile(profile);
+    QSqlDatabase db = DatabaseManager::open(QLatin1String(QSqlDatabase::defaultConnection));
+
+    if (!db.isOpen()) {
         QMessageBox::critical(nullptr, QObject::tr("Database Error"), db.lastError().text());
         qDebug() << "main.cpp - DB Open FAILED:" << db.lastError().text();
         return 1;
     }
+    StartupTimer::mark("database open");
 
-    QSqlQuery q(db);
-    q.exec(R"(
-    CREATE TABLE IF NOT EXISTS players (
-        id INTEGER PRIMARY KEY AUTOINCREMENT,
-        name TEXT NOT NULL UNIQUE,
-        handicap INTEGER NOT NULL DEFAULT 0,
-        active INTEGER NOT NULL DEFAULT 1,
-        team_id INTEGER DEFAULT NULL 
-    )
-    )");
-
-    QSqlRecord playersRecord = db.record("players");
-    if (playersRecord.indexOf("team_id") == -1) {
-        qDebug() << "main.cpp - Adding team_id column to players table.";
-        if (!q.exec("ALTER TABLE players ADD COLUMN team_id INTEGER DEFAULT NULL")) {
-            qWarning() << "main.cpp - Failed to add team_id column to players table:" << q.lastError().text();
-        }
+    QString migrationError;
+    if (!SchemaMigrator::migrate(db, &migrationError)) {
+        QMessageBox::critical(nullptr, QObject::tr("Database Error"), migrationError);
+        return 1;
     }
+    StartupTimer::mark("migrations");
 
-    q.exec(R"(
-      CREATE TABLE IF NOT EXISTS courses (
-        id INTEGER PRIMARY KEY AUTOINCREMENT,
-        name TEXT NOT NULL UNIQUE
-      )
-    )");
-    q.exec(R"(
-      CREATE TABLE IF NOT EXISTS holes (
-        id INTEGER PRIMARY KEY AUTOINCREMENT,
-        course_id INTEGER NOT NULL REFERENCES courses(id) ON DELETE CASCADE,
-        hole_num INTEGER NOT NULL,
-        par INTEGER NOT NULL,
-        handicap INTEGER NOT NULL,
-        UNIQUE(course_id, hole_num)
-      )
-    )");
-
-    q.exec(R"(
-      CREATE TABLE IF NOT EXISTS teams (
-        id INTEGER PRIMARY KEY,
-        name TEXT NOT NULL UNIQUE
-      )
-    )");
-
-    q.exec(R"(
-        CREATE TABLE IF NOT EXISTS scores (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            player_id INTEGER NOT NULL,
-            course_id INTEGER NOT NULL,
-            hole_num INTEGER NOT NULL CHECK (hole_num >= 1 AND hole_num <= 18),
-            day_num INTEGER NOT NULL CHECK (day_num >= 1 AND day_num <= 3),
-            score INTEGER,
-            UNIQUE (player_id, course_id, hole_num, day_num)
-        )
-      )");
-
-    q.exec(R"(
-        CREATE TABLE IF NOT EXISTS settings (
-            key TEXT PRIMARY KEY UNIQUE,
-            value TEXT
-        )
-      )");
+    if (parser.isSet(rebuildSummariesOption)) {
+        bool rebuilt = RoundSummaries::rebuild(db);
+        qInfo() << "main.cpp - Round summaries" << (rebuilt ? "rebuilt." : "could not be rebuilt.");
+        return rebuilt ? 0 : 1;
+    }
+
+    if (parser.isSet(importOption)) {
+        QTextStream out(stdout);
+        BulkImporter importer(db.connectionName());
+        bool imported = true;
+        for (const QString &filePath : parser.values(importOption)) {
+            QElapsedTimer timer;
+            timer.start();
+            const BulkImporter::Result result = importer.importFile(filePath);
+            out << filePath << ": " << BulkImporter::summary(result) << " (" << timer.elapsed() << " ms)" << Qt::endl;
+            imported = imported && result.isComplete();
+        }
+        TournamentRepository::releaseAll();
+        return imported ? 0 : 1;
+    }
 
     MainWindow w(db);
+    QObject::connect(&w, &MainWindow::firstPaintDone, &app, [&]() {
+        StartupTimer::mark("first paint");
+        bool withinBudget = StartupTimer::finish(startupBudget);
+        if (parser.isSet(exitAfterStartupOption)) {
+            app.exit(withinBudget ? 0 : 2);
+        }
+    });
     w.show();
-    return app.exec();
+    StartupTimer::mark("window shown");
+    int result = app.exec();
+    DatabaseManager::logStatistics(db.connectionName());
+    // Prepared statements must be finished before the connection goes away.
+    TournamentRepository::releaseAll();
+    return result;
 }
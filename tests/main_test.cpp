@@ -4,7 +4,13 @@
 // Include headers for all your test classes here
 #include "test_example.h"
 #include "test_playerdialog.h"
-// #include "test_tournamentleaderboardmodel.h"
+#include "test_stableford.h"
+#include "test_stablefordkernel.h"
+#include "test_schemamigrator.h"
+#include "test_tournamentsnapshot.h"
+#include "test_bulkimporter.h"
+#include "test_csvexportengine.h"
+#include "test_tournamentleaderboardmodel.h"
 // #include "test_teamleaderboardmodel.h"
 
 int main(int argc, char *argv[])
@@ -25,9 +31,26 @@ int main(int argc, char *argv[])
     TestPlayerDialog testPlayerDialogObj;
     status |= QTest::qExec(&testPlayerDialogObj, args);
 
-    // Example for another test class (uncomment when you create it)
-    // TestTournamentLeaderboardModel testTournamentModelObj;
-    // status |= QTest::qExec(&testTournamentModelObj, args);
+    TestStableford testStablefordObj;
+    status |= QTest::qExec(&testStablefordObj, args);
+
+    TestStablefordKernel testStablefordKernelObj;
+    status |= QTest::qExec(&testStablefordKernelObj, args);
+
+    TestSchemaMigrator testSchemaMigratorObj;
+    status |= QTest::qExec(&testSchemaMigratorObj, args);
+
+    TestTournamentSnapshot testTournamentSnapshotObj;
+    status |= QTest::qExec(&testTournamentSnapshotObj, args);
+
+    TestBulkImporter testBulkImporterObj;
+    status |= QTest::qExec(&testBulkImporterObj, args);
+
+    TestCsvExportEngine testCsvExportEngineObj;
+    status |= QTest::qExec(&testCsvExportEngineObj, args);
+
+    TestTournamentLeaderboardModel testTournamentModelObj;
+    status |= QTest::qExec(&testTournamentModelObj, args);
 
 
     qDebug() << "Finished MosleyOpen Unit Tests. Exit status:" << status;
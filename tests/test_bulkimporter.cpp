@@ -0,0 +1,94 @@
+#include "test_bulkimporter.h"
+#include "../SchemaMigrator.h"
+#include <QSqlQuery>
+#include <QBuffer>
+
+static const char *connectionName = "test_bulkimporter";
+
+void TestBulkImporter::init() {
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+    QVERIFY(SchemaMigrator::migrate(db));
+}
+
+void TestBulkImporter::cleanup() {
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+BulkImporter::Result TestBulkImporter::importText(const QByteArray &csv, int chunkSize) {
+    QByteArray data = csv;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    BulkImporter importer(connectionName);
+    importer.setChunkSize(chunkSize);
+    return importer.importCsv(&buffer);
+}
+
+void TestBulkImporter::testImport_PlayerExportRoundTrip() {
+    // The layout written by PlayerDialog::exportToCsv().
+    BulkImporter::Result result = importText("\"Name\",\"Handicap\",\"Active\"\n"
+                                             "\"Smith, Jo\",12,1\n"
+                                             "Åsa,18,0\n"
+                                             "Bad Handicap,x,1\n");
+    QCOMPARE(result.format, BulkImporter::Format::Players);
+    QVERIFY(result.isComplete());
+    QCOMPARE(result.imported, 2);
+    QCOMPARE(result.rejected, 1);
+    QVERIFY(result.errors.at(0).startsWith("Line 4:"));
+
+    QSqlQuery query(db);
+    QVERIFY(query.exec("SELECT id, handicap, active FROM players WHERE name = 'Smith, Jo'"));
+    QVERIFY(query.next());
+    const int id = query.value(0).toInt();
+    QCOMPARE(query.value(1).toInt(), 12);
+    QCOMPARE(query.value(2).toInt(), 1);
+    query.finish();
+
+    // Importing again updates the player in place, so scores keep pointing at it.
+    result = importText("Name,Handicap,Active\r\n\"Smith, Jo\",9,0\r\n");
+    QCOMPARE(result.imported, 1);
+    QVERIFY(query.exec("SELECT id, handicap, active FROM players WHERE name = 'Smith, Jo'"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), id);
+    QCOMPARE(query.value(1).toInt(), 9);
+    QCOMPARE(query.value(2).toInt(), 0);
+}
+
+void TestBulkImporter::testImport_ScoresKeepSummariesCurrent() {
+    // The course and holes files written by CoursesDialog::exportData().
+    QCOMPARE(importText("\"id\",\"Course Name\"\n7,North\n").imported, 1);
+    QCOMPARE(importText("\"course_id\",\"id\",\"hole_num\",\"par\",\"handicap\"\n7,1,1,4,1\n7,2,2,3,2\n9,3,1,4,1\n").rejected, 1);
+    QCOMPARE(importText("Name,Handicap\nAnn,10\nBen,20\n").imported, 2);
+
+    QSqlQuery query(db);
+    QVERIFY(query.exec("SELECT counter FROM change_counters WHERE table_name = 'scores'"));
+    QVERIFY(query.next());
+    const qint64 counter = query.value(0).toLongLong();
+    query.finish();
+
+    const BulkImporter::Result result = importText("player_id,course_id,day_num,hole_num,score\n"
+                                                   "1,7,1,1,5\n1,7,1,2,3\n2,7,1,1,4\n1,7,1,1,6\n2,7,4,1,4\n",
+                                                   2);
+    QCOMPARE(result.format, BulkImporter::Format::Scores);
+    QCOMPARE(result.imported, 4);
+    QCOMPARE(result.rejected, 1);
+
+    QVERIFY(query.exec("SELECT holes_played, gross_strokes FROM round_summaries WHERE player_id = 1"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 2);
+    QCOMPARE(query.value(1).toInt(), 9);
+    query.finish();
+
+    // The suspended triggers are back and the change was counted.
+    QVERIFY(query.exec("SELECT COUNT(*) FROM sqlite_master WHERE type = 'trigger' "
+                       "AND name IN ('trg_scores_insert_summary', 'trg_scores_insert_changed')"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 2);
+    query.finish();
+    QVERIFY(query.exec("SELECT counter FROM change_counters WHERE table_name = 'scores'"));
+    QVERIFY(query.next());
+    QVERIFY(query.value(0).toLongLong() > counter);
+}
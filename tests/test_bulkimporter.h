@@ -0,0 +1,26 @@
+#ifndef TEST_BULKIMPORTER_H
+#define TEST_BULKIMPORTER_H
+
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSqlDatabase>
+
+#include "../BulkImporter.h"
+
+class TestBulkImporter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testImport_PlayerExportRoundTrip();
+    void testImport_ScoresKeepSummariesCurrent();
+
+private:
+    BulkImporter::Result importText(const QByteArray &csv, int chunkSize = BulkImporter::DefaultChunkSize);
+
+    QSqlDatabase db;
+};
+
+#endif // TEST_BULKIMPORTER_H
@@ -0,0 +1,59 @@
+#include "test_csvexportengine.h"
+#include "../SchemaMigrator.h"
+#include "../BulkImporter.h"
+#include <QSqlQuery>
+#include <QFile>
+
+static const char *connectionName = "test_csvexportengine";
+
+void TestCsvExportEngine::init() {
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+    QVERIFY(SchemaMigrator::migrate(db));
+
+    QSqlQuery query(db);
+    QVERIFY(query.exec("INSERT INTO players (id, name, handicap, active) VALUES (1, 'Smith, \"Jo\"', 12, 1), (2, 'Åsa', 18, 0)"));
+    QVERIFY(query.exec("INSERT INTO events (id, name) VALUES (2, 'Older Open')"));
+    QVERIFY(query.exec("INSERT INTO scores (event_id, player_id, course_id, hole_num, day_num, score) VALUES (1, 1, 1, 1, 1, 5), (2, 1, 1, 1, 1, 7)"));
+}
+
+void TestCsvExportEngine::cleanup() {
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+void TestCsvExportEngine::testExport_EscapesAndRoundTrips() {
+    const QString playersPath = dir.filePath("Players.csv");
+    const QString scoresPath = dir.filePath("Scores.csv");
+    const CsvExportEngine::Result result = CsvExportEngine::exportNow(connectionName, {
+        { CsvExportEngine::Dataset::Players, playersPath },
+        { CsvExportEngine::Dataset::Scores, scoresPath },
+    });
+    QVERIFY(result.error.isEmpty());
+    QCOMPARE(result.writtenFiles.size(), 2);
+    QCOMPARE(result.rows, 3);
+
+    QFile players(playersPath);
+    QVERIFY(players.open(QIODevice::ReadOnly));
+    QCOMPARE(players.readAll(), QByteArray("\"Name\",\"Handicap\",\"Active\"\n"
+                                           "\"Smith, \"\"Jo\"\"\",12,1\n"
+                                           "Åsa,18,0\n"));
+
+    // Only the current event's scores are in the file.
+    QFile scores(scoresPath);
+    QVERIFY(scores.open(QIODevice::ReadOnly));
+    QCOMPARE(scores.readAll(), QByteArray("\"player_id\",\"course_id\",\"day_num\",\"hole_num\",\"score\"\n1,1,1,1,5\n"));
+
+    // The importer reads the export back without changes.
+    QSqlQuery query(db);
+    QVERIFY(query.exec("UPDATE players SET handicap = 0"));
+    BulkImporter importer(connectionName);
+    const BulkImporter::Result imported = importer.importFile(playersPath);
+    QCOMPARE(imported.imported, 2);
+    QCOMPARE(imported.rejected, 0);
+    QVERIFY(query.exec("SELECT handicap FROM players WHERE name = 'Smith, \"Jo\"'"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 12);
+}
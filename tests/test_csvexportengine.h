@@ -0,0 +1,25 @@
+#ifndef TEST_CSVEXPORTENGINE_H
+#define TEST_CSVEXPORTENGINE_H
+
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSqlDatabase>
+#include <QTemporaryDir>
+
+#include "../CsvExportEngine.h"
+
+class TestCsvExportEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testExport_EscapesAndRoundTrips();
+
+private:
+    QSqlDatabase db;
+    QTemporaryDir dir;
+};
+
+#endif // TEST_CSVEXPORTENGINE_H
@@ -0,0 +1,129 @@
+#include "test_schemamigrator.h"
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+static const char *connectionName = "test_schemamigrator";
+
+void TestSchemaMigrator::init() {
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+}
+
+void TestSchemaMigrator::cleanup() {
+    TournamentRepository::release(connectionName);
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+QStringList TestSchemaMigrator::indexNames() {
+    QStringList names;
+    QSqlQuery query("SELECT name FROM sqlite_master WHERE type = 'index' AND name LIKE 'idx_%' ORDER BY name", db);
+    while (query.next()) {
+        names << query.value(0).toString();
+    }
+    return names;
+}
+
+void TestSchemaMigrator::testMigrate_NewDatabase() {
+    QCOMPARE(SchemaMigrator::currentVersion(db), 0);
+    QVERIFY(SchemaMigrator::migrate(db));
+    QCOMPARE(SchemaMigrator::currentVersion(db), SchemaMigrator::latestVersion());
+    QCOMPARE(db.record("players").indexOf("team_id"), -1);
+    QCOMPARE(indexNames(), QStringList({ "idx_events_current", "idx_scores_event_day_course", "idx_team_members_team" }));
+    QCOMPARE(TournamentEvents::currentEventId(db), 1);
+}
+
+void TestSchemaMigrator::testMigrate_RunsOnlyOnce() {
+    QVERIFY(SchemaMigrator::migrate(db));
+    QSqlQuery query(db);
+    QVERIFY(query.exec("INSERT INTO settings (key, value) VALUES ('kept', '1')"));
+
+    QVERIFY(SchemaMigrator::migrate(db));
+    QCOMPARE(SchemaMigrator::currentVersion(db), SchemaMigrator::latestVersion());
+    QVERIFY(query.exec("SELECT value FROM settings WHERE key = 'kept'"));
+    QVERIFY(query.next());
+}
+
+void TestSchemaMigrator::testMigrate_LegacyPlayersWithoutTeamId() {
+    QSqlQuery query(db);
+    QVERIFY(query.exec("CREATE TABLE players (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL UNIQUE, "
+                       "handicap INTEGER NOT NULL DEFAULT 0, active INTEGER NOT NULL DEFAULT 1)"));
+    QVERIFY(query.exec("INSERT INTO players (name, handicap) VALUES ('Legacy', 12)"));
+
+    QVERIFY(SchemaMigrator::migrate(db));
+    QCOMPARE(db.record("players").indexOf("team_id"), -1);
+    QVERIFY(query.exec("SELECT handicap FROM players WHERE name = 'Legacy'"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 12);
+    QVERIFY(query.exec("SELECT COUNT(*) FROM team_members"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 0);
+}
+
+void TestSchemaMigrator::testMigrate_RejectsNewerSchema() {
+    QSqlQuery query(db);
+    QVERIFY(query.exec(QString("PRAGMA user_version = %1").arg(SchemaMigrator::latestVersion() + 1)));
+    QString error;
+    QVERIFY(!SchemaMigrator::migrate(db, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestSchemaMigrator::testRoundSummaries_FollowScoresAndHoles() {
+    QVERIFY(SchemaMigrator::migrate(db));
+    QSqlQuery query(db);
+    QVERIFY(query.exec("INSERT INTO holes (course_id, hole_num, par, handicap) VALUES (1, 1, 4, 1), (1, 2, 3, 2)"));
+    QVERIFY(query.exec("INSERT INTO scores (event_id, player_id, course_id, hole_num, day_num, score) VALUES (1, 7, 1, 1, 1, 3), (1, 7, 1, 2, 1, 3)"));
+
+    auto summary = [&]() {
+        QList<int> values;
+        QSqlQuery read("SELECT holes_played, gross_strokes, gross_stableford FROM round_summaries WHERE event_id = 1 AND player_id = 7 AND day_num = 1 AND course_id = 1", db);
+        if (read.next()) {
+            values << read.value(0).toInt() << read.value(1).toInt() << read.value(2).toInt();
+        }
+        return values;
+    };
+
+    // Birdie (4) plus par (2).
+    QCOMPARE(summary(), QList<int>({ 2, 6, 6 }));
+
+    QVERIFY(query.exec("UPDATE scores SET score = 5 WHERE player_id = 7 AND hole_num = 2"));
+    QCOMPARE(summary(), QList<int>({ 2, 8, 4 }));
+
+    QVERIFY(query.exec("UPDATE holes SET par = 5 WHERE course_id = 1 AND hole_num = 2"));
+    QCOMPARE(summary(), QList<int>({ 2, 8, 6 }));
+
+    QVERIFY(query.exec("DELETE FROM scores WHERE player_id = 7"));
+    QCOMPARE(summary(), QList<int>());
+
+    QVERIFY(query.exec("INSERT INTO scores (event_id, player_id, course_id, hole_num, day_num, score) VALUES (1, 7, 1, 1, 1, 4)"));
+    QVERIFY(query.exec("DELETE FROM round_summaries"));
+    QVERIFY(RoundSummaries::rebuild(db));
+    QCOMPARE(summary(), QList<int>({ 1, 4, 2 }));
+}
+
+void TestSchemaMigrator::testEvents_KeepDataApart() {
+    QVERIFY(SchemaMigrator::migrate(db));
+    TournamentRepository &repository = TournamentRepository::forConnection(connectionName);
+    QVERIFY(repository.saveScore(7, 1, 1, 1, 4));
+    QVERIFY(repository.writeSetting("cutLineScore", 30));
+
+    const int nextEvent = TournamentEvents::createEvent(db, "Next Year");
+    QVERIFY(nextEvent > 1);
+    QVERIFY(TournamentEvents::setCurrentEvent(db, nextEvent));
+    QCOMPARE(TournamentEvents::currentEventId(db), nextEvent);
+    QVERIFY(!repository.readSetting("cutLineScore").isValid());
+    QVERIFY(repository.saveScore(7, 1, 1, 1, 6));
+
+    QVERIFY(TournamentEvents::setCurrentEvent(db, 1));
+    QCOMPARE(repository.readSetting("cutLineScore").toInt(), 30);
+    QSqlQuery query("SELECT event_id, score FROM scores ORDER BY event_id", db);
+    QVERIFY(query.next());
+    QCOMPARE(query.value(1).toInt(), 4);
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), nextEvent);
+    QCOMPARE(query.value(1).toInt(), 6);
+    QVERIFY(!TournamentEvents::setCurrentEvent(db, 999));
+    QCOMPARE(TournamentEvents::currentEventId(db), 1);
+}
@@ -0,0 +1,32 @@
+#ifndef TEST_SCHEMAMIGRATOR_H
+#define TEST_SCHEMAMIGRATOR_H
+
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSqlDatabase>
+
+#include "../SchemaMigrator.h"
+#include "../RoundSummaries.h"
+#include "../TournamentEvents.h"
+#include "../TournamentRepository.h"
+
+class TestSchemaMigrator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testMigrate_NewDatabase();
+    void testMigrate_RunsOnlyOnce();
+    void testMigrate_LegacyPlayersWithoutTeamId();
+    void testMigrate_RejectsNewerSchema();
+    void testRoundSummaries_FollowScoresAndHoles();
+    void testEvents_KeepDataApart();
+
+private:
+    QSqlDatabase db;
+    QStringList indexNames();
+};
+
+#endif // TEST_SCHEMAMIGRATOR_H
@@ -0,0 +1,46 @@
+#include "test_stableford.h"
+
+static_assert(stablefordPoints(0) == 2, "Par should be worth 2 points");
+static_assert(stablefordPoints(-100) == 12, "Differences below -5 should saturate");
+static_assert(strokes_received_table[0][0] == 2, "A scratch handicap receives 2 strokes on index 1");
+
+void TestStableford::testStablefordPoints_data() {
+    QTest::addColumn<int>("diff");
+    QTest::addColumn<int>("points");
+
+    QTest::newRow("-5") << -5 << 12;
+    QTest::newRow("-4") << -4 << 10;
+    QTest::newRow("-3") << -3 << 8;
+    QTest::newRow("-2") << -2 << 6;
+    QTest::newRow("-1") << -1 << 4;
+    QTest::newRow("par") << 0 << 2;
+    QTest::newRow("+1") << 1 << 1;
+    QTest::newRow("+2") << 2 << 0;
+    QTest::newRow("+3") << 3 << -1;
+}
+
+void TestStableford::testStablefordPoints() {
+    QFETCH(int, diff);
+    QFETCH(int, points);
+    QCOMPARE(stablefordPoints(diff), points);
+}
+
+void TestStableford::testStablefordPoints_SaturatesOutsideTable() {
+    QCOMPARE(stablefordPoints(-6), 12);
+    QCOMPARE(stablefordPoints(4), -1);
+    QCOMPARE(stablefordPoints(12), -1);
+}
+
+void TestStableford::testStrokesReceivedTable_MatchesCalculation() {
+    for (int handicap = 0; handicap <= strokes_table_max_handicap; ++handicap) {
+        for (int holeHcIndex = 1; holeHcIndex <= 18; ++holeHcIndex) {
+            QCOMPARE(strokesReceived(handicap, holeHcIndex), calculateStrokesReceived(handicap, holeHcIndex));
+        }
+    }
+}
+
+void TestStableford::testStrokesReceived_OutsideTableFallsBack() {
+    QCOMPARE(strokesReceived(-2, 1), calculateStrokesReceived(-2, 1));
+    QCOMPARE(strokesReceived(60, 18), -1);
+    QCOMPARE(strokesReceived(10, 0), calculateStrokesReceived(10, 0));
+}
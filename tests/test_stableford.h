@@ -0,0 +1,21 @@
+#ifndef TEST_STABLEFORD_H
+#define TEST_STABLEFORD_H
+
+#include <QtTest/QtTest>
+#include <QObject>
+
+#include "../utils.h"
+
+class TestStableford : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testStablefordPoints_data();
+    void testStablefordPoints();
+    void testStablefordPoints_SaturatesOutsideTable();
+    void testStrokesReceivedTable_MatchesCalculation();
+    void testStrokesReceived_OutsideTableFallsBack();
+};
+
+#endif // TEST_STABLEFORD_H
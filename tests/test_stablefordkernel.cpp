@@ -0,0 +1,114 @@
+#include "test_stablefordkernel.h"
+#include "../utils.h"
+
+#include <QRandomGenerator>
+#include <QVector>
+
+using StablefordKernel::Isa;
+
+Q_DECLARE_METATYPE(StablefordKernel::Isa)
+
+void TestStablefordKernel::initTestCase() {
+    defaultIsa = StablefordKernel::activeIsa();
+    qDebug() << "TestStablefordKernel: CPU supports" << StablefordKernel::isaName(defaultIsa);
+}
+
+void TestStablefordKernel::cleanup() {
+    StablefordKernel::setIsa(defaultIsa);
+}
+
+void TestStablefordKernel::makeRounds(int roundCount, QByteArray &gross, QByteArray &par, QByteArray &strokes) {
+    QRandomGenerator rng(42);
+    const qsizetype holeCount = qsizetype(roundCount) * StablefordKernel::HolesPerRound;
+    gross.resize(holeCount);
+    par.resize(holeCount);
+    strokes.resize(holeCount);
+    for (qsizetype i = 0; i < holeCount; ++i) {
+        gross[i] = char(i % 97 == 0 ? 127 : rng.bounded(0, 16));
+        par[i] = char(rng.bounded(0, 6));
+        strokes[i] = char(rng.bounded(-1, 4));
+    }
+}
+
+void TestStablefordKernel::testScoreHoles_MatchesReference_data() {
+    QTest::addColumn<Isa>("isa");
+    QTest::addColumn<int>("roundCount");
+
+    for (Isa isa : {Isa::Scalar, Isa::Sse41, Isa::Avx2}) {
+        for (int roundCount : {1, 3, 1001}) {
+            QTest::addRow("%s/%d", StablefordKernel::isaName(isa), roundCount) << isa << roundCount;
+        }
+    }
+}
+
+void TestStablefordKernel::testScoreHoles_MatchesReference() {
+    QFETCH(Isa, isa);
+    QFETCH(int, roundCount);
+    if (!StablefordKernel::setIsa(isa)) {
+        QSKIP("Instruction set not supported by this CPU");
+    }
+
+    QByteArray gross, par, strokes;
+    makeRounds(roundCount, gross, par, strokes);
+    const qsizetype holeCount = gross.size();
+
+    QByteArray points(holeCount, Qt::Uninitialized);
+    QVector<int> totals(roundCount);
+    StablefordKernel::scoreHoles(reinterpret_cast<const qint8 *>(gross.constData()), reinterpret_cast<const qint8 *>(par.constData()),
+                                 reinterpret_cast<const qint8 *>(strokes.constData()), holeCount, reinterpret_cast<qint8 *>(points.data()));
+    StablefordKernel::sumRounds(reinterpret_cast<const qint8 *>(points.constData()), roundCount, totals.data());
+
+    for (int round = 0; round < roundCount; ++round) {
+        int expectedTotal = 0;
+        for (int hole = 0; hole < StablefordKernel::HolesPerRound; ++hole) {
+            const qsizetype i = qsizetype(round) * StablefordKernel::HolesPerRound + hole;
+            int expected = StablefordKernel::NotPlayed;
+            if (gross[i] > 0 && par[i] > 0) {
+                expected = stablefordPoints(gross[i] - strokes[i] - par[i]);
+                expectedTotal += expected;
+            }
+            QCOMPARE(int(qint8(points[i])), expected);
+        }
+        QCOMPARE(totals[round], expectedTotal);
+    }
+}
+
+void TestStablefordKernel::testSumRounds_SkipsUnplayedHoles() {
+    QByteArray points(StablefordKernel::HolesPerRound, char(StablefordKernel::NotPlayed));
+    points[0] = char(-1);
+    points[15] = char(12);
+    points[17] = char(2);
+    int total = 0;
+    StablefordKernel::sumRounds(reinterpret_cast<const qint8 *>(points.constData()), 1, &total);
+    QCOMPARE(total, 13);
+}
+
+void TestStablefordKernel::benchmarkScoreRounds_data() {
+    QTest::addColumn<Isa>("isa");
+    QTest::addColumn<int>("roundCount");
+
+    for (int roundCount : {1000, 10000, 100000}) {
+        for (Isa isa : {Isa::Scalar, Isa::Sse41, Isa::Avx2}) {
+            QTest::addRow("%s/%d rounds", StablefordKernel::isaName(isa), roundCount) << isa << roundCount;
+        }
+    }
+}
+
+void TestStablefordKernel::benchmarkScoreRounds() {
+    QFETCH(Isa, isa);
+    QFETCH(int, roundCount);
+    if (!StablefordKernel::setIsa(isa)) {
+        QSKIP("Instruction set not supported by this CPU");
+    }
+
+    QByteArray gross, par, strokes;
+    makeRounds(roundCount, gross, par, strokes);
+    QByteArray points(gross.size(), Qt::Uninitialized);
+    QVector<int> totals(roundCount);
+
+    QBENCHMARK {
+        StablefordKernel::scoreHoles(reinterpret_cast<const qint8 *>(gross.constData()), reinterpret_cast<const qint8 *>(par.constData()),
+                                     reinterpret_cast<const qint8 *>(strokes.constData()), gross.size(), reinterpret_cast<qint8 *>(points.data()));
+        StablefordKernel::sumRounds(reinterpret_cast<const qint8 *>(points.constData()), roundCount, totals.data());
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef TEST_STABLEFORDKERNEL_H
+#define TEST_STABLEFORDKERNEL_H
+
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QByteArray>
+
+#include "../StablefordKernel.h"
+
+class TestStablefordKernel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void testScoreHoles_MatchesReference_data();
+    void testScoreHoles_MatchesReference();
+    void testSumRounds_SkipsUnplayedHoles();
+
+    // Microbenchmarks; run with e.g. -iterations 10 to compare implementations.
+    void benchmarkScoreRounds_data();
+    void benchmarkScoreRounds();
+
+private:
+    StablefordKernel::Isa defaultIsa;
+
+    // Random rounds: gross 0-15 with a few extremes, par 0-5, strokes -1 to 3.
+    void makeRounds(int roundCount, QByteArray &gross, QByteArray &par, QByteArray &strokes);
+};
+
+#endif // TEST_STABLEFORDKERNEL_H
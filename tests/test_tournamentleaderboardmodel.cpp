@@ -0,0 +1,81 @@
+#include "test_tournamentleaderboardmodel.h"
+#include "../SchemaMigrator.h"
+#include <QSqlQuery>
+
+static const char *connectionName = "test_tournamentleaderboardmodel";
+
+// Every player has handicap 16, so a Mosley Open total equals the two-day cut score.
+enum PlayerId { Ann = 1, Bea = 2, Bob = 3, Cal = 4, Dan = 5 };
+
+void TestTournamentLeaderboardModel::init() {
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+    QVERIFY(SchemaMigrator::migrate(db));
+
+    QSqlQuery query(db);
+    QVERIFY(query.exec("INSERT INTO players (id, name, handicap, active) VALUES "
+                       "(1, 'Ann', 16, 1), (2, 'Bea', 16, 1), (3, 'Bob', 16, 1), (4, 'Cal', 16, 1), (5, 'Dan', 16, 1)"));
+    QVERIFY(query.exec("INSERT INTO holes (course_id, hole_num, par, handicap) VALUES (1, 1, 4, 1)"));
+    // Bob starts with a blow-up hole that misses the cut.
+    QVERIFY(query.exec("INSERT INTO scores (event_id, player_id, course_id, hole_num, day_num, score) VALUES "
+                       "(1, 1, 1, 1, 1, 3), (1, 2, 1, 1, 1, 4), (1, 3, 1, 1, 1, 15), (1, 4, 1, 1, 1, 4), (1, 5, 1, 1, 1, 5)"));
+}
+
+void TestTournamentLeaderboardModel::cleanup() {
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+/**
+ * @brief Checks that the incrementally updated model matches a full recalculation.
+ */
+void TestTournamentLeaderboardModel::compareWithRecalculation(TournamentLeaderboardModel &model, const TournamentSnapshot &snapshot, int cutLine) {
+    TournamentLeaderboardModel expected(connectionName);
+    expected.setTournamentContext(TournamentLeaderboardModel::MosleyOpen);
+    expected.setCutLineScore(cutLine);
+    expected.setIsCutApplied(true);
+    expected.refreshData(snapshot);
+
+    QCOMPARE(model.rowCount(), expected.rowCount());
+    for (int row = 0; row < expected.rowCount(); ++row) {
+        QCOMPARE(model.data(model.index(row, 1)), expected.data(expected.index(row, 1)));
+        QCOMPARE(model.data(model.index(row, 0)), expected.data(expected.index(row, 0)));
+    }
+}
+
+void TestTournamentLeaderboardModel::testApplyScoreChange_TiedInsertAndRemove() {
+    TournamentSnapshot snapshot = TournamentSnapshot::load(connectionName);
+    QVERIFY(snapshot.isValid());
+    const int danPoints = snapshot.roundGrossPoints(snapshot.rowForPlayer(Dan), 1);
+    QVERIFY(snapshot.roundGrossPoints(snapshot.rowForPlayer(Bea), 1) > danPoints);
+    QVERIFY(snapshot.roundGrossPoints(snapshot.rowForPlayer(Bob), 1) < danPoints);
+
+    // Dan is the last player to make the cut.
+    const int cutLine = danPoints - 16;
+    TournamentLeaderboardModel model(connectionName);
+    model.setTournamentContext(TournamentLeaderboardModel::MosleyOpen);
+    model.setCutLineScore(cutLine);
+    model.setIsCutApplied(true);
+    model.refreshData(snapshot);
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(model.data(model.index(3, 0)), QVariant(4));
+
+    // Bob makes the cut and ties Bea and Cal, between them by name: Dan falls from 4th to 5th.
+    snapshot = snapshot.withScore(Bob, 1, 1, 1, 4);
+    model.applyScoreChange(snapshot, Bob);
+    QCOMPARE(model.rowCount(), 5);
+    QCOMPARE(model.data(model.index(2, 1)), QVariant(QString("Bob")));
+    QCOMPARE(model.data(model.index(3, 0)), QVariant(2));
+    QCOMPARE(model.data(model.index(4, 0)), QVariant(5));
+    compareWithRecalculation(model, snapshot, cutLine);
+
+    // Bea misses the cut ahead of the remaining tie: Dan moves back up to 4th.
+    snapshot = snapshot.withScore(Bea, 1, 1, 1, 15);
+    model.applyScoreChange(snapshot, Bea);
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(model.data(model.index(1, 0)), QVariant(2));
+    QCOMPARE(model.data(model.index(3, 0)), QVariant(4));
+    compareWithRecalculation(model, snapshot, cutLine);
+}
@@ -0,0 +1,25 @@
+#ifndef TEST_TOURNAMENTLEADERBOARDMODEL_H
+#define TEST_TOURNAMENTLEADERBOARDMODEL_H
+
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSqlDatabase>
+
+#include "../TournamentLeaderboardModel.h"
+
+class TestTournamentLeaderboardModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testApplyScoreChange_TiedInsertAndRemove();
+
+private:
+    void compareWithRecalculation(TournamentLeaderboardModel &model, const TournamentSnapshot &snapshot, int cutLine);
+
+    QSqlDatabase db;
+};
+
+#endif // TEST_TOURNAMENTLEADERBOARDMODEL_H
@@ -0,0 +1,193 @@
+#include "test_tournamentsnapshot.h"
+#include "../SchemaMigrator.h"
+#include <QSqlQuery>
+#include <QFile>
+
+static const char *connectionName = "test_tournamentsnapshot";
+
+void TestTournamentSnapshot::init() {
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+    QVERIFY(SchemaMigrator::migrate(db));
+
+    QSqlQuery query(db);
+    QVERIFY(query.exec("INSERT INTO teams (event_id, id, name) VALUES (1, 1, 'Eagles')"));
+    QVERIFY(query.exec("INSERT INTO players (id, name, handicap, active) VALUES (3, 'Åsa', 18, 1), (5, 'Bob', 0, 1)"));
+    QVERIFY(query.exec("INSERT INTO team_members (event_id, player_id, team_id) VALUES (1, 3, 1)"));
+    QVERIFY(query.exec("INSERT INTO holes (course_id, hole_num, par, handicap) VALUES (1, 1, 4, 1), (1, 2, 3, 2)"));
+    QVERIFY(query.exec("INSERT INTO scores (event_id, player_id, course_id, hole_num, day_num, score) VALUES (1, 3, 1, 1, 1, 5), (1, 3, 1, 2, 1, 3), (1, 5, 1, 1, 2, 4)"));
+}
+
+void TestTournamentSnapshot::cleanup() {
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+void TestTournamentSnapshot::testArchive_RoundTrip() {
+    TournamentSnapshot loaded = TournamentSnapshot::load(connectionName);
+    QVERIFY(loaded.isValid());
+    const QString path = dir.filePath("roundtrip.mosnap");
+    QVERIFY(loaded.saveArchive(path, { 7, true }));
+
+    TournamentSnapshot::CutSettings cut;
+    TournamentSnapshot archive = TournamentSnapshot::openArchive(path, &cut);
+    QVERIFY(archive.isValid());
+    QCOMPARE(cut.cutLineScore, 7);
+    QVERIFY(cut.isCutApplied);
+
+    QCOMPARE(archive.players().size(), 2);
+    QCOMPARE(archive.players().at(0).name, QString("Åsa"));
+    QCOMPARE(archive.players().at(0).handicap, 18);
+    QCOMPARE(archive.rowForPlayer(5), 1);
+    QCOMPARE(archive.teamIdForRow(0), 1);
+    QCOMPARE(archive.teamIdForRow(1), -1);
+    QCOMPARE(archive.teams().at(0).name, QString("Eagles"));
+    QVERIFY(archive.courseHoles(1));
+    QCOMPARE(archive.courseHoles(1)->par[1], qint8(3));
+    QCOMPARE(archive.daysWithScores(), loaded.daysWithScores());
+    QVERIFY(archive.hasHoleScores());
+
+    for (int row = 0; row < 2; ++row) {
+        for (int dayNum = 1; dayNum <= TournamentSnapshot::MaxDays; ++dayNum) {
+            QCOMPARE(archive.roundCourseId(row, dayNum), loaded.roundCourseId(row, dayNum));
+            QCOMPARE(archive.roundGrossPoints(row, dayNum), loaded.roundGrossPoints(row, dayNum));
+            QVERIFY(std::equal(archive.roundScores(row, dayNum), archive.roundScores(row, dayNum) + TournamentSnapshot::HolesPerRound,
+                               loaded.roundScores(row, dayNum)));
+            QVERIFY(std::equal(archive.roundNetHolePoints(row, dayNum), archive.roundNetHolePoints(row, dayNum) + TournamentSnapshot::HolesPerRound,
+                               loaded.roundNetHolePoints(row, dayNum)));
+        }
+    }
+
+    // Changing a mapped snapshot copies its scores instead of writing to the file.
+    TournamentSnapshot changed = archive.withScore(5, 1, 2, 2, 3);
+    QCOMPARE(changed.roundScores(1, 2)[1], qint8(3));
+    QCOMPARE(archive.roundScores(1, 2)[1], qint8(0));
+}
+
+void TestTournamentSnapshot::testArchive_RejectsDamagedFile() {
+    const QString path = dir.filePath("damaged.mosnap");
+    QVERIFY(TournamentSnapshot::load(connectionName).saveArchive(path, {}));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.seek(file.size() - 1));
+    QVERIFY(file.putChar('\x7f'));
+    file.close();
+
+    QString error;
+    QVERIFY(!TournamentSnapshot::openArchive(path, nullptr, &error).isValid());
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!TournamentSnapshot::openArchive(dir.filePath("missing.mosnap")).isValid());
+}
+
+void TestTournamentSnapshot::testArchive_VerifiesHoleScoresOnRequest() {
+    const QString path = dir.filePath("holes.mosnap");
+    QVERIFY(TournamentSnapshot::load(connectionName).saveArchive(path, {}));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    // Åsa's day 1 gross scores: 5 and 3, then 16 unplayed holes.
+    const qint64 scoresOffset = file.readAll().indexOf(QByteArray("\x05\x03") + QByteArray(16, '\0'));
+    QVERIFY(scoresOffset > 0);
+    QVERIFY(file.seek(scoresOffset));
+    QVERIFY(file.putChar('\x06'));
+    file.close();
+
+    // The damage is in a section openArchive() uses in place without reading.
+    TournamentSnapshot archive = TournamentSnapshot::openArchive(path);
+    QVERIFY(archive.isValid());
+    QString error;
+    QVERIFY(!archive.verifyArchive(&error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(TournamentSnapshot::load(connectionName).verifyArchive());
+}
+
+void TestTournamentSnapshot::testLoad_InterleavedCoursesKeepLatestCourse() {
+    QSqlQuery query(db);
+    QVERIFY(query.exec("INSERT INTO holes (course_id, hole_num, par, handicap) VALUES (2, 1, 5, 1)"));
+    // Bob's day 3 is entered on course 1, then course 2, then course 1 again.
+    QVERIFY(query.exec("INSERT INTO scores (event_id, player_id, course_id, hole_num, day_num, score) VALUES (1, 5, 1, 1, 3, 4)"));
+    QVERIFY(query.exec("INSERT INTO scores (event_id, player_id, course_id, hole_num, day_num, score) VALUES (1, 5, 2, 1, 3, 6)"));
+    QVERIFY(query.exec("INSERT INTO scores (event_id, player_id, course_id, hole_num, day_num, score) VALUES (1, 5, 1, 2, 3, 3)"));
+
+    TournamentSnapshot holeScores = TournamentSnapshot::load(connectionName);
+    TournamentSnapshot roundTotals = TournamentSnapshot::load(connectionName, TournamentSnapshot::Detail::RoundTotals);
+    const int row = holeScores.rowForPlayer(5);
+    QCOMPARE(holeScores.roundCourseId(row, 3), 1);
+    QCOMPARE(holeScores.roundScores(row, 3)[0], qint8(4));
+    QCOMPARE(holeScores.roundScores(row, 3)[1], qint8(3));
+    QCOMPARE(roundTotals.roundCourseId(row, 3), 1);
+    QCOMPARE(roundTotals.roundGrossPoints(row, 3), holeScores.roundGrossPoints(row, 3));
+}
+
+void TestTournamentSnapshot::testWithScore_InterleavedCoursesMatchLoad() {
+    QSqlQuery query(db);
+    QVERIFY(query.exec("INSERT INTO holes (course_id, hole_num, par, handicap) VALUES (2, 1, 5, 1)"));
+    TournamentSnapshot snapshot = TournamentSnapshot::load(connectionName);
+    const int row = snapshot.rowForPlayer(3);
+
+    // Åsa's day 1 holds two holes on course 1; one hole is entered on course 2,
+    // then another on course 1. Each score is saved before withScore() sees it.
+    const struct { int courseId; int holeNum; int score; } entries[] = { { 2, 1, 6 }, { 1, 3, 4 } };
+    for (const auto &entry : entries) {
+        query.prepare("INSERT OR REPLACE INTO scores (event_id, player_id, course_id, hole_num, day_num, score) VALUES (1, 3, ?, ?, 1, ?)");
+        query.addBindValue(entry.courseId);
+        query.addBindValue(entry.holeNum);
+        query.addBindValue(entry.score);
+        QVERIFY(query.exec());
+        snapshot = snapshot.withScore(3, entry.courseId, 1, entry.holeNum, entry.score, connectionName);
+
+        TournamentSnapshot loaded = TournamentSnapshot::load(connectionName);
+        QCOMPARE(snapshot.roundCourseId(row, 1), entry.courseId);
+        QCOMPARE(snapshot.roundCourseId(row, 1), loaded.roundCourseId(row, 1));
+        QCOMPARE(snapshot.roundGrossPoints(row, 1), loaded.roundGrossPoints(row, 1));
+        QVERIFY(std::equal(snapshot.roundScores(row, 1), snapshot.roundScores(row, 1) + TournamentSnapshot::HolesPerRound,
+                           loaded.roundScores(row, 1)));
+        QVERIFY(std::equal(snapshot.roundNetHolePoints(row, 1), snapshot.roundNetHolePoints(row, 1) + TournamentSnapshot::HolesPerRound,
+                           loaded.roundNetHolePoints(row, 1)));
+    }
+    QCOMPARE(snapshot.roundScores(row, 1)[0], qint8(5));
+    QCOMPARE(snapshot.roundScores(row, 1)[2], qint8(4));
+}
+
+void TestTournamentSnapshot::testWithScore_ManyPlayersMatchLoadAndArchive() {
+    QSqlQuery query(db);
+    QVERIFY(db.transaction());
+    query.prepare("INSERT INTO players (id, name, handicap, active) VALUES (?, ?, ?, 1)");
+    for (int id = 100; id < 300; ++id) {
+        query.addBindValue(id);
+        query.addBindValue(QString("Player %1").arg(id));
+        query.addBindValue(id % 28);
+        QVERIFY(query.exec());
+    }
+    QVERIFY(db.commit());
+
+    TournamentSnapshot snapshot = TournamentSnapshot::load(connectionName);
+    const TournamentSnapshot original = snapshot;
+    const int changedIds[] = { 163, 164, 299 };
+    for (int playerId : changedIds) {
+        QVERIFY(query.exec(QString("INSERT INTO scores (event_id, player_id, course_id, hole_num, day_num, score) "
+                                   "VALUES (1, %1, 1, 2, 3, 4)").arg(playerId)));
+        snapshot = snapshot.withScore(playerId, 1, 3, 2, 4, connectionName);
+    }
+
+    const QString path = dir.filePath("many.mosnap");
+    QVERIFY(snapshot.saveArchive(path, {}));
+    const TournamentSnapshot loaded = TournamentSnapshot::load(connectionName);
+    const TournamentSnapshot archive = TournamentSnapshot::openArchive(path);
+    QVERIFY(archive.isValid());
+    for (const TournamentSnapshot &other : { loaded, archive }) {
+        for (int row = 0; row < loaded.players().size(); ++row) {
+            for (int dayNum = 1; dayNum <= TournamentSnapshot::MaxDays; ++dayNum) {
+                QCOMPARE(snapshot.roundCourseId(row, dayNum), other.roundCourseId(row, dayNum));
+                QCOMPARE(snapshot.roundGrossPoints(row, dayNum), other.roundGrossPoints(row, dayNum));
+                QVERIFY(std::equal(snapshot.roundNetHolePoints(row, dayNum), snapshot.roundNetHolePoints(row, dayNum) + TournamentSnapshot::HolesPerRound,
+                                   other.roundNetHolePoints(row, dayNum)));
+            }
+        }
+    }
+    QCOMPARE(snapshot.roundScores(snapshot.rowForPlayer(299), 3)[1], qint8(4));
+    QVERIFY(!original.hasRound(original.rowForPlayer(299), 3));
+}
@@ -0,0 +1,30 @@
+#ifndef TEST_TOURNAMENTSNAPSHOT_H
+#define TEST_TOURNAMENTSNAPSHOT_H
+
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSqlDatabase>
+#include <QTemporaryDir>
+
+#include "../TournamentSnapshot.h"
+
+class TestTournamentSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testArchive_RoundTrip();
+    void testArchive_RejectsDamagedFile();
+    void testArchive_VerifiesHoleScoresOnRequest();
+    void testLoad_InterleavedCoursesKeepLatestCourse();
+    void testWithScore_InterleavedCoursesMatchLoad();
+    void testWithScore_ManyPlayersMatchLoadAndArchive();
+
+private:
+    QSqlDatabase db;
+    QTemporaryDir dir;
+};
+
+#endif // TEST_TOURNAMENTSNAPSHOT_H
@@ -5,22 +5,112 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 
 /**
- * @brief A map for converting score differences from par to Stableford points.
+ * @brief The lowest score difference from par that earns distinct Stableford points.
  *
- * The key is the difference from par (e.g., -1 for a birdie), and the value is
- * the corresponding number of Stableford points.
+ * Anything better than this scores the same as this difference.
  */
-const std::unordered_map<int, int> stableford_conversion = {
-    {-5, 12},
-    {-4, 10},
-    {-3, 8},
-    {-2, 6},
-    {-1, 4},
-    {0, 2},
-    {1, 1},
-    {2, 0},
-    {3, -1}
-};
\ No newline at end of file
+constexpr int stableford_min_diff = -5;
+
+/**
+ * @brief The highest score difference from par that earns distinct Stableford points.
+ *
+ * Anything worse than this scores the same as this difference.
+ */
+constexpr int stableford_max_diff = 3;
+
+/**
+ * @brief Stableford points indexed by the score difference from par minus stableford_min_diff.
+ *
+ * Index 0 is a difference of -5 and index 8 is a difference of +3 (e.g. index 4 is a
+ * birdie worth 4 points).
+ */
+constexpr std::array<int, stableford_max_diff - stableford_min_diff + 1> stableford_points_table = {
+    12, // -5
+    10, // -4
+    8,  // -3
+    6,  // -2
+    4,  // -1
+    2,  //  0
+    1,  // +1
+    0,  // +2
+    -1  // +3
+};
+
+/**
+ * @brief Converts a score difference from par to Stableford points.
+ *
+ * Differences outside the table saturate to the nearest edge, so the lookup
+ * never fails.
+ *
+ * @param diff The score minus par for the hole.
+ * @return The Stableford points for the hole.
+ */
+constexpr int stablefordPoints(int diff) {
+    return stableford_points_table[std::clamp(diff, stableford_min_diff, stableford_max_diff) - stableford_min_diff];
+}
+
+/**
+ * @brief Calculates the number of strokes a player receives on a hole.
+ * @param handicapForCalc The player's handicap.
+ * @param holeHcIndex The handicap index of the hole.
+ * @return The number of strokes received.
+ */
+constexpr int calculateStrokesReceived(int handicapForCalc, int holeHcIndex) {
+    if (handicapForCalc <= 36) {
+        int effective = 36 - handicapForCalc;
+        int strokes = 0;
+        if (effective >= holeHcIndex) strokes++;
+        if (effective >= (18 + holeHcIndex)) strokes++;
+        if (effective >= (36 + holeHcIndex)) strokes++;
+        return strokes;
+    } else {
+        int toGiveBack = (handicapForCalc - 36) / 2;
+        if (holeHcIndex > (18 - toGiveBack)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief The highest handicap covered by strokes_received_table.
+ */
+constexpr int strokes_table_max_handicap = 54;
+
+/**
+ * @brief Strokes received, precomputed for handicaps 0 to 54 and hole indexes 1 to 18.
+ *
+ * Indexed as strokes_received_table[handicap][holeHcIndex - 1].
+ */
+constexpr auto strokes_received_table = [] {
+    std::array<std::array<std::int8_t, 18>, strokes_table_max_handicap + 1> table{};
+    for (int handicap = 0; handicap <= strokes_table_max_handicap; ++handicap) {
+        for (int holeHcIndex = 1; holeHcIndex <= 18; ++holeHcIndex) {
+            table[handicap][holeHcIndex - 1] = static_cast<std::int8_t>(calculateStrokesReceived(handicap, holeHcIndex));
+        }
+    }
+    return table;
+}();
+
+/**
+ * @brief Looks up the number of strokes a player receives on a hole.
+ *
+ * Uses strokes_received_table for the common range and falls back to
+ * calculateStrokesReceived() for anything outside it.
+ *
+ * @param handicapForCalc The player's handicap.
+ * @param holeHcIndex The handicap index of the hole.
+ * @return The number of strokes received.
+ */
+constexpr int strokesReceived(int handicapForCalc, int holeHcIndex) {
+    if (static_cast<unsigned>(handicapForCalc) <= strokes_table_max_handicap &&
+        static_cast<unsigned>(holeHcIndex - 1) < 18) {
+        return strokes_received_table[handicapForCalc][holeHcIndex - 1];
+    }
+    return calculateStrokesReceived(handicapForCalc, holeHcIndex);
+}